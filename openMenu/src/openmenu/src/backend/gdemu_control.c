@@ -8,6 +8,7 @@
 #include "backend/controls.p1.h"
 #include "backend/gdemu_sdk.h"
 #include "backend/gdmenu_binary.h"
+#include "texture/txr_stream.h"
 #include "vm2/vm2_api.h"
 
 extern maple_device_t* vm2_dev;
@@ -51,6 +52,8 @@ bloom_launch(gd_item* disc) {
     fs_read(fd, bloom_buf, bloom_size);
     fs_close(fd);
 
+    /* No DAT reads once the image changes */
+    txr_stream_shutdown();
     gdemu_set_img_num((uint16_t)disc->slot_num);
 
     wait_cd_ready(disc);
@@ -82,6 +85,8 @@ bleem_launch(gd_item* disc) {
     fs_read(fd, bleem_buf, bleem_size);
     fs_close(fd);
 
+    /* No DAT reads once the image changes */
+    txr_stream_shutdown();
     gdemu_set_img_num((uint16_t)disc->slot_num);
 
     wait_cd_ready(disc);
@@ -121,6 +126,8 @@ dreamcast_launch_disc(gd_item* disc) {
         }
     }
 
+    /* No DAT reads once the image changes */
+    txr_stream_shutdown();
     gdemu_set_img_num((uint16_t)disc->slot_num);
     // thd_sleep(500);
 
@@ -210,6 +217,8 @@ dreamcast_launch_cb(gd_item* disc) {
         fs_close(fd);
     }
 
+    /* No DAT reads once the image changes */
+    txr_stream_shutdown();
     gdemu_set_img_num((uint16_t)disc->slot_num);
     // thd_sleep(500);
 
@@ -29,6 +29,7 @@
 #include "ui/draw_prototypes.h"
 #include "ui/ui_common.h"
 #include "ui/ui_menu_credits.h"
+#include "ui/ui_stats_overlay.h"
 #include "vm2/vm2_api.h"
 
 /* UI Collection */
@@ -43,6 +44,9 @@
 
 #include "bloader.h"
 #include "texture/txr_manager.h"
+#include "texture/simple_texture_allocator.h"
+#include "texture/txr_stream.h"
+#include "texture/vram_heap.h"
 
 maple_device_t* vm2_dev = NULL;
 
@@ -88,9 +92,21 @@ ui_set_choice(int choice) {
     current_ui_draw_TR = ui_choices[choice].drawTR;
     current_ui_handle_input = ui_choices[choice].handle_input;
 
+    /* Drop all art first so the heap coalesces before the theme loads what changed */
+    txr_empty_small_pool();
+    txr_empty_large_pool();
+
     /* Call init & setup */
     (*current_ui_init)();
     (*current_ui_setup)();
+
+    /* Theme textures the new UI didn't ask for again stay cached within a
+     * budget for the next switch, art gets the rest and can take them back */
+    texman_trim_cache();
+    txr_apply_working_set();
+#if DEBUG
+    vram_print_stats();
+#endif
 }
 
 void
@@ -105,6 +121,7 @@ init() {
     /* Load settings */
     savefile_init();
 
+    ret += txr_create_heap();
     ret += txr_create_small_pool();
     ret += txr_create_large_pool();
     ret += txr_load_DATs();
@@ -142,6 +159,11 @@ init() {
 static void
 draw(void) {
     pvr_wait_ready();
+
+    /* Previous frame is done with vram, land any streamed textures */
+    txr_stream_commit();
+
+    draw_begin_frame();
     pvr_scene_begin();
 
     draw_set_list(PVR_LIST_OP_POLY);
@@ -149,13 +171,16 @@ draw(void) {
 
     (*current_ui_draw_OP)();
 
+    draw_flush();
     pvr_list_finish();
 
     draw_set_list(PVR_LIST_TR_POLY);
     pvr_list_begin(PVR_LIST_TR_POLY);
 
     (*current_ui_draw_TR)();
+    stats_overlay_draw_tr();
 
+    draw_flush();
     pvr_list_finish();
 
     pvr_scene_finish();
@@ -226,6 +251,9 @@ processInput(void) {
 static int
 translate_input(void) {
     processInput();
+    if (stats_overlay_handle_input()) {
+        return NONE;
+    }
     if (INPT_DPADDirection(DPAD_LEFT)) {
         return LEFT;
     }
@@ -407,6 +435,7 @@ main(int argc, char* argv[]) {
         }
     }
 
+    txr_print_stats();
     savefile_close();
     return 0;
 }
@@ -431,5 +460,7 @@ exit_to_bios(void) {
         }
     }
 
+    txr_print_stats();
+    txr_stream_shutdown();
     arch_exec_at(bloader_data, bloader_size, 0xacf00000);
 }
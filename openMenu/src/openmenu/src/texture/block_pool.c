@@ -13,38 +13,81 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "icon_atlas.h"
+#include "palette_bank.h"
+#include "vram_heap.h"
+
 #include "block_pool.h"
 
 static inline void
 _pool_mark_used(block_pool* pool, unsigned int slot_num) {
-    pool->state[slot_num] = 1;
+    pool->state[slot_num] = POOL_SLOT_USED;
+}
+
+static inline void
+_pool_release_texture(block_pool* pool, unsigned int slot_num) {
+    if (pool->cell[slot_num] != ATLAS_CELL_NONE) {
+        icon_atlas_free(pool->cell[slot_num]);
+        pool->cell[slot_num] = ATLAS_CELL_NONE;
+    } else {
+        vram_free(pool->addr[slot_num]);
+    }
+    pool->addr[slot_num] = NULL;
 }
 
 static inline void
 _pool_mark_open(block_pool* pool, unsigned int slot_num) {
-    pool->state[slot_num] = 0;
+    pool->state[slot_num] = POOL_SLOT_OPEN;
+    pool->generation[slot_num]++;
+    _pool_release_texture(pool, slot_num);
+    palette_bank_release(pool->palette[slot_num]);
+    pool->palette[slot_num] = PALETTE_NONE;
 }
 
 void
-pool_create(block_pool* pool, void* buffer, unsigned int size, unsigned int slots) {
+pool_create(block_pool* pool, int client, unsigned int slots) {
     const unsigned int state_size = sizeof(unsigned char) * slots;
+    const unsigned int generation_size = sizeof(uint16_t) * slots;
     const unsigned int format_size = sizeof(slot_format) * slots;
 
-    pool->base = buffer;
-    pool->size = size;
     pool->slots = slots;
-    pool->slot_size = size / slots;
+    pool->client = client;
+    pool->addr = calloc(slots, sizeof(void*));
+    if (!pool->addr) {
+        printf("%s no free memory\n", __func__);
+        return;
+    }
     pool->state = malloc(state_size);
     if (!pool->state) {
         printf("%s no free memory\n", __func__);
         return;
     }
+    pool->generation = malloc(generation_size);
+    if (!pool->generation) {
+        printf("%s no free memory\n", __func__);
+        return;
+    }
+    pool->palette = malloc(sizeof(int16_t) * slots);
+    if (!pool->palette) {
+        printf("%s no free memory\n", __func__);
+        return;
+    }
+    pool->cell = malloc(sizeof(uint16_t) * slots);
+    if (!pool->cell) {
+        printf("%s no free memory\n", __func__);
+        return;
+    }
+    for (unsigned int i = 0; i < slots; i++) {
+        pool->palette[i] = PALETTE_NONE;
+        pool->cell[i] = ATLAS_CELL_NONE;
+    }
     pool->format = malloc(format_size);
     if (!pool->format) {
         printf("%s no free memory\n", __func__);
         return;
     }
     memset(pool->state, '\0', state_size);
+    memset(pool->generation, '\0', generation_size);
     memset(pool->format, '\0', format_size);
 }
 
@@ -58,7 +101,7 @@ pool_get_next_free(block_pool* pool, unsigned int* slot_num, void** ptr) {
                 *slot_num = i;
             }
             if (ptr) {
-                *ptr = (void*)((uintptr_t)pool->base + i * pool->slot_size);
+                *ptr = pool->addr[i];
             }
 
             return;
@@ -77,6 +120,42 @@ pool_dealloc_all(block_pool* pool) {
     }
 }
 
+/* Replaces whatever the slot held, NULL if the heap had no room even after
+ * evicting */
+void*
+pool_alloc_slot_vram(block_pool* pool, unsigned int slot_num, uint32_t size) {
+    _pool_release_texture(pool, slot_num);
+    pool->addr[slot_num] = vram_alloc((enum VRAM_CLIENT)pool->client, size);
+    return pool->addr[slot_num];
+}
+
+void*
+pool_alloc_slot_atlas(block_pool* pool, unsigned int slot_num, uint32_t format, uint32_t size, int open) {
+    uint32_t page_size, x, y;
+
+    _pool_release_texture(pool, slot_num);
+    pool->cell[slot_num] = (uint16_t)icon_atlas_alloc(format, size, open);
+    if (pool->cell[slot_num] == ATLAS_CELL_NONE) {
+        return NULL;
+    }
+    pool->addr[slot_num] = icon_atlas_cell_page(pool->cell[slot_num], &page_size, &x, &y);
+    return pool->addr[slot_num];
+}
+
+/* Takes over the reference to bank, whatever the slot held is released */
+void
+pool_set_slot_palette(block_pool* pool, unsigned int slot_num, int bank) {
+    palette_bank_release(pool->palette[slot_num]);
+    pool->palette[slot_num] = (int16_t)bank;
+}
+
+/* Drops the texture and palette but keeps the slot */
+void
+pool_release_slot_texture(block_pool* pool, unsigned int slot_num) {
+    _pool_release_texture(pool, slot_num);
+    pool_set_slot_palette(pool, slot_num, PALETTE_NONE);
+}
+
 void
 pool_dealloc_slot(block_pool* pool, unsigned int slot_num) {
     if (slot_num < pool->slots) {
@@ -86,20 +165,30 @@ pool_dealloc_slot(block_pool* pool, unsigned int slot_num) {
 
 void
 pool_destroy_user(block_pool* pool, void (*user_free)(void* ptr)) {
-    pool->base = NULL;
-    pool->size = 0;
+    pool_dealloc_all(pool);
     pool->slots = 0;
+    (*user_free)(pool->addr);
     (*user_free)(pool->state);
+    (*user_free)(pool->generation);
+    (*user_free)(pool->palette);
+    (*user_free)(pool->cell);
     (*user_free)(pool->format);
 }
 
 void
 pool_destroy(block_pool* pool) {
-    pool->base = NULL;
-    pool->size = 0;
+    pool_dealloc_all(pool);
     pool->slots = 0;
+    free(pool->addr);
     free(pool->state);
+    free(pool->generation);
+    free(pool->palette);
+    free(pool->cell);
     free(pool->format);
+    pool->addr = NULL;
     pool->state = NULL;
+    pool->generation = NULL;
+    pool->palette = NULL;
+    pool->cell = NULL;
     pool->format = NULL;
 }
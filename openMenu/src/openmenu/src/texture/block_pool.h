@@ -17,26 +17,43 @@ typedef struct slot_format {
     uint32_t format;
 } slot_format;
 
+/* Slot states, loading slots are owned but their texture is still in flight */
+enum POOL_SLOT_STATE {
+    POOL_SLOT_OPEN = 0,
+    POOL_SLOT_USED = 1,
+    POOL_SLOT_LOADING = 2,
+};
+
+/* Slots only hold bookkeeping, each texture gets exactly its size from the
+ * vram heap once it is known */
 typedef struct block_pool {
-    void* base;
-    unsigned int size;
     unsigned int slots;
-    unsigned int slot_size;
+    int client; /* enum VRAM_CLIENT the textures are charged to */
     unsigned char* state;
+    uint16_t* generation; /* bumped on every dealloc, stale loads compare against it */
+    void** addr;          /* NULL until a texture is uploaded */
+    int16_t* palette;     /* palette bank of paletted textures, else PALETTE_NONE */
+    uint16_t* cell;       /* icon atlas cell, ATLAS_CELL_NONE for a texture of its own */
     slot_format* format;
 } block_pool;
 
-void pool_create(block_pool* pool, void* buffer, unsigned int size, unsigned int slot);
+void pool_create(block_pool* pool, int client, unsigned int slots);
 void pool_destroy(block_pool* pool);
 void pool_destroy_user(block_pool* pool, void (*user_free)(void* ptr));
 void pool_get_next_free(block_pool* pool, unsigned int* slot_num, void** ptr);
 void pool_dealloc_all(block_pool* pool);
 void pool_dealloc_slot(block_pool* pool, unsigned int slot_num);
+void* pool_alloc_slot_vram(block_pool* pool, unsigned int slot_num, uint32_t size);
+/* Puts the slot on an atlas page instead, NULL if no page of format has room
+ * and open doesn't allow a new one */
+void* pool_alloc_slot_atlas(block_pool* pool, unsigned int slot_num, uint32_t format, uint32_t size, int open);
+void pool_set_slot_palette(block_pool* pool, unsigned int slot_num, int bank);
+void pool_release_slot_texture(block_pool* pool, unsigned int slot_num);
 
 /* inline funcs */
 static inline void*
 pool_get_slot_addr(const block_pool* pool, unsigned int slot_num) {
-    return (void*)((uintptr_t)pool->base + slot_num * pool->slot_size);
+    return pool->addr[slot_num];
 }
 
 static inline const slot_format*
@@ -51,3 +68,28 @@ pool_set_slot_format(block_pool* pool, unsigned int slot_num, unsigned int width
     pool->format[slot_num].height = height;
     pool->format[slot_num].format = format;
 }
+
+static inline unsigned int
+pool_get_slot_cell(const block_pool* pool, unsigned int slot_num) {
+    return pool->cell[slot_num];
+}
+
+static inline unsigned int
+pool_get_slot_generation(const block_pool* pool, unsigned int slot_num) {
+    return pool->generation[slot_num];
+}
+
+static inline int
+pool_slot_loading(const block_pool* pool, unsigned int slot_num) {
+    return pool->state[slot_num] == POOL_SLOT_LOADING;
+}
+
+static inline void
+pool_mark_slot_loading(block_pool* pool, unsigned int slot_num) {
+    pool->state[slot_num] = POOL_SLOT_LOADING;
+}
+
+static inline void
+pool_mark_slot_ready(block_pool* pool, unsigned int slot_num) {
+    pool->state[slot_num] = POOL_SLOT_USED;
+}
@@ -0,0 +1,374 @@
+/*
+ * File: icon_atlas.c
+ * Project: texture
+ * File Created: Sunday, 18th October 2026 8:51:06 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License,
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <dc/pvr.h>
+#include <kos/fs.h>
+
+/* Every table in here is keyed by product_key */
+#define HASH_FUNCTION PRODUCT_KEY_HASH_FUNCTION
+#define HASH_KEYCMP   PRODUCT_KEY_KEYCMP
+#include <uthash.h>
+
+#include "ui/dc/pvr_texture.h"
+#include "vram_heap.h"
+
+#include "icon_atlas.h"
+
+/* Quadtree node states, children of a free node are all free */
+enum ATLAS_NODE {
+    NODE_FREE = 0,
+    NODE_SPLIT,
+    NODE_USED,
+};
+
+/* Cells are the page number over the node number */
+#define CELL_PAGE_SHIFT (13)
+#define CELL_NODE_MASK  ((1 << CELL_PAGE_SHIFT) - 1)
+
+/* Index of a prebuilt page, a 1024 page of the smallest cells is 20KB */
+#define ATLAS_INDEX_MAX (32 * 1024)
+
+#define FORMAT_COLOR_MASK (7 << 27)
+
+typedef struct atlas_entry {
+    product_key key;
+    uint16_t page;
+    uint16_t x, y, size;
+    UT_hash_handle hh;
+} atlas_entry;
+
+typedef struct atlas_page {
+    void* vram; /* NULL while the page is unused */
+    uint32_t format;
+    uint32_t size;
+    int levels;           /* cell sizes from the page down to ATLAS_MIN_CELL */
+    uint8_t* nodes;       /* runtime pages only */
+    atlas_entry* entries; /* prebuilt pages only */
+} atlas_page;
+
+static atlas_page pages[ATLAS_PAGES_MAX];
+static atlas_entry* prebuilt = NULL;
+static uint32_t page_size = ATLAS_PAGE_SIZE;
+
+static inline uint32_t
+level_base(int level) {
+    return ((1u << (level * 2)) - 1) / 3;
+}
+
+static int
+level_of(uint32_t node) {
+    int level = 0;
+    while (level_base(level + 1) <= node) {
+        level++;
+    }
+    return level;
+}
+
+static uint32_t
+format_bits(uint32_t format) {
+    switch (format & FORMAT_COLOR_MASK) {
+        case PVR_TXRFMT_PAL4BPP: return 4;
+        case PVR_TXRFMT_PAL8BPP: return 8;
+        default: return 16;
+    }
+}
+
+static void
+page_release(atlas_page* page) {
+    vram_free(page->vram);
+    free(page->nodes);
+    free(page->entries);
+    memset(page, 0, sizeof(atlas_page));
+}
+
+void
+icon_atlas_init(uint32_t size) {
+    atlas_entry *entry, *tmp;
+    HASH_ITER(hh, prebuilt, entry, tmp) {
+        HASH_DEL(prebuilt, entry);
+    }
+    for (int i = 0; i < ATLAS_PAGES_MAX; i++) {
+        page_release(&pages[i]);
+    }
+    page_size = size;
+}
+
+/* Takes the first free cell at target, split nodes are tried before free ones
+ * so larger free squares stay whole */
+static int
+node_alloc(atlas_page* page, int level, uint32_t idx, int target) {
+    uint8_t* node = &page->nodes[level_base(level) + idx];
+
+    if (level == target) {
+        if (*node != NODE_FREE) {
+            return -1;
+        }
+        *node = NODE_USED;
+        return (int)(level_base(level) + idx);
+    }
+    if (*node == NODE_USED) {
+        return -1;
+    }
+    if (*node == NODE_FREE) {
+        *node = NODE_SPLIT;
+        return node_alloc(page, level + 1, idx * 4, target);
+    }
+
+    for (int pass = 0; pass < 2; pass++) {
+        for (uint32_t child = idx * 4; child < idx * 4 + 4; child++) {
+            const int split = page->nodes[level_base(level + 1) + child] == NODE_SPLIT;
+            if (split != (pass == 0)) {
+                continue;
+            }
+            const int found = node_alloc(page, level + 1, child, target);
+            if (found >= 0) {
+                return found;
+            }
+        }
+    }
+    return -1;
+}
+
+static int
+page_open(atlas_page* page, uint32_t format) {
+    page->levels = 1;
+    while ((page_size >> page->levels) >= ATLAS_MIN_CELL) {
+        page->levels++;
+    }
+    page->nodes = calloc(level_base(page->levels), sizeof(uint8_t));
+    if (!page->nodes) {
+        printf("%s no free memory\n", __func__);
+        return 1;
+    }
+    /* Never evicts, icons only move onto pages while there is spare room */
+    page->vram = vram_try_alloc(VRAM_CLIENT_ICON, page_size * page_size * format_bits(format) / 8);
+    if (!page->vram) {
+        free(page->nodes);
+        page->nodes = NULL;
+        return 1;
+    }
+    page->format = format;
+    page->size = page_size;
+    return 0;
+}
+
+unsigned int
+icon_atlas_alloc(uint32_t format, uint32_t size, int open) {
+    int target = 0;
+
+    if (size < ATLAS_MIN_CELL) {
+        size = ATLAS_MIN_CELL;
+    }
+    while ((page_size >> target) > size) {
+        target++;
+    }
+    if ((page_size >> target) != size) {
+        return ATLAS_CELL_NONE;
+    }
+
+    for (int i = 0; i < ATLAS_PAGES_MAX; i++) {
+        if (pages[i].nodes && pages[i].format == format) {
+            const int node = node_alloc(&pages[i], 0, 0, target);
+            if (node >= 0) {
+                return (unsigned int)(i << CELL_PAGE_SHIFT | node);
+            }
+        }
+    }
+    for (int i = 0; i < ATLAS_PAGES_MAX && open; i++) {
+        if (!pages[i].vram) {
+            if (page_open(&pages[i], format)) {
+                return ATLAS_CELL_NONE;
+            }
+            return (unsigned int)(i << CELL_PAGE_SHIFT | node_alloc(&pages[i], 0, 0, target));
+        }
+    }
+    return ATLAS_CELL_NONE;
+}
+
+void
+icon_atlas_free(unsigned int cell) {
+    if (cell == ATLAS_CELL_NONE) {
+        return;
+    }
+    atlas_page* page = &pages[cell >> CELL_PAGE_SHIFT];
+    uint32_t node = cell & CELL_NODE_MASK;
+    int level = level_of(node);
+    uint32_t idx = node - level_base(level);
+
+    page->nodes[node] = NODE_FREE;
+    while (level > 0) {
+        const uint8_t* siblings = &page->nodes[level_base(level) + (idx & ~3u)];
+        if (siblings[0] | siblings[1] | siblings[2] | siblings[3]) {
+            return;
+        }
+        level--;
+        idx >>= 2;
+        page->nodes[level_base(level) + idx] = NODE_FREE;
+    }
+    page_release(page);
+}
+
+void*
+icon_atlas_cell_page(unsigned int cell, uint32_t* size, uint32_t* x, uint32_t* y) {
+    const atlas_page* page = &pages[cell >> CELL_PAGE_SHIFT];
+    const uint32_t node = cell & CELL_NODE_MASK;
+    const int level = level_of(node);
+    const uint32_t idx = node - level_base(level);
+    const uint32_t cell_size = page->size >> level;
+    uint32_t cx = 0, cy = 0;
+
+    /* Same bit order as the twiddled layout */
+    for (int bit = 0; bit < level; bit++) {
+        cy |= ((idx >> (bit * 2)) & 1) << bit;
+        cx |= ((idx >> (bit * 2 + 1)) & 1) << bit;
+    }
+    *size = page->size;
+    *x = cx * cell_size;
+    *y = cy * cell_size;
+    return page->vram;
+}
+
+static int
+atlas_read_entries(atlas_page* page, int page_num, const unsigned char* data, uint32_t len) {
+    const unsigned char* pvat = pvr_find_block(data, "PVAT", &len);
+    if (!pvat) {
+        return 1;
+    }
+    const unsigned int count = pvat[0] | pvat[1] << 8;
+    if (4 + count * ATLAS_ENTRY_SIZE > len) {
+        return 1;
+    }
+
+    page->entries = calloc(count, sizeof(atlas_entry));
+    if (!page->entries) {
+        printf("%s no free memory\n", __func__);
+        return 1;
+    }
+    for (unsigned int i = 0; i < count; i++) {
+        const unsigned char* raw = pvat + 4 + i * ATLAS_ENTRY_SIZE;
+        atlas_entry* entry = &page->entries[i];
+        char id[PRODUCT_KEY_MAX_LEN + 1] = {0};
+
+        memcpy(id, raw, PRODUCT_KEY_MAX_LEN);
+        product_key_make(&entry->key, id);
+        entry->page = (uint16_t)page_num;
+        entry->x = raw[12] | raw[13] << 8;
+        entry->y = raw[14] | raw[15] << 8;
+        entry->size = raw[16] | raw[17] << 8;
+        if (entry->x + entry->size > page->size || entry->y + entry->size > page->size) {
+            continue;
+        }
+        HASH_ADD(hh, prebuilt, key, sizeof(product_key), entry);
+    }
+    return 0;
+}
+
+static int
+atlas_load_page(atlas_page* page, int page_num, const char* filename) {
+    void* block = pvr_get_stream_block();
+    pvr_stream stream;
+    pvr_stream_dest dest;
+    char path[64];
+    file_t fd;
+
+    snprintf(path, sizeof(path), "/cd/%s", filename);
+    if (!block || (fd = fs_open(path, O_RDONLY)) == -1) {
+        return 1;
+    }
+
+    /* Prebuilt pages have no palette bank to go with them so they are 16bpp only */
+    const uint32_t total = fs_total(fd);
+    if (!pvr_stream_open(&stream, fd, 0, total) || stream.width != stream.height
+        || (stream.format & PVR_TXRFMT_VQ_ENABLE) || format_bits(stream.format) != 16) {
+        printf("%s %s is not a page\n", __func__, filename);
+        fs_close(fd);
+        return 1;
+    }
+    if (!(page->vram = vram_alloc(VRAM_CLIENT_ICON, stream.size))) {
+        fs_close(fd);
+        return 1;
+    }
+    page->format = stream.format;
+    page->size = stream.width;
+    pvr_stream_dest_buffer(&stream, page->vram, &dest);
+
+    /* Whatever follows is the blocks */
+    int bad = !pvr_stream_load(&stream, &dest, block);
+    const uint32_t rest = total - stream.next;
+    unsigned char* index = NULL;
+    if (!bad) {
+        bad = rest > ATLAS_INDEX_MAX || !(index = malloc(rest));
+    }
+    if (!bad) {
+        fs_seek(fd, stream.next, SEEK_SET);
+        bad = (uint32_t)fs_read(fd, index, rest) != rest || atlas_read_entries(page, page_num, index, rest);
+    }
+    free(index);
+    fs_close(fd);
+    if (bad) {
+        printf("%s %s has no index\n", __func__, filename);
+        page_release(page);
+        return 1;
+    }
+    return 0;
+}
+
+int
+icon_atlas_load_prebuilt(void) {
+    char filename[16];
+    int loaded = 0;
+
+    for (int i = 0; i < ATLAS_PAGES_MAX; i++) {
+        snprintf(filename, sizeof(filename), ATLAS_FILE, i);
+        if (atlas_load_page(&pages[i], i, filename)) {
+            break;
+        }
+        loaded++;
+    }
+    if (loaded) {
+        printf("ATLAS: %d prebuilt pages, %u icons\n", loaded, HASH_COUNT(prebuilt));
+    }
+    return loaded;
+}
+
+int
+icon_atlas_find(const product_key* key, struct image* img) {
+    atlas_entry* entry;
+
+    if (!prebuilt) {
+        return 0;
+    }
+    HASH_FIND(hh, prebuilt, key, sizeof(product_key), entry);
+    if (!entry || !img) {
+        return entry != NULL;
+    }
+    const atlas_page* page = &pages[entry->page];
+    img->texture = page->vram;
+    img->format = page->format;
+    img->width = img->height = entry->size;
+    img->atlas_x = entry->x;
+    img->atlas_y = entry->y;
+    img->atlas_size = (uint16_t)page->size;
+    return 1;
+}
+
+unsigned int
+icon_atlas_pages(void) {
+    unsigned int used = 0;
+    for (int i = 0; i < ATLAS_PAGES_MAX; i++) {
+        used += pages[i].vram != NULL;
+    }
+    return used;
+}
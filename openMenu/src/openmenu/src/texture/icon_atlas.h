@@ -0,0 +1,52 @@
+/*
+ * File: icon_atlas.h
+ * Project: texture
+ * File Created: Sunday, 18th October 2026 8:51:06 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <backend/product_key.h>
+
+struct image;
+
+/* Packs icons into shared square texture pages so icons on the same page draw
+ * under one header. Each page holds one texture format, space is handed out
+ * as aligned power of two squares split from the page like a quadtree. Pages
+ * are taken from the icon share of the vram heap when there is free room and
+ * given back once empty. Cells sit edge to edge, drawing keeps its UVs half a
+ * texel inside the cell so filtering doesn't pick up the neighbours. */
+
+#define ATLAS_PAGE_SIZE  (512) /* texels across */
+#define ATLAS_PAGES_MAX  (8)
+#define ATLAS_MIN_CELL   (32)
+#define ATLAS_CELL_NONE  (0xFFFF)
+
+/* Prebuilt pages are ATLAS_FILE with the page number, a PVR followed by a
+ * "PVAT" block: u16 count, u16 unused, then count of char id[12], u16 x, u16 y,
+ * u16 size, u16 unused. */
+#define ATLAS_FILE       "ICONATL%d.PVR"
+#define ATLAS_ENTRY_SIZE (20)
+
+/* page_size is 512 or 1024, drops every page */
+void icon_atlas_init(uint32_t page_size);
+
+/* Room for a size x size texture of format, ATLAS_CELL_NONE if none is free.
+ * A new page is only opened for format when open is set. */
+unsigned int icon_atlas_alloc(uint32_t format, uint32_t size, int open);
+void icon_atlas_free(unsigned int cell);
+/* Page texture holding cell, with its size in texels and where the cell sits */
+void* icon_atlas_cell_page(unsigned int cell, uint32_t* page_size, uint32_t* x, uint32_t* y);
+
+/* Loads every prebuilt page found, returns how many */
+int icon_atlas_load_prebuilt(void);
+/* Fills img (if given) when key is on a prebuilt page, returns 0 if not */
+int icon_atlas_find(const product_key* key, struct image* img);
+
+unsigned int icon_atlas_pages(void); /* pages in use, prebuilt included */
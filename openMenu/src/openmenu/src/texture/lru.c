@@ -1,3 +1,14 @@
+/*
+ * File: lru.c
+ * Project: texture
+ * File Created: Sunday, 18th October 2026 6:20:32 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License,
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ */
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -10,17 +21,165 @@
 #define DBG_PRINT(...)
 #endif
 
-/* Missing on sh-elf-gcc 9.1 ? */
-char* strdup(const char* s);
+/* Position in the index holding key, or -1. Hashes are compared before keys. */
+static int
+_cache_index_find(const cache_instance* cache, const product_key* key, uint32_t hash) {
+    if (!cache->index) {
+        return -1;
+    }
+    for (unsigned int pos = hash & cache->index_mask;; pos = (pos + 1) & cache->index_mask) {
+        const int node = cache->index[pos];
+        if (node == CACHE_NODE_NONE) {
+            return -1;
+        }
+        if (cache->nodes[node].hash == hash && product_key_equal(&cache->nodes[node].key, key)) {
+            return (int)pos;
+        }
+    }
+}
+
+/* Position in the index of a node known to be in it */
+static unsigned int
+_cache_index_of(const cache_instance* cache, int node) {
+    unsigned int pos = cache->nodes[node].hash & cache->index_mask;
+    while (cache->index[pos] != node) {
+        pos = (pos + 1) & cache->index_mask;
+    }
+    return pos;
+}
+
+static void
+_cache_index_insert(cache_instance* cache, int node) {
+    unsigned int pos = cache->nodes[node].hash & cache->index_mask;
+    while (cache->index[pos] != CACHE_NODE_NONE) {
+        pos = (pos + 1) & cache->index_mask;
+    }
+    cache->index[pos] = (int16_t)node;
+}
+
+/* Linear probing delete, shifts later entries back instead of leaving tombstones */
+static void
+_cache_index_remove(cache_instance* cache, unsigned int pos) {
+    const unsigned int mask = cache->index_mask;
+    unsigned int next = (pos + 1) & mask;
+
+    while (cache->index[next] != CACHE_NODE_NONE) {
+        const unsigned int home = cache->nodes[cache->index[next]].hash & mask;
+        /* entries whose home lies cyclically in (pos, next] stay put */
+        const int stays = (pos <= next) ? (pos < home && home <= next) : (pos < home || home <= next);
+        if (!stays) {
+            cache->index[pos] = cache->index[next];
+            pos = next;
+        }
+        next = (next + 1) & mask;
+    }
+    cache->index[pos] = CACHE_NODE_NONE;
+}
+
+static void
+_cache_unlink(cache_instance* cache, int node) {
+    cache_node* n = &cache->nodes[node];
+    if (n->prev != CACHE_NODE_NONE) {
+        cache->nodes[n->prev].next = n->next;
+    } else {
+        cache->head = n->next;
+    }
+    if (n->next != CACHE_NODE_NONE) {
+        cache->nodes[n->next].prev = n->prev;
+    } else {
+        cache->tail = n->prev;
+    }
+}
+
+static void
+_cache_push_front(cache_instance* cache, int node) {
+    cache_node* n = &cache->nodes[node];
+    n->prev = CACHE_NODE_NONE;
+    n->next = cache->head;
+    if (cache->head != CACHE_NODE_NONE) {
+        cache->nodes[cache->head].prev = (int16_t)node;
+    } else {
+        cache->tail = (int16_t)node;
+    }
+    cache->head = (int16_t)node;
+}
+
+/* Takes the node at index position pos out of the index and the recency list */
+static int
+_cache_release(cache_instance* cache, unsigned int pos) {
+    const int node = cache->index[pos];
+    cache_node* n = &cache->nodes[node];
+
+    _cache_index_remove(cache, pos);
+    _cache_unlink(cache, node);
+    DBG_PRINT("-del_from_cache( %s )\n", n->key.str);
+    if (cache->callback_del) {
+        (*cache->callback_del)(n->key.str, &n->value, cache->callback_data);
+    }
+    return node;
+}
 
-// this is an example of how to do a LRU cache in C using uthash
-// http://uthash.sourceforge.net/
-// by Jehiah Czebotar 2011 - jehiah@gmail.com
-// this code is in the public domain http://unlicense.org/
+/* Drops the node at index position pos and hands it back to the free list */
+static void
+_cache_drop(cache_instance* cache, unsigned int pos) {
+    const int node = _cache_release(cache, pos);
+
+    cache->nodes[node].next = cache->free_list;
+    cache->free_list = (int16_t)node;
+    cache->count--;
+}
+
+static void
+_cache_reset(cache_instance* cache) {
+    for (unsigned int i = 0; i <= cache->index_mask; i++) {
+        cache->index[i] = CACHE_NODE_NONE;
+    }
+    for (unsigned int i = 0; i < cache->cache_max_size; i++) {
+        cache->nodes[i].next = (i + 1 < cache->cache_max_size) ? (int16_t)(i + 1) : CACHE_NODE_NONE;
+    }
+    cache->free_list = cache->cache_max_size ? 0 : CACHE_NODE_NONE;
+    cache->head = cache->tail = CACHE_NODE_NONE;
+    cache->count = 0;
+}
 
 void
 cache_set_size(cache_instance* cache, int size) {
+    unsigned int index_size = 4;
+
+    cache_destroy(cache);
+
+    /* keep the index at most half full */
+    while (index_size < (unsigned int)size * 2) {
+        index_size <<= 1;
+    }
+
+    cache->nodes = malloc(sizeof(cache_node) * size);
+    cache->index = malloc(sizeof(int16_t) * index_size);
+    if (!cache->nodes || !cache->index) {
+        printf("%s no free memory\n", __func__);
+        free(cache->nodes);
+        free(cache->index);
+        cache->nodes = NULL;
+        cache->index = NULL;
+        return;
+    }
     cache->cache_max_size = size;
+    cache->index_mask = index_size - 1;
+    _cache_reset(cache);
+}
+
+void
+cache_destroy(cache_instance* cache) {
+    if (cache->nodes) {
+        empty_cache(cache);
+    }
+    free(cache->nodes);
+    free(cache->index);
+    cache->nodes = NULL;
+    cache->index = NULL;
+    cache->cache_max_size = 0;
+    cache->index_mask = 0;
+    cache->count = 0;
 }
 
 void
@@ -39,81 +198,140 @@ cache_callback_del(cache_instance* cache, user_del_cb callback) {
 }
 
 int
-find_in_cache(cache_instance* cache, const char* key) {
-    struct CacheEntry* entry;
+find_in_cache(cache_instance* cache, const product_key* key) {
     if (!cache || !key) {
         return -1;
     }
-    HASH_FIND_STR(cache->cache, key, entry);
-    if (entry) {
-        // remove it (so the subsequent add will throw it on the front of the list)
-        if (entry != cache->cache) {
-            HASH_DELETE(hh, cache->cache, entry);
-            HASH_ADD_STR(cache->cache, key, entry);
-        }
-        return entry->value;
+    const int pos = _cache_index_find(cache, key, product_key_hash(key));
+    if (pos == -1) {
+        return -1;
+    }
+
+    const int node = cache->index[pos];
+    if (node != cache->head) {
+        _cache_unlink(cache, node);
+        _cache_push_front(cache, node);
     }
-    return -1;
+    return cache->nodes[node].value;
 }
 
-void
-add_to_cache(cache_instance* cache, const char* key, int value) {
-    DBG_PRINT("+%s( %s )\n", __func__, key);
-    struct CacheEntry *entry, *tmp_entry, *new_entry;
+/* Same as find_in_cache but leaves the entry's age alone */
+int
+peek_in_cache(const cache_instance* cache, const product_key* key) {
+    if (!cache || !key) {
+        return -1;
+    }
+    const int pos = _cache_index_find(cache, key, product_key_hash(key));
+    return (pos == -1) ? -1 : cache->nodes[cache->index[pos]].value;
+}
+
+static int
+_cache_oldest_unpinned(const cache_instance* cache) {
+    int node = cache->tail;
+    while (node != CACHE_NODE_NONE && cache->nodes[node].pins) {
+        node = cache->nodes[node].prev;
+    }
+    return node;
+}
+
+int
+add_to_cache(cache_instance* cache, const product_key* key, int value) {
+    DBG_PRINT("+%s( %s )\n", __func__, key->str);
     unsigned int cb_return = 0xFFFFFFFF;
+    const uint32_t hash = product_key_hash(key);
+    int node;
 
-    /* Call user function */
-    if (cache->callback_add) {
-        cb_return = (*cache->callback_add)(key, cache->callback_data);
+    if (!cache->nodes) {
+        return -1;
+    }
+    /* a second node for the same key would never be found again */
+    if (_cache_index_find(cache, key, hash) != -1) {
+        DBG_PRINT("%s %s is already cached\n", __func__, key->str);
+        return find_in_cache(cache, key);
     }
 
-    entry = calloc(1, sizeof(struct CacheEntry));
-    if (!entry) {
-        printf("%s no free memory\n", __func__);
-        return;
+    /* make room first so the add callback only runs once, the oldest unpinned
+     * node is taken over */
+    if (cache->count == cache->cache_max_size) {
+        node = _cache_oldest_unpinned(cache);
+        if (node == CACHE_NODE_NONE) {
+            return -1;
+        }
+        _cache_release(cache, _cache_index_of(cache, node));
+        cache->evictions++;
+    } else {
+        node = cache->free_list;
+        cache->free_list = cache->nodes[node].next;
+        cache->count++;
+    }
+
+    /* Call user function */
+    if (cache->callback_add) {
+        cb_return = (*cache->callback_add)(key->str, cache->callback_data);
     }
-    entry->key = strdup(key);
     if (cb_return != 0xFFFFFFFF) {
         value = cb_return;
     }
-    entry->value = value;
-    new_entry = entry;
-    HASH_ADD_STR(cache->cache, key, entry);
-
-    // prune the cache to cache_max_size
-    if (HASH_COUNT(cache->cache) > cache->cache_max_size) {
-        HASH_ITER(hh, cache->cache, entry, tmp_entry) {
-            // prune the first entry (loop is based on insertion order so this deletes
-            // the oldest item)
-            HASH_DELETE(hh, cache->cache, entry);
-            DBG_PRINT("-del_from_cache( %s )\n", key);
-            if (cache->callback_del) {
-                (*cache->callback_del)(entry->key, &entry->value, cache->callback_data);
-                if (cache->callback_add) {
-                    cb_return = (*cache->callback_add)(key, cache->callback_data);
-                }
-                new_entry->value = cb_return;
-            }
-
-            free(entry->key);
-            free(entry);
-            break;
-        }
+
+    cache_node* n = &cache->nodes[node];
+    n->key = *key;
+    n->hash = hash;
+    n->value = value;
+    n->pins = 0;
+    _cache_index_insert(cache, node);
+    _cache_push_front(cache, node);
+
+    return value;
+}
+
+void
+remove_from_cache(cache_instance* cache, const product_key* key) {
+    const int pos = _cache_index_find(cache, key, product_key_hash(key));
+    if (pos != -1) {
+        _cache_drop(cache, pos);
     }
 }
 
+int
+evict_from_cache(cache_instance* cache) {
+    if (!cache->nodes) {
+        return 0;
+    }
+    const int victim = _cache_oldest_unpinned(cache);
+    if (victim == CACHE_NODE_NONE) {
+        return 0;
+    }
+    _cache_drop(cache, _cache_index_of(cache, victim));
+    cache->evictions++;
+    return 1;
+}
+
 void
 empty_cache(cache_instance* cache) {
-    struct CacheEntry *entry, *tmp_entry;
-    HASH_ITER(hh, cache->cache, entry, tmp_entry) {
-        // prune all entries
-        HASH_DELETE(hh, cache->cache, entry);
-        DBG_PRINT("-del_from_cache( %s )\n", key);
+    if (!cache->nodes) {
+        return;
+    }
+    for (int node = cache->head; node != CACHE_NODE_NONE; node = cache->nodes[node].next) {
+        DBG_PRINT("-del_from_cache( %s )\n", cache->nodes[node].key.str);
         if (cache->callback_del) {
-            (*cache->callback_del)(entry->key, &entry->value, cache->callback_data);
+            (*cache->callback_del)(cache->nodes[node].key.str, &cache->nodes[node].value, cache->callback_data);
         }
+    }
+    _cache_reset(cache);
+}
 
-        free(entry->key);
-        free(entry);
+void
+pin_in_cache(cache_instance* cache, const product_key* key) {
+    const int pos = _cache_index_find(cache, key, product_key_hash(key));
+    if (pos != -1) {
+        cache->nodes[cache->index[pos]].pins++;
+    }
+}
+
+void
+unpin_in_cache(cache_instance* cache, const product_key* key) {
+    const int pos = _cache_index_find(cache, key, product_key_hash(key));
+    if (pos != -1 && cache->nodes[cache->index[pos]].pins) {
+        cache->nodes[cache->index[pos]].pins--;
     }
 }
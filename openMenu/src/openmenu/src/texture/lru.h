@@ -1,30 +1,66 @@
+/*
+ * File: lru.h
+ * Project: texture
+ * File Created: Sunday, 18th October 2026 6:20:32 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+
 #pragma once
 
-#include <uthash.h>
+#include <stdint.h>
+
+#include <backend/product_key.h>
 
 /* Function callbacks */
 typedef unsigned int (*user_add_cb)(const char* key, void* user);
 typedef unsigned int (*user_del_cb)(const char* key, void* value, void* user);
 
-struct CacheEntry {
-    char* key;
+/* Fixed capacity, all nodes are allocated by cache_set_size. Nodes link by
+ * index into a recency list (head is newest) and are found through an open
+ * addressed index of node numbers. Each keeps its key's hash so probes and
+ * index moves don't hash again. */
+typedef struct cache_node {
+    product_key key;
+    uint32_t hash;
     int value;
-    UT_hash_handle hh;
-};
+    int16_t prev, next;
+    uint16_t pins;
+} cache_node;
 
 typedef struct cache_instance {
     unsigned int cache_max_size;
+    unsigned int count;
     void* callback_data;
     user_add_cb callback_add;
     user_del_cb callback_del;
-    struct CacheEntry* cache;
+    cache_node* nodes;
+    int16_t* index; /* CACHE_NODE_NONE or node number */
+    unsigned int index_mask;
+    int16_t head, tail, free_list;
+    unsigned int evictions; /* entries pushed out to make room */
 } cache_instance;
 
+#define CACHE_NODE_NONE (-1)
+
+/* (Re)allocates for size entries, anything cached is dropped first */
 void cache_set_size(cache_instance* cache, int size);
+void cache_destroy(cache_instance* cache);
 void cache_callback_userdata(cache_instance* cache, void* user);
 void cache_callback_add(cache_instance* cache, user_add_cb callback);
 void cache_callback_del(cache_instance* cache, user_del_cb callback);
 
-int find_in_cache(cache_instance* cache, const char* key);
-void add_to_cache(cache_instance* cache, const char* key, int value);
+int find_in_cache(cache_instance* cache, const product_key* key);
+int peek_in_cache(const cache_instance* cache, const product_key* key);
+/* Returns the value, -1 if every entry is pinned. Only for keys not cached
+ * yet, callers look them up first. */
+int add_to_cache(cache_instance* cache, const product_key* key, int value);
+void remove_from_cache(cache_instance* cache, const product_key* key);
+int evict_from_cache(cache_instance* cache); /* oldest unpinned, 0 if none */
 void empty_cache(cache_instance* cache);
+
+/* Pinned entries are skipped by eviction, pins nest */
+void pin_in_cache(cache_instance* cache, const product_key* key);
+void unpin_in_cache(cache_instance* cache, const product_key* key);
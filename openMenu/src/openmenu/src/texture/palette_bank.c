@@ -0,0 +1,158 @@
+/*
+ * File: palette_bank.c
+ * Project: texture
+ * File Created: Sunday, 18th October 2026 10:05:51 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License,
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <dc/pvr.h>
+
+#include "palette_bank.h"
+
+#define PALETTE_ENTRIES (1024)
+#define UNIT_ENTRIES    (16)
+#define UNITS           (PALETTE_ENTRIES / UNIT_ENTRIES)
+
+/* Per unit, only the first unit of a bank is meaningful */
+static unsigned char bank_units[UNITS]; /* 0 when free, else units the bank spans */
+static uint16_t bank_refs[UNITS];
+static unsigned int bank_age[UNITS];
+static unsigned int age = 0;
+
+/* What was last written to palette RAM, to find banks to share */
+static uint16_t shadow[PALETTE_ENTRIES];
+
+void
+palette_bank_init(void) {
+    memset(bank_units, 0, sizeof(bank_units));
+    memset(bank_refs, 0, sizeof(bank_refs));
+    pvr_set_pal_format(PVR_PAL_ARGB1555);
+}
+
+static int
+palette_find(const uint16_t* entries, int units) {
+    for (int bank = 0; bank < UNITS; bank += units) {
+        if (bank_units[bank] == units
+            && !memcmp(&shadow[bank * UNIT_ENTRIES], entries, units * UNIT_ENTRIES * sizeof(uint16_t))) {
+            return bank;
+        }
+    }
+    return PALETTE_NONE;
+}
+
+/* 1 if every bank overlapping the range is unreferenced, counts the banks that
+ * would be thrown out and remembers the newest of them */
+static int
+palette_range_open(int start, int units, int* cached, unsigned int* newest) {
+    *cached = 0;
+    *newest = 0;
+    for (int unit = 0; unit < UNITS; unit++) {
+        if (!bank_units[unit] || unit + bank_units[unit] <= start || unit >= start + units) {
+            continue;
+        }
+        if (bank_refs[unit]) {
+            return 0;
+        }
+        (*cached)++;
+        if (bank_age[unit] > *newest) {
+            *newest = bank_age[unit];
+        }
+    }
+    return 1;
+}
+
+/* Empty space first, then whatever unreferenced banks were used longest ago */
+static int
+palette_place(int units) {
+    int best = PALETTE_NONE;
+    int best_cached = 0;
+    unsigned int best_newest = 0;
+
+    for (int start = 0; start < UNITS; start += units) {
+        int cached;
+        unsigned int newest;
+        if (!palette_range_open(start, units, &cached, &newest)) {
+            continue;
+        }
+        if (!cached) {
+            return start;
+        }
+        if (best == PALETTE_NONE || newest < best_newest || (newest == best_newest && cached < best_cached)) {
+            best = start;
+            best_cached = cached;
+            best_newest = newest;
+        }
+    }
+    return best;
+}
+
+int
+palette_bank_acquire(const uint16_t* entries, int count) {
+    const int units = count / UNIT_ENTRIES;
+    if (units != 1 && units != 16) {
+        return PALETTE_NONE;
+    }
+
+    int bank = palette_find(entries, units);
+    if (bank == PALETTE_NONE) {
+        bank = palette_place(units);
+        if (bank == PALETTE_NONE) {
+            printf("%s no free palette bank for %d entries\n", __func__, count);
+            return PALETTE_NONE;
+        }
+
+        for (int unit = 0; unit < UNITS; unit++) {
+            if (bank_units[unit] && unit + bank_units[unit] > bank && unit < bank + units) {
+                bank_units[unit] = 0;
+            }
+        }
+        bank_units[bank] = (unsigned char)units;
+        memcpy(&shadow[bank * UNIT_ENTRIES], entries, count * sizeof(uint16_t));
+        for (int i = 0; i < count; i++) {
+            pvr_set_pal_entry(bank * UNIT_ENTRIES + i, entries[i]);
+        }
+    }
+
+    bank_refs[bank]++;
+    bank_age[bank] = ++age;
+    return bank;
+}
+
+void
+palette_bank_release(int bank) {
+    if (bank == PALETTE_NONE || !bank_refs[bank]) {
+        return;
+    }
+    bank_refs[bank]--;
+}
+
+int
+palette_bank_shared(int bank) {
+    return bank != PALETTE_NONE && bank_refs[bank] > 1;
+}
+
+uint32_t
+palette_bank_txrfmt(int bank) {
+    if (bank == PALETTE_NONE) {
+        return 0;
+    }
+    return (bank_units[bank] == 1) ? PVR_TXRFMT_4BPP_PAL(bank) : PVR_TXRFMT_8BPP_PAL(bank / 16);
+}
+
+unsigned int
+palette_bank_used(void) {
+    unsigned int used = 0;
+    for (int unit = 0; unit < UNITS; unit++) {
+        if (bank_refs[unit]) {
+            used += bank_units[unit] * UNIT_ENTRIES;
+        }
+    }
+    return used;
+}
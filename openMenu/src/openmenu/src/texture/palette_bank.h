@@ -0,0 +1,33 @@
+/*
+ * File: palette_bank.h
+ * Project: texture
+ * File Created: Sunday, 18th October 2026 10:05:51 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/* Hands out PVR palette RAM to paletted textures. 1024 ARGB1555 entries split
+ * into 64 banks of 16 for 4bpp, 8bpp takes 16 of those aligned to 256.
+ * Identical palettes share a bank, unreferenced banks keep their contents
+ * until the space is needed so a reload is free. */
+
+#define PALETTE_NONE (-1)
+
+void palette_bank_init(void);
+
+/* count is 16 or 256, returns PALETTE_NONE when nothing fits */
+int palette_bank_acquire(const uint16_t* entries, int count);
+void palette_bank_release(int bank);
+/* Non zero when more than one texture references bank */
+int palette_bank_shared(int bank);
+
+/* Format bits selecting the bank, OR'd into the texture format */
+uint32_t palette_bank_txrfmt(int bank);
+
+unsigned int palette_bank_used(void); /* referenced entries */
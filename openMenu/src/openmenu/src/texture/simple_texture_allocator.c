@@ -14,100 +14,236 @@
 #include <string.h>
 
 #include "texture/simple_texture_allocator.h"
-#include "texture/txr_manager.h"
+#include "texture/vram_heap.h"
+#include "ui/draw_prototypes.h"
 
-static struct Simple_Texture textures[32];
-static void* tex_buffer = NULL;
-static void* tex_buffer_start = NULL;
-static void* tex_buffer_max = NULL;
-static uint32_t tex_number = 0;
+#define HANDLE_SLOT(h)       (((h) & 0xFF) - 1)
+#define HANDLE_GENERATION(h) ((h) >> 8)
 
-static inline size_t
-getMemorySize(int width, int height, int bpp) {
-    return (size_t)(bpp * width * height);
+/* In use while texture is set */
+typedef struct texman_entry {
+    char key[TEXMAN_KEY_LEN];
+    image img;
+    uint32_t size;
+    uint32_t generation;
+    uint16_t refs;
+    unsigned int age; /* when the last reference went */
+} texman_entry;
+
+static texman_entry textures[TEXMAN_MAX_TEXTURES];
+static unsigned int age = 0;
+static unsigned int loads = 0, hits = 0;
+
+/* References taken by texman_load for the current UI */
+static texman_handle ui_handles[TEXMAN_MAX_TEXTURES];
+static int ui_handle_num = 0;
+
+static texman_handle
+make_handle(int slot) {
+    return (textures[slot].generation << 8) | (uint32_t)(slot + 1);
 }
 
-int
-texman_inited(void) {
-    return tex_buffer != 0;
+static texman_entry*
+lookup(texman_handle handle) {
+    const int slot = HANDLE_SLOT(handle);
+    if (slot < 0 || slot >= TEXMAN_MAX_TEXTURES || !textures[slot].img.texture
+        || textures[slot].generation != HANDLE_GENERATION(handle)) {
+        return NULL;
+    }
+    return &textures[slot];
 }
 
-void
-texman_reset(void* buf, uint32_t size) {
-    memset(textures, 0, sizeof(textures));
-    tex_number = 0;
-    tex_buffer = tex_buffer_start = buf;
-    tex_buffer_max = buf + size;
-#ifdef DEBUG
-    char msg[64];
-    sprintf(msg, "TEXMAN: reset @ %p size %d bytes\n", buf, size);
-    printf(msg);
-#endif
+static void
+free_entry(texman_entry* entry) {
+    vram_free(entry->img.texture);
+    entry->img.texture = NULL;
+    entry->key[0] = '\0';
+    entry->size = 0;
+    /* Generations stay below 1 << 24 so they fit above the slot */
+    entry->generation = (entry->generation + 1) & 0xFFFFFF;
 }
 
 void
-texman_clear(void) {
+texman_init(void) {
     memset(textures, 0, sizeof(textures));
-    tex_number = 0;
-    tex_buffer = tex_buffer_start;
-#ifdef DEBUG
-    char msg[64];
-    sprintf(msg, "TEXMAN: clear %p size %d bytes!\n", tex_buffer, TEXMAN_BUFFER_SIZE);
-    printf(msg);
-#endif
+    ui_handle_num = 0;
+    age = loads = hits = 0;
+}
+
+static void*
+texman_alloc(uint32_t size, void* user) {
+    texman_entry* entry = (texman_entry*)user;
+    entry->size = size;
+    return vram_alloc(VRAM_CLIENT_THEME, size);
+}
+
+/* From pvr in memory if given, otherwise the file. Only takes a reference
+ * to what is resident when resident_only is set. */
+static texman_handle
+texman_acquire_from(const char* filename, const void* pvr, int resident_only, image* img) {
+    int free_slot = -1;
+
+    for (int i = 0; i < TEXMAN_MAX_TEXTURES; i++) {
+        if (!textures[i].img.texture) {
+            if (free_slot == -1) {
+                free_slot = i;
+            }
+        } else if (!strcmp(textures[i].key, filename)) {
+            textures[i].refs++;
+            hits++;
+            *img = textures[i].img;
+            return make_handle(i);
+        }
+    }
+    if (resident_only) {
+        return 0;
+    }
+
+    if (free_slot == -1 && texman_evict(NULL)) {
+        return texman_acquire_from(filename, pvr, resident_only, img);
+    }
+    if (free_slot == -1 || strlen(filename) >= TEXMAN_KEY_LEN) {
+        printf("TEXMAN: no room for %s\n", filename);
+        draw_load_missing_icon(img);
+        return 0;
+    }
+
+    texman_entry* entry = &textures[free_slot];
+    image* loaded = &entry->img;
+    memset(loaded, 0, sizeof(image));
+    if (pvr) {
+        const uint32_t size = pvr_get_texture_size(pvr, &loaded->width, &loaded->height, &loaded->format);
+        void* buffer = size ? texman_alloc(size, entry) : NULL;
+        if (buffer) {
+            loaded->texture =
+                load_pvr_from_buffer_to_buffer(pvr, &loaded->width, &loaded->height, &loaded->format, buffer);
+        }
+    } else {
+        loaded->texture =
+            load_pvr_alloc(filename, &loaded->width, &loaded->height, &loaded->format, texman_alloc, entry);
+    }
+    if (!loaded->texture) {
+        draw_load_missing_icon(img);
+        return 0;
+    }
+    strcpy(entry->key, filename);
+    entry->refs = 1;
+    loads++;
+    *img = *loaded;
+    return make_handle(free_slot);
+}
+
+texman_handle
+texman_acquire(const char* filename, image* img) {
+    return texman_acquire_from(filename, NULL, 0, img);
+}
+
+texman_handle
+texman_retain(texman_handle handle) {
+    texman_entry* entry = lookup(handle);
+    if (!entry) {
+        return 0;
+    }
+    entry->refs++;
+    return handle;
 }
 
 void
-texman_set_buffer(void* buf, uint32_t size) {
-    tex_buffer = buf;
-    tex_buffer_max = buf + size;
+texman_release(texman_handle handle) {
+    texman_entry* entry = lookup(handle);
+    if (!entry || !entry->refs) {
+        return;
+    }
+    if (!--entry->refs) {
+        entry->age = ++age;
+    }
 }
 
-int
-texman_get_space_available(void) {
-    return (tex_buffer_max - tex_buffer);
+const image*
+texman_get(texman_handle handle) {
+    const texman_entry* entry = lookup(handle);
+    return entry ? &entry->img : NULL;
 }
 
-int
-texman_is_space_available(void) {
-    return (tex_buffer_max - tex_buffer) > (32 * 1024);
+static texman_handle
+texman_keep_for_ui(texman_handle handle) {
+    if (handle && ui_handle_num < TEXMAN_MAX_TEXTURES) {
+        ui_handles[ui_handle_num++] = handle;
+    }
+    return handle;
 }
 
-unsigned char*
-texman_get_tex_data(uint32_t num) {
-    return textures[num].location;
+texman_handle
+texman_load(const char* filename, image* img) {
+    return texman_keep_for_ui(texman_acquire(filename, img));
 }
 
-struct Simple_Texture*
-texman_reserve_memory(uint32_t width, uint32_t height, int bpp) {
-    if (texman_is_space_available()) {
-        size_t tex_size = getMemorySize(width, height, bpp);
-        tex_buffer = (void*)((((size_t)tex_buffer + tex_size + TEX_ALIGNMENT - 1) / TEX_ALIGNMENT) * TEX_ALIGNMENT);
-#ifdef DEBUG
-        printf("TEX_MAN: tex [%d] reserved %d bytes @ %x left: %d kb\n", tex_number, tex_size,
-               (uint32_t)textures[tex_number].location, (tex_buffer_max - tex_buffer) / 1024);
-#endif
-    } else {
-        printf("TEX_MAN: potential memory overrun! free space: %d bytes\n", texman_get_space_available());
+texman_handle
+texman_load_buffer(const char* key, const void* pvr, image* img) {
+    return texman_keep_for_ui(texman_acquire_from(key, pvr, 0, img));
+}
+
+texman_handle
+texman_load_resident(const char* key, image* img) {
+    return texman_keep_for_ui(texman_acquire_from(key, NULL, 1, img));
+}
+
+void
+texman_clear(void) {
+    for (int i = 0; i < ui_handle_num; i++) {
+        texman_release(ui_handles[i]);
+    }
+    ui_handle_num = 0;
+}
+
+int
+texman_evict(void* user) {
+    texman_entry* oldest = NULL;
+    (void)user;
+
+    for (int i = 0; i < TEXMAN_MAX_TEXTURES; i++) {
+        texman_entry* entry = &textures[i];
+        if (entry->img.texture && !entry->refs && (!oldest || entry->age < oldest->age)) {
+            oldest = entry;
+        }
     }
-    return &textures[tex_number];
+    if (!oldest) {
+        return 0;
+    }
+    free_entry(oldest);
+    return 1;
 }
 
-uint32_t
-texman_create(void) {
-    tex_number++;
-    textures[tex_number] = (struct Simple_Texture){location : tex_buffer, width : 0, height : 0};
+void
+texman_trim_cache(void) {
+    texman_stats stats;
+    texman_get_stats(&stats);
+    while (stats.cached > TEXMAN_CACHE_BUDGET && texman_evict(NULL)) {
+        texman_get_stats(&stats);
+    }
+    vram_client_set_budget(VRAM_CLIENT_THEME, stats.used - stats.cached);
+}
 
-#ifdef DEBUG
-    printf("TEX_MAN: new tex [%d] @ %x\n", tex_number, tex_buffer);
-#endif
-    return tex_number;
+void
+texman_get_stats(texman_stats* stats) {
+    memset(stats, 0, sizeof(texman_stats));
+    for (int i = 0; i < TEXMAN_MAX_TEXTURES; i++) {
+        if (textures[i].img.texture) {
+            stats->used += textures[i].size;
+            stats->cached += textures[i].refs ? 0 : textures[i].size;
+            stats->textures++;
+            stats->referenced += !!textures[i].refs;
+        }
+    }
+    stats->loads = loads;
+    stats->hits = hits;
 }
 
 void
-texman_upload(uint32_t width, uint32_t height, int bpp, const void* buffer) {
-    struct Simple_Texture* current = texman_reserve_memory(width, height, bpp);
-    current->width = width;
-    current->height = height;
-    memcpy(current->location, buffer, getMemorySize(width, height, bpp));
+texman_print_stats(void) {
+    texman_stats stats;
+    texman_get_stats(&stats);
+    printf("TEXMAN: %d textures (%d in use) %u/%u KB, %u KB cached, %u loads %u reused\n", stats.textures,
+           stats.referenced, (unsigned int)stats.used / 1024, TEXMAN_BUDGET / 1024, (unsigned int)stats.cached / 1024,
+           stats.loads, stats.hits);
 }
@@ -10,35 +10,60 @@
 
 #pragma once
 
-#define TEX_ALIGNMENT (32)
-
 #include <stdint.h>
 
-/* 1mb buffer */
-#define TEXMAN_BUFFER_SIZE (2 * 1024 * 1024)
+#include "ui/dc/pvr_texture.h"
+
+/* Theme, font and shared textures. Each is loaded once per filename and kept
+ * until nothing references it and the memory is wanted, so assets every UI
+ * uses survive UI and theme switches and only what changed is reloaded. */
+
+/* What theme textures may hold before they are the first to be evicted */
+#define TEXMAN_BUDGET       (2 * 1024 * 1024)
+/* Unreferenced textures kept around for the next UI or theme on top of that */
+#define TEXMAN_CACHE_BUDGET (1024 * 1024)
+#define TEXMAN_MAX_TEXTURES (48)
+#define TEXMAN_KEY_LEN      (48)
+
+/* Slot in the low byte, generation above it. A freed slot bumps its
+ * generation so old handles stop resolving, 0 is never a texture. */
+typedef uint32_t texman_handle;
 
-struct Simple_Texture {
-    unsigned char* location;
-    int width, height;
-};
+typedef struct texman_stats {
+    uint32_t used;   /* vram bytes */
+    uint32_t cached; /* of which nothing references */
+    int textures;
+    int referenced;
+    unsigned int loads, hits;
+} texman_stats;
 
 /* used for initialization */
-int texman_inited(void);
-void texman_reset(void* buf, uint32_t size);
-void texman_set_buffer(void* buf, uint32_t size);
-
-/* management funcs for clients
-Steps:
-1. create
-2. reserve memory & upload by pointer OR upload_swizzle
-
-note: texture will be bound
-*/
-uint32_t texman_create(void);
+void texman_init(void);
+
+/* Takes a reference to filename, loading it if it isn't resident. Fills img,
+ * which stays valid until the reference is released. Returns 0 and fills img
+ * with the missing texture if it can't be loaded. */
+texman_handle texman_acquire(const char* filename, image* img);
+texman_handle texman_retain(texman_handle handle);
+void texman_release(texman_handle handle);
+/* NULL once the handle is stale */
+const image* texman_get(texman_handle handle);
+
+/* Same as acquire, for the UI being set up. texman_clear releases all of them
+ * so the next UI only keeps what it asks for again. */
+texman_handle texman_load(const char* filename, image* img);
+/* Same for a PVR file already read into memory, kept under key as if it had
+ * been loaded from there */
+texman_handle texman_load_buffer(const char* key, const void* pvr, image* img);
+/* Same if key is still resident, otherwise returns 0 and leaves img alone */
+texman_handle texman_load_resident(const char* key, image* img);
 void texman_clear(void);
-int texman_get_space_available(void);
-int texman_is_space_available(void);
-unsigned char* texman_get_tex_data(uint32_t num);
-struct Simple_Texture* texman_reserve_memory(uint32_t width, uint32_t height, int bpp);
-void texman_upload(uint32_t width, uint32_t height, int bpp, const void* buffer);
-void texman_bind_tex(uint32_t num);
+/* Frees unreferenced textures, longest unused first, down to
+ * TEXMAN_CACHE_BUDGET. What is still referenced becomes the theme's vram
+ * budget, so the cached rest is the first thing art takes back. */
+void texman_trim_cache(void);
+/* vram evict callback, frees the longest unused unreferenced texture */
+int texman_evict(void* user);
+
+void texman_get_stats(texman_stats* stats);
+void texman_print_stats(void);
@@ -10,45 +10,111 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+#include <arch/timer.h>
 #include <dc/pvr.h>
 
 #include <backend/dat_format.h>
+#include <backend/gd_list.h>
+#include "ui/dc/pvr_texture.h"
 #include "ui/draw_kos.h"
 #include "ui/draw_prototypes.h"
 #include "block_pool.h"
+#include "icon_atlas.h"
 #include "lru.h"
+#include "palette_bank.h"
+#include "simple_texture_allocator.h"
+#include "txr_stream.h"
+#include "vram_heap.h"
 #include <texture/serial_sanitize.h>
 
 #include "txr_manager.h"
 
-/* CFG for small pvr pool (128x128 16bit, 16 spaces) */
-#define SM_SLOT_NUM  (16)
-#define SM_SLOT_SIZE (128 * 128 * 2)
-#define SM_POOL_SIZE (SM_SLOT_NUM * SM_SLOT_SIZE * sizeof(char))
+/* CFG for small pvr pool (up to 128x128 16bit, default budget of 16 full
+ * size). VQ art is around 1/6 of that, entries are counted for it and raw art
+ * is held back by the budget instead. */
+#define SM_SLOT_SIZE    (128 * 128 * 2)
+#define SM_POOL_SIZE    (16 * SM_SLOT_SIZE * sizeof(char))
+#define SM_SLOT_RATIO   (4) /* entries per full size of budget */
+#define SM_SLOT_NUM     ((SM_POOL_SIZE / SM_SLOT_SIZE) * SM_SLOT_RATIO)
+#define SM_SLOT_NUM_MAX (256)
 
-/* CFG for large pvr pool (256x256 16bit, 4 spaces) */
-#define LG_SLOT_NUM  (4)
-#define LG_SLOT_SIZE (256 * 256 * 2)
-#define LG_POOL_SIZE (LG_SLOT_NUM * LG_SLOT_SIZE * sizeof(char))
+/* CFG for large pvr pool (up to 256x256 16bit, default budget of 4 full size).
+ * VQ box art is around 1/7 of that. */
+#define LG_SLOT_SIZE    (256 * 256 * 2)
+#define LG_POOL_SIZE    (4 * LG_SLOT_SIZE * sizeof(char))
+#define LG_SLOT_RATIO   (6)
+#define LG_SLOT_NUM     ((LG_POOL_SIZE / LG_SLOT_SIZE) * LG_SLOT_RATIO)
+#define LG_SLOT_NUM_MAX (64)
+
+/* Both pools and the theme scratch share one heap, each may borrow from the others while there is room */
+#define VRAM_HEAP_SIZE (SM_POOL_SIZE + LG_POOL_SIZE + TEXMAN_BUDGET)
+
+/* Remapped art ID and the DAT holding it, empty key until resolved */
+typedef struct art_ref {
+    product_key key;
+    const struct dat_file* source;
+} art_ref;
+
+/* Default prefetch budgets, leaves room for a full page of visible icons */
+#define SM_PREFETCH_BUDGET (4 * SM_SLOT_SIZE)
+#define LG_PREFETCH_BUDGET (2 * LG_SLOT_SIZE)
+
+/* What a slot's prefetch is waiting on, only AHEAD holds budget */
+enum PREFETCH_STATE {
+    PREFETCH_NONE,
+    PREFETCH_AHEAD,  /* queued ahead of the cursor, not asked for yet */
+    PREFETCH_WANTED, /* asked for on screen while still loading */
+};
 
 typedef struct dat_system {
     cache_instance cache;
     block_pool pool;
     struct dat_file addon;
     struct dat_file primary;
+    art_ref* refs; /* per interned product */
+    int num_refs;
+    product_key* slot_keys;    /* per slot, key it was last given to */
+    unsigned char* prefetched; /* per slot, PREFETCH_STATE until first drawn */
+    uint16_t* prefetch_pass;   /* per slot, last prefetch pass that wanted it */
+    uint32_t* request_ms;      /* per slot, when the load was asked for */
+    unsigned int* version;     /* per slot, goes up when its texture lands or leaves */
+    unsigned int prefetch_slots;
+    unsigned int atlas; /* icons go onto atlas pages where they fit */
+    txr_pool_stats* stats;
 } dat_system;
 
 static dat_system icon_system;
 static dat_system box_system;
+static txr_stats stats;
+
+/* Goes up when the pools are emptied or resized, every view looks up again after */
+static unsigned int epoch = 1;
+
+/* Goes up with every prefetch pass over the cursor's window */
+static uint16_t prefetch_pass;
+
+/* Slot a lookup resolved to, or one of these */
+#define TXR_SLOT_NONE  (-1) /* prebuilt or missing art, doesn't change while the pools stay */
+#define TXR_SLOT_RETRY (-2) /* no slot was free, look again next frame */
+
+/* Matches the fixed pools from before UIs declared anything */
+static const txr_working_set default_set = {
+    .icons = 12,
+    .icon_margin = SM_PREFETCH_BUDGET / SM_SLOT_SIZE,
+    .boxes = 2,
+    .box_margin = LG_PREFETCH_BUDGET / LG_SLOT_SIZE,
+};
+static txr_working_set working_set = default_set;
 
 unsigned int
 block_pool_add_cb(const char* key, void* user) {
     /* unused here but could be good info to know */
     (void)key;
 
-    block_pool* pool = (block_pool*)user;
+    block_pool* pool = &((dat_system*)user)->pool;
     unsigned int ret;
     char* ptr;
     pool_get_next_free(pool, &ret, (void**)&ptr);
@@ -60,9 +126,34 @@ block_pool_del_cb(const char* key, void* value, void* user) {
     /* unused here but could be good info to know */
     (void)key;
 
-    block_pool* pool = (block_pool*)user;
+    dat_system* system = (dat_system*)user;
     unsigned int slot_num = *(unsigned int*)value;
-    pool_dealloc_slot(pool, slot_num);
+    if (pool_slot_loading(&system->pool, slot_num)) {
+        txr_stream_cancel_slot(&system->pool, slot_num);
+    }
+    pool_dealloc_slot(&system->pool, slot_num);
+    system->version[slot_num]++;
+    return 0;
+}
+
+/* The heap asks for one texture back at a time, oldest first */
+static int
+txr_evict_cb(void* user) {
+    dat_system* system = (dat_system*)user;
+    return evict_from_cache(&system->cache);
+}
+
+int
+txr_create_heap(void) {
+    if (vram_heap_init(pvr_mem_malloc(VRAM_HEAP_SIZE), VRAM_HEAP_SIZE)) {
+        return 1;
+    }
+    palette_bank_init();
+    icon_atlas_init(ATLAS_PAGE_SIZE);
+    /* Box art is the first to give memory back, theme textures only give up what no UI is using */
+    vram_client_set(VRAM_CLIENT_ICON, SM_POOL_SIZE, 1, txr_evict_cb, &icon_system);
+    vram_client_set(VRAM_CLIENT_BOX, LG_POOL_SIZE, 0, txr_evict_cb, &box_system);
+    vram_client_set(VRAM_CLIENT_THEME, TEXMAN_BUDGET, 2, texman_evict, NULL);
     return 0;
 }
 
@@ -80,19 +171,58 @@ txr_load_DATs(void) {
     DAT_load_parse(&icon_system.addon, "ICON_EX.DAT");
     DAT_load_parse(&box_system.addon, "BOX_EX.DAT");
 
+    /* Without the worker every load is done inline */
+    txr_stream_init();
+
+    /* Pages packed ahead of time stay resident */
+    icon_atlas_load_prebuilt();
+
+    return 0;
+}
+
+static void
+txr_free_slot_info(dat_system* system) {
+    free(system->slot_keys);
+    free(system->prefetched);
+    free(system->prefetch_pass);
+    free(system->request_ms);
+    free(system->version);
+    system->slot_keys = NULL;
+    system->prefetched = NULL;
+    system->prefetch_pass = NULL;
+    system->request_ms = NULL;
+    system->version = NULL;
+}
+
+static int
+txr_alloc_slot_info(dat_system* system, unsigned int slots) {
+    system->slot_keys = calloc(slots, sizeof(product_key));
+    system->prefetched = calloc(slots, sizeof(unsigned char));
+    system->prefetch_pass = calloc(slots, sizeof(uint16_t));
+    system->request_ms = calloc(slots, sizeof(uint32_t));
+    system->version = calloc(slots, sizeof(unsigned int));
+    if (!system->slot_keys || !system->prefetched || !system->prefetch_pass || !system->request_ms
+        || !system->version) {
+        printf("%s no free memory\n", __func__);
+        return 1;
+    }
     return 0;
 }
 
 int
 txr_create_small_pool(void) {
-    void* buffer = pvr_mem_malloc(SM_POOL_SIZE);
-    pool_create(&icon_system.pool, buffer, SM_POOL_SIZE, SM_SLOT_NUM);
-    icon_system.cache.cache = NULL;
+    pool_create(&icon_system.pool, VRAM_CLIENT_ICON, SM_SLOT_NUM);
     cache_set_size(&icon_system.cache, SM_SLOT_NUM);
-    cache_callback_userdata(&icon_system.cache, &icon_system.pool);
+    cache_callback_userdata(&icon_system.cache, &icon_system);
     cache_callback_add(&icon_system.cache, block_pool_add_cb);
     cache_callback_del(&icon_system.cache, block_pool_del_cb);
 
+    if (txr_alloc_slot_info(&icon_system, SM_SLOT_NUM)) {
+        return 1;
+    }
+    icon_system.prefetch_slots = SM_PREFETCH_BUDGET / SM_SLOT_SIZE;
+    icon_system.stats = &stats.icon;
+
     return 0;
 }
 
@@ -100,69 +230,432 @@ txr_create_small_pool(void) {
 
 int
 txr_create_large_pool(void) {
-    void* buffer = pvr_mem_malloc(LG_POOL_SIZE);
-    pool_create(&box_system.pool, buffer, LG_POOL_SIZE, LG_SLOT_NUM);
-    box_system.cache.cache = NULL;
+    pool_create(&box_system.pool, VRAM_CLIENT_BOX, LG_SLOT_NUM);
     cache_set_size(&box_system.cache, LG_SLOT_NUM);
-    cache_callback_userdata(&box_system.cache, &box_system.pool);
+    cache_callback_userdata(&box_system.cache, &box_system);
     cache_callback_add(&box_system.cache, block_pool_add_cb);
     cache_callback_del(&box_system.cache, block_pool_del_cb);
+
+    if (txr_alloc_slot_info(&box_system, LG_SLOT_NUM)) {
+        return 1;
+    }
+    box_system.prefetch_slots = LG_PREFETCH_BUDGET / LG_SLOT_SIZE;
+    box_system.stats = &stats.box;
     return 0;
 }
 
 void
 txr_empty_small_pool(void) {
+    txr_stream_cancel_pool(&icon_system.pool);
     empty_cache(&icon_system.cache);
     pool_dealloc_all(&icon_system.pool);
+    epoch++;
 }
 
 void
 txr_empty_large_pool(void) {
+    txr_stream_cancel_pool(&box_system.pool);
     empty_cache(&box_system.cache);
     pool_dealloc_all(&box_system.pool);
+    epoch++;
 }
 
+void
+txr_set_working_set(const txr_working_set* set) {
+    working_set = *set;
+}
+
+/* Only while the pool is empty, nothing queued may refer to the old slots */
 static int
-txr_get_from_dat_set(const char* id, struct image* img, dat_system* system) {
-    void* txr_ptr;
-    int slot_num;
-    const char* id_santized = serial_santize_art(id);
+txr_resize_system(dat_system* system, unsigned int slots) {
+    const int client = system->pool.client;
+
+    if (system->pool.slots == slots) {
+        return 0;
+    }
+    pool_destroy(&system->pool);
+    pool_create(&system->pool, client, slots);
+    cache_set_size(&system->cache, slots);
+    txr_free_slot_info(system);
+    return txr_alloc_slot_info(system, slots);
+}
+
+static unsigned int
+txr_slots_for_budget(uint32_t budget, uint32_t slot_size, unsigned int ratio, unsigned int min, unsigned int max) {
+    unsigned int slots = (budget / slot_size) * ratio;
+    if (slots < min) {
+        slots = min;
+    }
+    return (slots > max) ? max : slots;
+}
+
+void
+txr_apply_working_set(void) {
+    const unsigned int icons = working_set.icons + working_set.icon_margin;
+    const unsigned int boxes = working_set.boxes + working_set.box_margin;
+    const uint32_t icon_need = icons * SM_SLOT_SIZE;
+    const uint32_t box_need = boxes * LG_SLOT_SIZE;
+    uint32_t icon_budget = SM_POOL_SIZE;
+    uint32_t box_budget = LG_POOL_SIZE;
+    vram_stats vram;
+
+    txr_empty_small_pool();
+    txr_empty_large_pool();
+
+    /* Everything the theme left is shared out in proportion to the set, so a
+     * short fall is shared the same way. The theme's budget is only what the
+     * UI references, textures cached past that are given up on demand. */
+    vram_get_stats(&vram);
+    if (icon_need + box_need) {
+        const uint32_t free_bytes = vram.total - vram.client_budget[VRAM_CLIENT_THEME];
+        icon_budget = (uint32_t)((uint64_t)free_bytes * icon_need / (icon_need + box_need));
+        box_budget = free_bytes - icon_budget;
+    }
+    vram_client_set_budget(VRAM_CLIENT_ICON, icon_budget);
+    vram_client_set_budget(VRAM_CLIENT_BOX, box_budget);
+
+    if (txr_resize_system(&icon_system,
+                          txr_slots_for_budget(icon_budget, SM_SLOT_SIZE, SM_SLOT_RATIO, icons, SM_SLOT_NUM_MAX))
+        || txr_resize_system(&box_system,
+                             txr_slots_for_budget(box_budget, LG_SLOT_SIZE, LG_SLOT_RATIO, boxes, LG_SLOT_NUM_MAX))) {
+        return;
+    }
+    icon_system.prefetch_slots = working_set.icon_margin;
+    box_system.prefetch_slots = working_set.box_margin;
+    icon_system.atlas = working_set.atlas;
+    epoch++;
+
+    printf("TXR: icons %u entries %u KB, boxes %u entries %u KB\n", icon_system.pool.slots,
+           (unsigned int)icon_budget / 1024, box_system.pool.slots, (unsigned int)box_budget / 1024);
+
+    /* The next UI has to declare its own */
+    working_set = default_set;
+}
+
+static void
+txr_resolve_art(const char* id, dat_system* system, art_ref* ref) {
+    product_key key;
+    product_key_make(&key, id);
+    ref->key = *serial_santize_art_key(&key);
 
     /* Initially check addon then fall back to regular */
-    uint32_t temp_offset = DAT_get_offset_by_ID(&system->addon, id_santized);
-    const dat_file* dat_source = &system->addon;
-    if (!temp_offset) {
-        temp_offset = DAT_get_offset_by_ID(&system->primary, id_santized);
-        dat_source = &system->primary;
-        if (!temp_offset) {
-            dat_source = NULL;
+    if (DAT_get_offset_by_key(&system->addon, &ref->key)) {
+        ref->source = &system->addon;
+    } else if (DAT_get_offset_by_key(&system->primary, &ref->key)) {
+        ref->source = &system->primary;
+    } else {
+        ref->source = NULL;
+    }
+}
+
+/* Products from the game list resolve once, anything else every call */
+static const art_ref*
+txr_get_art_ref(const char* id, dat_system* system, art_ref* scratch) {
+    int product_num = list_product_find(id);
+
+    if (product_num != LIST_PRODUCT_NONE && system->num_refs != list_products_length()) {
+        free(system->refs);
+        system->num_refs = list_products_length();
+        system->refs = calloc(system->num_refs, sizeof(art_ref));
+        if (!system->refs) {
+            printf("%s no free memory\n", __func__);
+            system->num_refs = 0;
         }
     }
 
+    if (product_num == LIST_PRODUCT_NONE || !system->refs) {
+        txr_resolve_art(id, system, scratch);
+        return scratch;
+    }
+
+    art_ref* ref = &system->refs[product_num];
+    if (product_key_empty(&ref->key)) {
+        txr_resolve_art(id, system, ref);
+    }
+    return ref;
+}
+
+static void
+txr_note_load(dat_system* system, unsigned int slot_num, const pvr_stream* stream) {
+    txr_pool_stats* pool_stats = system->stats;
+    uint32_t elapsed = (uint32_t)timer_ms_gettime64() - system->request_ms[slot_num];
+    int bucket = 0;
+
+    pool_stats->loads++;
+    if (!stream) {
+        pool_stats->failed_loads++;
+        return;
+    }
+    pool_stats->bytes_read += stream->read;
+    while (bucket < TXR_LATENCY_BUCKETS - 1 && elapsed >= (16u << bucket)) {
+        bucket++;
+    }
+    pool_stats->latency[bucket]++;
+}
+
+/* Square textures that aren't VQ can share a page, NULL if this one can't.
+ * Pages match on the palette bank too, a texture no other one shares its bank
+ * with only joins a page already open instead of taking a new one to itself. */
+static void*
+txr_place_atlas(dat_system* system, unsigned int slot_num, const pvr_stream* stream, uint32_t format, int bank,
+                pvr_stream_dest* dest) {
+    const int open = bank == PALETTE_NONE || palette_bank_shared(bank);
+    uint32_t page_size, x, y;
+    void* page;
+
+    if (format & PVR_TXRFMT_VQ_ENABLE) {
+        return NULL;
+    }
+    if (!(page = pool_alloc_slot_atlas(&system->pool, slot_num, format, stream->width, open))) {
+        return NULL;
+    }
+    icon_atlas_cell_page(pool_get_slot_cell(&system->pool, slot_num), &page_size, &x, &y);
+    return pvr_stream_dest_page(stream, page, page_size, x, y, dest) ? page : NULL;
+}
+
+/* Gets the slot exactly as much vram as the texture needs once its header is
+ * in, the data follows as it is read */
+static int
+txr_slot_place(void* user, unsigned int slot_num, const pvr_stream* stream, pvr_stream_dest* dest) {
+    dat_system* system = (dat_system*)user;
+    uint32_t format = stream->format;
+    void* txr_ptr = NULL;
+    int bank = PALETTE_NONE;
+
+    if (stream->palette_count) {
+        bank = palette_bank_acquire(stream->palette, stream->palette_count);
+        if (bank == PALETTE_NONE) {
+            return 0;
+        }
+    }
+    format |= palette_bank_txrfmt(bank);
+    if (system->atlas && stream->width == stream->height) {
+        txr_ptr = txr_place_atlas(system, slot_num, stream, format, bank, dest);
+    }
+    /* Anything the atlas didn't take gets a texture of its own */
+    if (!txr_ptr && (txr_ptr = pool_alloc_slot_vram(&system->pool, slot_num, stream->size))) {
+        pvr_stream_dest_buffer(stream, txr_ptr, dest);
+    }
+    if (!txr_ptr) {
+        palette_bank_release(bank);
+        return 0;
+    }
+    pool_set_slot_palette(&system->pool, slot_num, bank);
+    pool_set_slot_format(&system->pool, slot_num, stream->width, stream->height, format);
+    return 1;
+}
+
+/* A failed read or a full heap leaves the slot empty and the missing image is
+ * drawn instead. In flight slots stay pinned until their texture lands. */
+static void
+txr_slot_done(void* user, unsigned int slot_num, const pvr_stream* stream) {
+    dat_system* system = (dat_system*)user;
+
+    txr_note_load(system, slot_num, stream);
+    if (!stream || !pool_get_slot_addr(&system->pool, slot_num)) {
+        pool_release_slot_texture(&system->pool, slot_num);
+        pool_set_slot_format(&system->pool, slot_num, 0, 0, 0);
+    }
+    pool_mark_slot_ready(&system->pool, slot_num);
+    unpin_in_cache(&system->cache, &system->slot_keys[slot_num]);
+    system->version[slot_num]++;
+}
+
+static const txr_stream_ops slot_ops = {
+    .place = txr_slot_place,
+    .done = txr_slot_done,
+};
+
+static void
+txr_get_from_slot(struct image* img, const block_pool* pool, int slot_num) {
+    const slot_format* fmt = pool_get_slot_format(pool, slot_num);
+    img->width = fmt->width;
+    img->height = fmt->height;
+    img->format = fmt->format;
+    img->texture = pool_get_slot_addr(pool, slot_num);
+    img->atlas_x = img->atlas_y = img->atlas_size = 0;
+    if (pool_get_slot_cell(pool, slot_num) != ATLAS_CELL_NONE) {
+        uint32_t page_size, x, y;
+        icon_atlas_cell_page(pool_get_slot_cell(pool, slot_num), &page_size, &x, &y);
+        img->atlas_x = (uint16_t)x;
+        img->atlas_y = (uint16_t)y;
+        img->atlas_size = (uint16_t)page_size;
+    }
+}
+
+/* Icons on a prebuilt page never go through the cache */
+static int
+txr_prebuilt(const dat_system* system, const art_ref* ref, struct image* img) {
+    return system == &icon_system && icon_atlas_find(&ref->key, img);
+}
+
+static void
+txr_slot_assign(dat_system* system, unsigned int slot_num, const art_ref* ref, int prefetched) {
+    system->slot_keys[slot_num] = ref->key;
+    system->prefetched[slot_num] = (unsigned char)prefetched;
+    system->request_ms[slot_num] = (uint32_t)timer_ms_gettime64();
+}
+
+/* Returns the slot the image came from, TXR_SLOT_NONE or TXR_SLOT_RETRY */
+static int
+txr_lookup(const char* id, struct image* img, dat_system* system) {
+    int slot_num;
+    art_ref scratch;
+    const art_ref* ref = txr_get_art_ref(id, system, &scratch);
+
+    if (txr_prebuilt(system, ref, img)) {
+        system->stats->hits++;
+        return TXR_SLOT_NONE;
+    }
+
     /* check if exists in DAT and if not, return missing image */
-    if (!dat_source) {
+    if (!ref->source) {
         draw_load_missing_icon(img);
-        return 0;
+        return TXR_SLOT_NONE;
     }
-    slot_num = find_in_cache(&system->cache, id_santized);
+    slot_num = find_in_cache(&system->cache, &ref->key);
     if (slot_num == -1) {
-        add_to_cache(&system->cache, id_santized, 0);
-        slot_num = find_in_cache(&system->cache, id_santized);
-        txr_ptr = pool_get_slot_addr(&system->pool, slot_num);
+        system->stats->misses++;
+        slot_num = add_to_cache(&system->cache, &ref->key, 0);
+        if (slot_num == -1) {
+            /* every slot is still loading, try again next frame */
+            draw_load_missing_icon(img);
+            return TXR_SLOT_RETRY;
+        }
+        txr_slot_assign(system, slot_num, ref, PREFETCH_NONE);
 
-        /* now load the texture into vram */
-        draw_load_texture_from_DAT_to_buffer(dat_source, id_santized, img, txr_ptr);
-        pool_set_slot_format(&system->pool, slot_num, img->width, img->height, img->format);
+        /* hand it to the worker, the missing image stands in until it lands */
+        pool_mark_slot_loading(&system->pool, slot_num);
+        pin_in_cache(&system->cache, &ref->key);
+        const uint32_t chunk_num = DAT_get_index_by_key(ref->source, &ref->key);
+        if (!txr_stream_request(ref->source, chunk_num, &system->pool, slot_num, &slot_ops, system)) {
+            draw_load_missing_icon(img);
+            return slot_num;
+        }
+
+        /* queue is full, load into vram now, pinned so making room can't evict it */
+        txr_stream_load_now(ref->source, chunk_num, slot_num, &slot_ops, system);
+        if (pool_get_slot_format(&system->pool, slot_num)->width) {
+            txr_get_from_slot(img, &system->pool, slot_num);
+        } else {
+            draw_load_missing_icon(img);
+        }
+    } else if (pool_slot_loading(&system->pool, slot_num) || !pool_get_slot_format(&system->pool, slot_num)->width) {
+        /* still in flight or the read failed */
+        system->stats->pending++;
+        if (system->prefetched[slot_num] == PREFETCH_AHEAD) {
+            system->prefetched[slot_num] = PREFETCH_WANTED;
+        }
+        draw_load_missing_icon(img);
     } else {
-        const slot_format* fmt = pool_get_slot_format(&system->pool, slot_num);
-        img->width = fmt->width;
-        img->height = fmt->height;
-        img->format = fmt->format;
-        img->texture = pool_get_slot_addr(&system->pool, slot_num);
+        system->stats->hits++;
+        if (system->prefetched[slot_num] != PREFETCH_NONE) {
+            system->prefetched[slot_num] = PREFETCH_NONE;
+            stats.prefetch_used++;
+        }
+        txr_get_from_slot(img, &system->pool, slot_num);
     }
+    return slot_num;
+}
+
+static int
+txr_get_from_dat_set(const char* id, struct image* img, dat_system* system) {
+    txr_lookup(id, img, system);
     return 0;
 }
 
+static unsigned int
+txr_prefetch_outstanding(const dat_system* system) {
+    unsigned int count = 0;
+    for (unsigned int i = 0; i < system->pool.slots; i++) {
+        if (system->prefetched[i] == PREFETCH_AHEAD && system->pool.state[i] != POOL_SLOT_OPEN) {
+            count++;
+        }
+    }
+    return count;
+}
+
+/* Landed prefetches stay cached but stop holding budget, all of them or just
+ * the ones this pass didn't ask for again */
+static void
+txr_prefetch_release_set(dat_system* system, int all) {
+    for (unsigned int i = 0; i < system->pool.slots; i++) {
+        if (system->prefetched[i] == PREFETCH_AHEAD && !pool_slot_loading(&system->pool, i)
+            && (all || system->prefetch_pass[i] != prefetch_pass)) {
+            system->prefetched[i] = PREFETCH_NONE;
+        }
+    }
+}
+
+/* Like txr_get_from_dat_set but never loads inline and never pushes out more
+ * than the budget of not yet drawn slots */
+static int
+txr_prefetch_from_dat_set(const char* id, dat_system* system) {
+    int slot_num;
+    art_ref scratch;
+
+    const art_ref* ref = txr_get_art_ref(id, system, &scratch);
+    if (!ref->source || txr_prebuilt(system, ref, NULL)) {
+        return 0;
+    }
+    slot_num = peek_in_cache(&system->cache, &ref->key);
+    if (slot_num != -1) {
+        system->prefetch_pass[slot_num] = prefetch_pass;
+        return 0;
+    }
+
+    /* art that landed for an earlier window makes way for this one */
+    if (txr_prefetch_outstanding(system) >= system->prefetch_slots) {
+        txr_prefetch_release_set(system, 0);
+        if (txr_prefetch_outstanding(system) >= system->prefetch_slots) {
+            return -1;
+        }
+    }
+
+    slot_num = add_to_cache(&system->cache, &ref->key, 0);
+    if (slot_num == -1) {
+        return -1;
+    }
+    txr_slot_assign(system, slot_num, ref, PREFETCH_AHEAD);
+    system->prefetch_pass[slot_num] = prefetch_pass;
+
+    pool_mark_slot_loading(&system->pool, slot_num);
+    if (txr_stream_request(ref->source, DAT_get_index_by_key(ref->source, &ref->key), &system->pool, slot_num,
+                           &slot_ops, system)) {
+        remove_from_cache(&system->cache, &ref->key);
+        return -1;
+    }
+    pin_in_cache(&system->cache, &ref->key);
+    stats.prefetch_issued++;
+    return 1;
+}
+
+static void
+txr_prefetch_cancel_set(dat_system* system) {
+    for (unsigned int i = 0; i < system->pool.slots; i++) {
+        if (system->prefetched[i] == PREFETCH_AHEAD && pool_slot_loading(&system->pool, i)) {
+            system->prefetched[i] = PREFETCH_NONE;
+            remove_from_cache(&system->cache, &system->slot_keys[i]);
+            stats.prefetch_cancelled++;
+        }
+    }
+}
+
+/* 1 if ready in vram, 0 if not (yet), -1 if there is no art at all */
+static int
+txr_resident(const char* id, dat_system* system) {
+    art_ref scratch;
+    const art_ref* ref = txr_get_art_ref(id, system, &scratch);
+    if (txr_prebuilt(system, ref, NULL)) {
+        return 1;
+    }
+    if (!ref->source) {
+        return -1;
+    }
+    int slot_num = peek_in_cache(&system->cache, &ref->key);
+    return slot_num != -1 && !pool_slot_loading(&system->pool, slot_num);
+}
+
 /*
 called with "T1121.pvr" and a pointer to pointer to vram
 returns pointer to use for texture upload/reference
@@ -176,3 +669,156 @@ int
 txr_get_large(const char* id, struct image* img) {
     return txr_get_from_dat_set(id, img, &box_system);
 }
+
+/* Drops the pin a view entry holds on its slot. Emptying the pools already
+ * dropped every pin, and a slot dealloced since is another entry's now. */
+static void
+txr_view_unpin(const txr_view_entry* entry) {
+    dat_system* system = (dat_system*)entry->system;
+
+    if (entry->epoch != epoch || entry->slot < 0
+        || pool_get_slot_generation(&system->pool, entry->slot) != entry->generation) {
+        return;
+    }
+    unpin_in_cache(&system->cache, &system->slot_keys[entry->slot]);
+}
+
+/* Art on screen stays pinned by its view position so nothing can evict it */
+static void
+txr_view_get(txr_view* view, int pos, const char* id, struct image* img, dat_system* system) {
+    if (pos < 0 || pos >= TXR_VIEW_MAX) {
+        txr_get_from_dat_set(id, img, system);
+        return;
+    }
+
+    txr_view_entry* entry = &view->entries[pos];
+    if (entry->epoch != epoch || entry->system != system || strncmp(entry->id, id, sizeof(entry->id))
+        || entry->slot == TXR_SLOT_RETRY || (entry->slot >= 0 && entry->version != system->version[entry->slot])) {
+        txr_view_unpin(entry);
+        strncpy(entry->id, id, sizeof(entry->id));
+        entry->system = system;
+        entry->epoch = epoch;
+        entry->slot = txr_lookup(id, &entry->img, system);
+        /* Taken after, a load it finished inline is already in the image */
+        if (entry->slot >= 0) {
+            entry->version = system->version[entry->slot];
+            entry->generation = pool_get_slot_generation(&system->pool, entry->slot);
+            pin_in_cache(&system->cache, &system->slot_keys[entry->slot]);
+        }
+    }
+    *img = entry->img;
+}
+
+void
+txr_view_small(txr_view* view, int pos, const char* id, struct image* img) {
+    txr_view_get(view, pos, id, img, &icon_system);
+}
+
+void
+txr_view_large(txr_view* view, int pos, const char* id, struct image* img) {
+    txr_view_get(view, pos, id, img, &box_system);
+}
+
+int
+txr_prefetch_small(const char* id) {
+    return txr_prefetch_from_dat_set(id, &icon_system);
+}
+
+int
+txr_prefetch_large(const char* id) {
+    return txr_prefetch_from_dat_set(id, &box_system);
+}
+
+void
+txr_prefetch_begin(void) {
+    prefetch_pass++;
+}
+
+void
+txr_prefetch_cancel(void) {
+    txr_prefetch_cancel_set(&icon_system);
+    txr_prefetch_cancel_set(&box_system);
+    txr_prefetch_release_set(&icon_system, 1);
+    txr_prefetch_release_set(&box_system, 1);
+}
+
+void
+txr_set_prefetch_budget(unsigned int small_bytes, unsigned int large_bytes) {
+    icon_system.prefetch_slots = small_bytes / SM_SLOT_SIZE;
+    box_system.prefetch_slots = large_bytes / LG_SLOT_SIZE;
+}
+
+void
+txr_note_landing(const char* id) {
+    int resident;
+
+    stats.landings++;
+    resident = txr_resident(id, &icon_system);
+    if (resident != -1) {
+        stats.landing_icons++;
+        stats.landing_icon_hits += resident;
+    }
+    resident = txr_resident(id, &box_system);
+    if (resident != -1) {
+        stats.landing_boxes++;
+        stats.landing_box_hits += resident;
+    }
+}
+
+static void
+txr_fill_pool_stats(const dat_system* system, const vram_stats* vram, int client) {
+    txr_pool_stats* pool_stats = system->stats;
+
+    pool_stats->in_flight = 0;
+    for (unsigned int i = 0; i < system->pool.slots; i++) {
+        pool_stats->in_flight += pool_slot_loading(&system->pool, i);
+    }
+    pool_stats->evictions = system->cache.evictions;
+    pool_stats->resident = system->cache.count;
+    pool_stats->entries = system->cache.cache_max_size;
+    pool_stats->vram_used = vram->client_used[client];
+    pool_stats->vram_budget = vram->client_budget[client];
+}
+
+const txr_stats*
+txr_get_stats(void) {
+    vram_stats vram;
+    vram_get_stats(&vram);
+    txr_fill_pool_stats(&icon_system, &vram, VRAM_CLIENT_ICON);
+    txr_fill_pool_stats(&box_system, &vram, VRAM_CLIENT_BOX);
+    stats.atlas_pages = icon_atlas_pages();
+    return &stats;
+}
+
+static void
+txr_print_pool_stats(const char* name, const txr_pool_stats* pool_stats) {
+    const unsigned int lookups = pool_stats->hits + pool_stats->misses + pool_stats->pending;
+
+    printf("TXR: %s %u/%u entries, %u/%u KB vram, %u in flight\n", name, pool_stats->resident, pool_stats->entries,
+           (unsigned int)pool_stats->vram_used / 1024, (unsigned int)pool_stats->vram_budget / 1024,
+           pool_stats->in_flight);
+    printf("TXR:   %u hits %u misses %u pending (%u%%), %u evictions, %u loads (%u failed), %u KB read\n",
+           pool_stats->hits, pool_stats->misses, pool_stats->pending, lookups ? pool_stats->hits * 100 / lookups : 0,
+           pool_stats->evictions, pool_stats->loads, pool_stats->failed_loads,
+           (unsigned int)pool_stats->bytes_read / 1024);
+    printf("TXR:   latency");
+    for (int i = 0; i < TXR_LATENCY_BUCKETS; i++) {
+        if (i < TXR_LATENCY_BUCKETS - 1) {
+            printf(" <%ums:%u", 16u << i, pool_stats->latency[i]);
+        } else {
+            printf(" more:%u", pool_stats->latency[i]);
+        }
+    }
+    printf("\n");
+}
+
+void
+txr_print_stats(void) {
+    txr_get_stats();
+    txr_print_pool_stats("icon", &stats.icon);
+    txr_print_pool_stats("box", &stats.box);
+    printf("TXR: prefetch %u issued %u used %u cancelled, landings %u icon %u/%u box %u/%u\n", stats.prefetch_issued,
+           stats.prefetch_used, stats.prefetch_cancelled, stats.landings, stats.landing_icon_hits, stats.landing_icons,
+           stats.landing_box_hits, stats.landing_boxes);
+    vram_print_stats();
+}
@@ -10,14 +10,103 @@
 
 #pragma once
 
-struct image;
+#include <stdint.h>
 
+#include "ui/dc/pvr_texture.h"
+
+/* Load latency from request to upload, bucket i is under 16ms << i */
+#define TXR_LATENCY_BUCKETS (8)
+
+typedef struct txr_pool_stats {
+    unsigned int hits;    /* lookups, whenever a view or a direct get asks, that found art in vram */
+    unsigned int misses;  /* ...that had to be loaded */
+    unsigned int pending; /* ...that found it still loading or failed to load */
+    unsigned int evictions;
+    unsigned int loads;
+    unsigned int failed_loads;
+    uint32_t bytes_read;
+    unsigned int latency[TXR_LATENCY_BUCKETS];
+    /* current, filled in by txr_get_stats */
+    unsigned int in_flight;
+    unsigned int resident;
+    unsigned int entries;
+    uint32_t vram_used;
+    uint32_t vram_budget;
+} txr_pool_stats;
+
+typedef struct txr_stats {
+    txr_pool_stats icon;
+    txr_pool_stats box;
+    unsigned int landings;          /* focus moved onto an item */
+    unsigned int landing_icons;     /* ...that has an icon */
+    unsigned int landing_icon_hits; /* ...already in vram */
+    unsigned int landing_boxes;
+    unsigned int landing_box_hits;
+    unsigned int prefetch_issued;
+    unsigned int prefetch_used;
+    unsigned int prefetch_cancelled;
+    unsigned int atlas_pages; /* current */
+} txr_stats;
+
+int txr_create_heap(void);
 int txr_create_small_pool(void);
 int txr_create_large_pool(void);
 void txr_empty_small_pool(void);
 void txr_empty_large_pool(void);
 
+/* Art a UI keeps on screen at once plus what its prefetch runs ahead with,
+ * declared from the UI's init. Margins are in full size textures. */
+typedef struct txr_working_set {
+    unsigned int icons;
+    unsigned int icon_margin;
+    unsigned int boxes;
+    unsigned int box_margin;
+    unsigned int atlas; /* pack icons onto shared pages, for UIs drawing many at once */
+} txr_working_set;
+
+void txr_set_working_set(const txr_working_set* set);
+/* Resizes both pools for the declared set from the VRAM the theme left free,
+ * empties them first. UIs that declared nothing get the default set. */
+void txr_apply_working_set(void);
+
 int txr_load_DATs(void); /* Loads our DAT files full of images */
 
 int txr_get_small(const char* id, struct image* img);
 int txr_get_large(const char* id, struct image* img);
+
+/* Art a UI has on screen by position. A position is only looked up again when
+ * the id there changes, its own slot's texture landed or left since, or the
+ * pools were emptied. Frames in between get the image it resolved to last time.
+ * Each position pins its slot until then, so the working set has to cover
+ * every position a UI draws. */
+#define TXR_VIEW_MAX (16)
+
+typedef struct txr_view_entry {
+    char id[12];
+    const void* system;   /* pool it was resolved from */
+    unsigned int epoch;   /* 0 until resolved */
+    int slot;             /* slot the image came from, negative for none */
+    unsigned int version; /* ...and how far along that slot was */
+    uint16_t generation;  /* ...and the pool generation it was pinned in */
+    struct image img;
+} txr_view_entry;
+
+typedef struct txr_view {
+    txr_view_entry entries[TXR_VIEW_MAX];
+} txr_view;
+
+void txr_view_small(txr_view* view, int pos, const char* id, struct image* img);
+void txr_view_large(txr_view* view, int pos, const char* id, struct image* img);
+
+/* Queue art ahead of time, 1 if a request went out, 0 if there was nothing to
+ * do, -1 when over budget or the queue is full. A pass over the window starts
+ * with txr_prefetch_begin, art that landed for an older one gives up its budget */
+void txr_prefetch_begin(void);
+int txr_prefetch_small(const char* id);
+int txr_prefetch_large(const char* id);
+void txr_prefetch_cancel(void); /* drops prefetches in flight, frees the budget of landed ones */
+void txr_set_prefetch_budget(unsigned int small_bytes, unsigned int large_bytes);
+
+void txr_note_landing(const char* id);
+const txr_stats* txr_get_stats(void);
+void txr_print_stats(void);
@@ -0,0 +1,158 @@
+/*
+ * File: txr_prefetch.c
+ * Project: texture
+ * File Created: Sunday, 18th October 2026 5:11:48 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License,
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ */
+
+#include <backend/gd_item.h>
+#include <backend/gd_list.h>
+#include "txr_manager.h"
+
+#include "txr_prefetch.h"
+
+/* Frames per cursor step, at or below FAST the input is auto repeating */
+#define PREFETCH_FAST_FRAMES (12)
+#define PREFETCH_SLOW_FRAMES (30)
+#define PREFETCH_IDLE_FRAMES (120)
+
+/* Box art ahead of the cursor when it is moving slowly */
+#define PREFETCH_BOX_AHEAD (3)
+
+/* New requests per frame, visible misses always go ahead of these */
+#define PREFETCH_PER_FRAME (2)
+
+enum PREFETCH_SPEED {
+    SPEED_FAST,
+    SPEED_NORMAL,
+    SPEED_SLOW,
+};
+
+static int last_selected = -1;
+static int last_length = 0;
+static int direction = 1;
+static int dirty = 0;
+static enum PREFETCH_SPEED last_speed = SPEED_SLOW;
+static unsigned int frame = 0;
+static unsigned int last_change_frame = 0;
+static unsigned int step_frames = PREFETCH_IDLE_FRAMES;
+
+static inline int
+wrap_index(int idx, int len) {
+    idx %= len;
+    return idx < 0 ? idx + len : idx;
+}
+
+/* Settles back to slow once the cursor stops */
+static enum PREFETCH_SPEED
+current_speed(void) {
+    unsigned int steps = step_frames;
+    if (frame - last_change_frame > steps) {
+        steps = frame - last_change_frame;
+    }
+
+    if (steps <= PREFETCH_FAST_FRAMES) {
+        return SPEED_FAST;
+    }
+    if (steps <= PREFETCH_SLOW_FRAMES) {
+        return SPEED_NORMAL;
+    }
+    return SPEED_SLOW;
+}
+
+static void
+track_cursor(const gd_item** list, int len, int selected) {
+    if (selected == last_selected) {
+        return;
+    }
+
+    if (last_selected != -1) {
+        /* lists wrap around, a jump over half the list went the other way */
+        int delta = selected - last_selected;
+        if (delta > len / 2) {
+            delta -= len;
+        } else if (delta < -len / 2) {
+            delta += len;
+        }
+
+        const int new_direction = (delta < 0) ? -1 : 1;
+        if (new_direction != direction) {
+            txr_prefetch_cancel();
+            direction = new_direction;
+        }
+
+        unsigned int interval = frame - last_change_frame;
+        if (interval > PREFETCH_IDLE_FRAMES) {
+            interval = PREFETCH_IDLE_FRAMES;
+        }
+        step_frames = (step_frames * 3 + interval) / 4;
+    }
+
+    last_selected = selected;
+    last_change_frame = frame;
+    dirty = 1;
+
+    txr_note_landing(list[selected]->product);
+}
+
+void
+txr_prefetch_update(int selected, int first_visible, int num_visible) {
+    const gd_item** list = list_get();
+    const int len = list_length();
+
+    frame++;
+    if (len <= 0 || selected < 0 || selected >= len) {
+        return;
+    }
+
+    if (len != last_length) {
+        last_length = len;
+        last_selected = -1;
+        direction = 1;
+        step_frames = PREFETCH_IDLE_FRAMES;
+    }
+
+    track_cursor(list, len, selected);
+
+    const enum PREFETCH_SPEED speed = current_speed();
+    if (speed != last_speed) {
+        last_speed = speed;
+        dirty = 1;
+    }
+    if (!dirty) {
+        return;
+    }
+
+    /* Fast scrolling skips box art and looks further ahead for icons */
+    int icons = (speed == SPEED_FAST) ? num_visible * 2 : num_visible;
+    int boxes = (speed == SPEED_FAST) ? 0 : (speed == SPEED_NORMAL) ? 1 : PREFETCH_BOX_AHEAD;
+    if (icons > len - num_visible) {
+        icons = len - num_visible;
+    }
+    if (boxes > len - 1) {
+        boxes = len - 1;
+    }
+
+    int issued = 0;
+    int limited = 0;
+
+    txr_prefetch_begin();
+    for (int i = 0; i < icons && !limited; i++) {
+        int idx = (direction > 0) ? first_visible + num_visible + i : first_visible - 1 - i;
+        const int ret = txr_prefetch_small(list[wrap_index(idx, len)]->product);
+        issued += ret > 0;
+        limited = ret < 0 || issued >= PREFETCH_PER_FRAME;
+    }
+    for (int i = 1; i <= boxes && !limited; i++) {
+        const int ret = txr_prefetch_large(list[wrap_index(selected + direction * i, len)]->product);
+        issued += ret > 0;
+        limited = ret < 0 || issued >= PREFETCH_PER_FRAME;
+    }
+
+    /* Over budget or out of requests this frame, carry on next frame */
+    dirty = limited;
+}
@@ -0,0 +1,15 @@
+/*
+ * File: txr_prefetch.h
+ * Project: texture
+ * File Created: Sunday, 18th October 2026 5:11:48 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+
+#pragma once
+
+/* Call once per frame after the UI has drawn its art. selected indexes the
+ * current list, first_visible and num_visible describe the icons on screen. */
+void txr_prefetch_update(int selected, int first_visible, int num_visible);
@@ -0,0 +1,325 @@
+/*
+ * File: txr_stream.c
+ * Project: texture
+ * File Created: Sunday, 18th October 2026 4:02:17 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License,
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ */
+
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <kos/cond.h>
+#include <kos/mutex.h>
+#include <kos/thread.h>
+
+#include <backend/dat_format.h>
+#include "block_pool.h"
+
+#include "txr_stream.h"
+
+/* Requests in flight, needs to cover both pools plus a few cancelled ones */
+#define STREAM_QUEUE_LEN (32)
+
+/* Blocks the worker may read ahead of the uploads */
+#define STREAM_BLOCK_NUM (8)
+
+/* Blocks uploaded per frame, keeps a burst of misses from stalling one frame */
+#define STREAM_COMMIT_BLOCKS (16)
+
+typedef struct stream_job {
+    const struct dat_file* source;
+    uint32_t chunk_num;
+    block_pool* pool;
+    unsigned int slot_num;
+    unsigned int generation;
+    const txr_stream_ops* ops;
+    void* user;
+    int cancelled;
+    int opened; /* 1 once the header is in, -1 if it couldn't be read */
+    int placed; /* main thread only, 1 once place found room, -1 if it didn't */
+    pvr_stream stream;
+    pvr_stream_dest dest;
+} stream_job;
+
+typedef struct stream_block {
+    unsigned char* data;
+    unsigned int job; /* job number it was read for */
+    uint32_t len;
+} stream_block;
+
+/* Jobs are numbered in submit order, job n lives in jobs[n % STREAM_QUEUE_LEN].
+ * stream_committed <= stream_read <= stream_submitted, a job counts as read
+ * once the worker put its last block in the ring. Blocks are used in the
+ * order they were filled, which is job order. */
+static stream_job jobs[STREAM_QUEUE_LEN];
+static stream_block ring[STREAM_BLOCK_NUM];
+static unsigned int stream_submitted = 0;
+static unsigned int stream_read = 0;
+static unsigned int stream_committed = 0;
+static unsigned int blocks_filled = 0;
+static unsigned int blocks_used = 0;
+
+static mutex_t stream_lock = MUTEX_INITIALIZER;
+static mutex_t stream_io_lock = MUTEX_INITIALIZER;
+static condvar_t stream_cond = COND_INITIALIZER;
+static kthread_t* stream_thread = NULL;
+static int stream_running = 0;
+
+/* Called with stream_lock held */
+static int
+txr_stream_has_work(void) {
+    if (stream_read == stream_submitted) {
+        return 0;
+    }
+    const stream_job* job = &jobs[stream_read % STREAM_QUEUE_LEN];
+    return job->cancelled || !job->opened || blocks_filled - blocks_used < STREAM_BLOCK_NUM;
+}
+
+static void*
+txr_stream_worker(void* param) {
+    (void)param;
+
+    mutex_lock(&stream_lock);
+    for (;;) {
+        while (stream_running && !txr_stream_has_work()) {
+            cond_wait(&stream_cond, &stream_lock);
+        }
+        if (!stream_running) {
+            break;
+        }
+
+        const unsigned int job_num = stream_read;
+        stream_job* job = &jobs[job_num % STREAM_QUEUE_LEN];
+        if (job->cancelled) {
+            stream_read++;
+            continue;
+        }
+
+        if (!job->opened) {
+            const uint32_t start = DAT_get_offset_by_num(job->source, job->chunk_num);
+            mutex_unlock(&stream_lock);
+
+            mutex_lock(&stream_io_lock);
+            const int opened
+                = start && pvr_stream_open(&job->stream, job->source->handle, start, job->source->chunk_size);
+            mutex_unlock(&stream_io_lock);
+
+            mutex_lock(&stream_lock);
+            job->opened = opened ? 1 : -1;
+            if (!opened) {
+                stream_read++;
+            }
+            continue;
+        }
+
+        /* Blocks past blocks_used are left alone by commit */
+        stream_block* block = &ring[blocks_filled % STREAM_BLOCK_NUM];
+        mutex_unlock(&stream_lock);
+
+        mutex_lock(&stream_io_lock);
+        const int len = pvr_stream_read(&job->stream, block->data);
+        mutex_unlock(&stream_io_lock);
+
+        mutex_lock(&stream_lock);
+        if (len > 0) {
+            block->job = job_num;
+            block->len = (uint32_t)len;
+            blocks_filled++;
+        }
+        if (!job->stream.remaining) {
+            stream_read++;
+        }
+    }
+    mutex_unlock(&stream_lock);
+
+    return NULL;
+}
+
+int
+txr_stream_init(void) {
+    if (stream_thread) {
+        return 0;
+    }
+
+    for (int i = 0; i < STREAM_BLOCK_NUM; i++) {
+        ring[i].data = memalign(32, PVR_STREAM_BLOCK_SIZE);
+        if (!ring[i].data) {
+            printf("%s no free memory\n", __func__);
+            return 1;
+        }
+    }
+
+    stream_submitted = stream_read = stream_committed = 0;
+    blocks_filled = blocks_used = 0;
+    stream_running = 1;
+    stream_thread = thd_create(0, txr_stream_worker, NULL);
+    if (!stream_thread) {
+        printf("%s couldn't start worker\n", __func__);
+        stream_running = 0;
+        return 1;
+    }
+    return 0;
+}
+
+void
+txr_stream_shutdown(void) {
+    if (!stream_thread) {
+        return;
+    }
+
+    mutex_lock(&stream_lock);
+    stream_running = 0;
+    cond_broadcast(&stream_cond);
+    mutex_unlock(&stream_lock);
+
+    thd_join(stream_thread, NULL);
+    stream_thread = NULL;
+}
+
+int
+txr_stream_request(const struct dat_file* source, uint32_t chunk_num, struct block_pool* pool,
+                   unsigned int slot_num, const txr_stream_ops* ops, void* user) {
+    int ret = 1;
+
+    mutex_lock(&stream_lock);
+    if (stream_running && stream_submitted - stream_committed < STREAM_QUEUE_LEN) {
+        stream_job* job = &jobs[stream_submitted % STREAM_QUEUE_LEN];
+        job->source = source;
+        job->chunk_num = chunk_num;
+        job->pool = pool;
+        job->slot_num = slot_num;
+        job->generation = pool_get_slot_generation(pool, slot_num);
+        job->ops = ops;
+        job->user = user;
+        job->cancelled = 0;
+        job->opened = 0;
+        job->placed = 0;
+        stream_submitted++;
+        cond_signal(&stream_cond);
+        ret = 0;
+    }
+    mutex_unlock(&stream_lock);
+
+    return ret;
+}
+
+void
+txr_stream_load_now(const struct dat_file* source, uint32_t chunk_num, unsigned int slot_num,
+                    const txr_stream_ops* ops, void* user) {
+    const uint32_t start = DAT_get_offset_by_num(source, chunk_num);
+    void* block = pvr_get_stream_block();
+    pvr_stream stream;
+    pvr_stream_dest dest;
+
+    mutex_lock(&stream_io_lock);
+    const int opened = block && start && pvr_stream_open(&stream, source->handle, start, source->chunk_size);
+    if (opened && (*ops->place)(user, slot_num, &stream, &dest)) {
+        pvr_stream_load(&stream, &dest, block);
+    }
+    mutex_unlock(&stream_io_lock);
+
+    (*ops->done)(user, slot_num, (opened && !stream.failed) ? &stream : NULL);
+}
+
+/* Saves the worker its reads, commit drops stale jobs by generation anyway */
+void
+txr_stream_cancel_slot(const struct block_pool* pool, unsigned int slot_num) {
+    mutex_lock(&stream_lock);
+    for (unsigned int i = stream_committed; i != stream_submitted; i++) {
+        stream_job* job = &jobs[i % STREAM_QUEUE_LEN];
+        if (job->pool == pool && job->slot_num == slot_num) {
+            job->cancelled = 1;
+        }
+    }
+    mutex_unlock(&stream_lock);
+}
+
+void
+txr_stream_cancel_pool(const struct block_pool* pool) {
+    mutex_lock(&stream_lock);
+    for (unsigned int i = stream_committed; i != stream_submitted; i++) {
+        stream_job* job = &jobs[i % STREAM_QUEUE_LEN];
+        if (job->pool == pool) {
+            job->cancelled = 1;
+        }
+    }
+    mutex_unlock(&stream_lock);
+}
+
+void
+txr_stream_commit(void) {
+    int budget = STREAM_COMMIT_BLOCKS;
+
+    if (!stream_thread) {
+        return;
+    }
+
+    while (budget > 0) {
+        mutex_lock(&stream_lock);
+        if (stream_committed == stream_submitted) {
+            mutex_unlock(&stream_lock);
+            break;
+        }
+        stream_job* job = &jobs[stream_committed % STREAM_QUEUE_LEN];
+        const int opened = job->opened;
+        const int cancelled = job->cancelled;
+        const int read = stream_read != stream_committed;
+        const unsigned int filled = blocks_filled;
+        mutex_unlock(&stream_lock);
+
+        if (!opened && !read) {
+            break;
+        }
+
+        /* Anything freed or reused since is dropped, its blocks included */
+        block_pool* pool = job->pool;
+        const unsigned int slot = job->slot_num;
+        int live = !cancelled && pool_get_slot_generation(pool, slot) == job->generation
+                   && pool_slot_loading(pool, slot);
+
+        if (live && opened > 0 && !job->placed) {
+            job->placed = (*job->ops->place)(job->user, slot, &job->stream, &job->dest) ? 1 : -1;
+            if (job->placed < 0) {
+                /* No room, the worker can stop reading it */
+                (*job->ops->done)(job->user, slot, &job->stream);
+                live = 0;
+                mutex_lock(&stream_lock);
+                job->cancelled = 1;
+                mutex_unlock(&stream_lock);
+            }
+        }
+
+        while (budget > 0 && blocks_used != filled && ring[blocks_used % STREAM_BLOCK_NUM].job == stream_committed) {
+            const stream_block* block = &ring[blocks_used % STREAM_BLOCK_NUM];
+            if (live) {
+                pvr_stream_upload(&job->stream, &job->dest, block->data, block->len);
+                budget--;
+            }
+            mutex_lock(&stream_lock);
+            blocks_used++;
+            mutex_unlock(&stream_lock);
+        }
+
+        /* More of it to come, carries on next frame */
+        if (!read || (blocks_used != filled && ring[blocks_used % STREAM_BLOCK_NUM].job == stream_committed)) {
+            break;
+        }
+
+        if (live) {
+            (*job->ops->done)(job->user, slot, (opened > 0 && !job->stream.failed) ? &job->stream : NULL);
+        }
+        mutex_lock(&stream_lock);
+        stream_committed++;
+        mutex_unlock(&stream_lock);
+    }
+
+    mutex_lock(&stream_lock);
+    cond_signal(&stream_cond);
+    mutex_unlock(&stream_lock);
+}
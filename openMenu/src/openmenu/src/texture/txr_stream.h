@@ -0,0 +1,48 @@
+/*
+ * File: txr_stream.h
+ * Project: texture
+ * File Created: Sunday, 18th October 2026 4:02:17 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "ui/dc/pvr_texture.h"
+
+struct dat_file;
+struct block_pool;
+
+/* Background loader for DAT textures. A worker thread reads each texture in
+ * PVR_STREAM_BLOCK_SIZE blocks into a small ring, txr_stream_commit() uploads
+ * the blocks that came in straight to their slot from the main thread between
+ * frames. No texture is ever staged whole in RAM. */
+
+int txr_stream_init(void);
+void txr_stream_shutdown(void);
+
+/* Called from txr_stream_commit, not for jobs whose slot was freed in the
+ * meantime. place picks where the texture goes once its header is in and
+ * returns 0 if there is no room, done follows once all of it was uploaded or
+ * right after a failed place, stream is NULL if reading failed. */
+typedef struct txr_stream_ops {
+    int (*place)(void* user, unsigned int slot_num, const pvr_stream* stream, pvr_stream_dest* dest);
+    void (*done)(void* user, unsigned int slot_num, const pvr_stream* stream);
+} txr_stream_ops;
+
+/* Queues chunk_num of source for the slot, which must already be marked
+ * loading. Returns non zero if the queue is full and nothing was queued. */
+int txr_stream_request(const struct dat_file* source, uint32_t chunk_num, struct block_pool* pool,
+                       unsigned int slot_num, const txr_stream_ops* ops, void* user);
+/* Same but reads and uploads it right away, for when the queue is full */
+void txr_stream_load_now(const struct dat_file* source, uint32_t chunk_num, unsigned int slot_num,
+                         const txr_stream_ops* ops, void* user);
+void txr_stream_cancel_slot(const struct block_pool* pool, unsigned int slot_num);
+void txr_stream_cancel_pool(const struct block_pool* pool);
+
+/* Call once per frame, before the scene is built */
+void txr_stream_commit(void);
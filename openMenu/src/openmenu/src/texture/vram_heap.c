@@ -0,0 +1,319 @@
+/*
+ * File: vram_heap.c
+ * Project: texture
+ * File Created: Sunday, 18th October 2026 7:34:10 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License,
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vram_heap.h"
+
+/* Per block info, only meaningful on the first min block of a buddy block */
+#define BLOCK_HEAD  (0x80)
+#define BLOCK_USED  (0x40)
+#define BLOCK_CONT  (0x20) /* split off the end of the previous block by vram_trim */
+#define BLOCK_ORDER (0x1F)
+
+#define BLOCK_NONE (-1)
+
+typedef struct vram_client {
+    uint32_t budget;
+    uint32_t used;
+    int priority;
+    vram_evict_cb evict;
+    void* user;
+} vram_client;
+
+static unsigned char* heap_base = NULL;
+static int num_blocks = 0;
+static unsigned char* block_info = NULL;
+static unsigned char* block_owner = NULL;
+static int16_t* free_next = NULL;
+static int16_t* free_prev = NULL;
+static int16_t free_head[VRAM_HEAP_ORDERS];
+
+static vram_client clients[VRAM_CLIENT_NUM];
+static unsigned int evictions = 0;
+static unsigned int failed = 0;
+
+static inline uint32_t
+order_bytes(int order) {
+    return (uint32_t)VRAM_HEAP_MIN_BLOCK << order;
+}
+
+static void
+free_list_push(int block, int order) {
+    block_info[block] = BLOCK_HEAD | order;
+    free_prev[block] = BLOCK_NONE;
+    free_next[block] = free_head[order];
+    if (free_head[order] != BLOCK_NONE) {
+        free_prev[free_head[order]] = (int16_t)block;
+    }
+    free_head[order] = (int16_t)block;
+}
+
+static void
+free_list_remove(int block, int order) {
+    if (free_prev[block] != BLOCK_NONE) {
+        free_next[free_prev[block]] = free_next[block];
+    } else {
+        free_head[order] = free_next[block];
+    }
+    if (free_next[block] != BLOCK_NONE) {
+        free_prev[free_next[block]] = free_prev[block];
+    }
+    block_info[block] = 0;
+}
+
+/* Frees and merges upward while the buddy is a free block of the same order */
+static void
+free_block(int block, int order) {
+    while (order < VRAM_HEAP_ORDERS - 1) {
+        const int buddy = block ^ (1 << order);
+        if (buddy + (1 << order) > num_blocks || block_info[buddy] != (BLOCK_HEAD | order)) {
+            break;
+        }
+        free_list_remove(buddy, order);
+        block_info[block] = 0;
+        block = (buddy < block) ? buddy : block;
+        order++;
+    }
+    free_list_push(block, order);
+}
+
+int
+vram_heap_init(void* base, uint32_t size) {
+    num_blocks = size / VRAM_HEAP_MIN_BLOCK;
+    heap_base = base;
+    block_info = calloc(num_blocks, sizeof(unsigned char));
+    block_owner = calloc(num_blocks, sizeof(unsigned char));
+    free_next = malloc(num_blocks * sizeof(int16_t));
+    free_prev = malloc(num_blocks * sizeof(int16_t));
+    if (!base || !block_info || !block_owner || !free_next || !free_prev) {
+        printf("%s no free memory\n", __func__);
+        return 1;
+    }
+
+    for (int i = 0; i < VRAM_HEAP_ORDERS; i++) {
+        free_head[i] = BLOCK_NONE;
+    }
+
+    /* Cover the heap with the biggest aligned blocks that fit */
+    for (int block = 0; block < num_blocks;) {
+        int order = VRAM_HEAP_ORDERS - 1;
+        while ((block & ((1 << order) - 1)) || block + (1 << order) > num_blocks) {
+            order--;
+        }
+        free_list_push(block, order);
+        block += 1 << order;
+    }
+
+    memset(clients, 0, sizeof(clients));
+    return 0;
+}
+
+void
+vram_client_set(enum VRAM_CLIENT client, uint32_t budget, int priority, vram_evict_cb evict, void* user) {
+    clients[client].budget = budget;
+    clients[client].priority = priority;
+    clients[client].evict = evict;
+    clients[client].user = user;
+}
+
+void
+vram_client_set_budget(enum VRAM_CLIENT client, uint32_t budget) {
+    clients[client].budget = budget;
+}
+
+static void*
+heap_alloc(enum VRAM_CLIENT client, uint32_t size) {
+    int order = 0;
+    while (order_bytes(order) < size) {
+        order++;
+    }
+    if (order >= VRAM_HEAP_ORDERS) {
+        return NULL;
+    }
+
+    int found = order;
+    while (found < VRAM_HEAP_ORDERS && free_head[found] == BLOCK_NONE) {
+        found++;
+    }
+    if (found == VRAM_HEAP_ORDERS) {
+        return NULL;
+    }
+
+    const int block = free_head[found];
+    free_list_remove(block, found);
+    while (found > order) {
+        found--;
+        free_list_push(block + (1 << found), found);
+    }
+
+    block_info[block] = BLOCK_HEAD | BLOCK_USED | order;
+    block_owner[block] = client;
+    clients[client].used += order_bytes(order);
+    return heap_base + (uint32_t)block * VRAM_HEAP_MIN_BLOCK;
+}
+
+/* Over budget clients go first, then lower priority ones. The requester only
+ * gives up its own memory once nothing cheaper is left. */
+static int
+pick_victim(enum VRAM_CLIENT client, unsigned int spent) {
+    int best = -1;
+    int best_rank = 0;
+
+    for (int i = 0; i < VRAM_CLIENT_NUM; i++) {
+        const vram_client* c = &clients[i];
+        if (!c->evict || !c->used || (spent & (1u << i))) {
+            continue;
+        }
+
+        int rank;
+        if (c->used > c->budget) {
+            rank = 3;
+        } else if (c->priority < clients[client].priority) {
+            rank = 2;
+        } else if (i == (int)client) {
+            rank = 1;
+        } else {
+            continue;
+        }
+
+        if (best == -1 || rank > best_rank || (rank == best_rank && c->priority < clients[best].priority)) {
+            best = i;
+            best_rank = rank;
+        }
+    }
+    return best;
+}
+
+void*
+vram_alloc(enum VRAM_CLIENT client, uint32_t size) {
+    unsigned int spent = 0; /* clients with nothing left they can give up */
+    void* ptr;
+
+    while (!(ptr = heap_alloc(client, size))) {
+        const int victim = pick_victim(client, spent);
+        if (victim == -1) {
+            failed++;
+            printf("VRAM: no room for %u bytes (client %d)\n", (unsigned int)size, client);
+            return NULL;
+        }
+        if (!(*clients[victim].evict)(clients[victim].user)) {
+            spent |= 1u << victim;
+            continue;
+        }
+        evictions++;
+    }
+    return ptr;
+}
+
+void*
+vram_try_alloc(enum VRAM_CLIENT client, uint32_t size) {
+    return heap_alloc(client, size);
+}
+
+void
+vram_free(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+
+    int block = ((unsigned char*)ptr - heap_base) / VRAM_HEAP_MIN_BLOCK;
+    if ((block_info[block] & (BLOCK_HEAD | BLOCK_USED | BLOCK_CONT)) != (BLOCK_HEAD | BLOCK_USED)) {
+        printf("VRAM: bad free %p\n", ptr);
+        return;
+    }
+
+    /* A trimmed allocation continues in the blocks right after it */
+    do {
+        const int order = block_info[block] & BLOCK_ORDER;
+        const int next = block + (1 << order);
+        clients[block_owner[block]].used -= order_bytes(order);
+        free_block(block, order);
+        block = next;
+    } while (block < num_blocks && (block_info[block] & (BLOCK_HEAD | BLOCK_USED | BLOCK_CONT))
+                                       == (BLOCK_HEAD | BLOCK_USED | BLOCK_CONT));
+}
+
+void
+vram_trim(void* ptr, uint32_t size) {
+    int block = ((unsigned char*)ptr - heap_base) / VRAM_HEAP_MIN_BLOCK;
+    if ((block_info[block] & (BLOCK_HEAD | BLOCK_USED | BLOCK_CONT)) != (BLOCK_HEAD | BLOCK_USED)) {
+        return;
+    }
+
+    const int client = block_owner[block];
+    int order = block_info[block] & BLOCK_ORDER;
+    int keep = (size + VRAM_HEAP_MIN_BLOCK - 1) / VRAM_HEAP_MIN_BLOCK;
+    unsigned char flags = BLOCK_HEAD | BLOCK_USED;
+    if (keep < 1) {
+        keep = 1;
+    }
+
+    /* Halve until the kept part fills the block, full left halves stay as
+     * their own pieces and the rest carries on in the right half */
+    while (order > 0 && keep < (1 << order)) {
+        const int half = 1 << (order - 1);
+        order--;
+        if (keep <= half) {
+            block_info[block] = flags | order;
+            block_owner[block] = client;
+            clients[client].used -= order_bytes(order);
+            free_list_push(block + half, order);
+        } else {
+            block_info[block] = flags | order;
+            block_owner[block] = client;
+            block += half;
+            keep -= half;
+            flags = BLOCK_HEAD | BLOCK_USED | BLOCK_CONT;
+            block_info[block] = flags | order;
+            block_owner[block] = client;
+        }
+    }
+}
+
+void
+vram_get_stats(vram_stats* stats) {
+    uint32_t free_bytes = 0;
+
+    memset(stats, 0, sizeof(vram_stats));
+    stats->total = (uint32_t)num_blocks * VRAM_HEAP_MIN_BLOCK;
+    for (int order = 0; order < VRAM_HEAP_ORDERS; order++) {
+        for (int block = free_head[order]; block != BLOCK_NONE; block = free_next[block]) {
+            free_bytes += order_bytes(order);
+            stats->largest_free = order_bytes(order);
+        }
+    }
+    stats->used = stats->total - free_bytes;
+    stats->fragmentation = free_bytes ? 100 - (unsigned int)((uint64_t)stats->largest_free * 100 / free_bytes) : 0;
+    stats->evictions = evictions;
+    stats->failed = failed;
+    for (int i = 0; i < VRAM_CLIENT_NUM; i++) {
+        stats->client_used[i] = clients[i].used;
+        stats->client_budget[i] = clients[i].budget;
+    }
+}
+
+void
+vram_print_stats(void) {
+    static const char* names[VRAM_CLIENT_NUM] = {"icon", "box", "theme"};
+    vram_stats stats;
+    vram_get_stats(&stats);
+
+    printf("VRAM: %u/%u KB used, largest free %u KB, %u%% fragmented, %u evictions, %u failed\n",
+           (unsigned int)stats.used / 1024, (unsigned int)stats.total / 1024, (unsigned int)stats.largest_free / 1024,
+           stats.fragmentation, stats.evictions, stats.failed);
+    for (int i = 0; i < VRAM_CLIENT_NUM; i++) {
+        printf("VRAM:   %-5s %4u/%4u KB\n", names[i], (unsigned int)stats.client_used[i] / 1024,
+               (unsigned int)stats.client_budget[i] / 1024);
+    }
+}
@@ -0,0 +1,58 @@
+/*
+ * File: vram_heap.h
+ * Project: texture
+ * File Created: Sunday, 18th October 2026 7:34:10 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/* Buddy allocator over one block of texture memory, shared by every texture
+ * client. Blocks are at least VRAM_HEAP_MIN_BLOCK and aligned to their size. */
+
+#define VRAM_HEAP_MIN_BLOCK (2 * 1024)
+#define VRAM_HEAP_ORDERS    (12) /* 2KB up to 4MB */
+
+/* Theme and font textures all come through texman so they are one client */
+enum VRAM_CLIENT {
+    VRAM_CLIENT_ICON = 0,
+    VRAM_CLIENT_BOX,
+    VRAM_CLIENT_THEME,
+    VRAM_CLIENT_NUM,
+};
+
+/* Frees one allocation of the client, returns 0 when nothing could go */
+typedef int (*vram_evict_cb)(void* user);
+
+typedef struct vram_stats {
+    uint32_t total;
+    uint32_t used;
+    uint32_t largest_free;
+    unsigned int fragmentation; /* percent of free memory outside the largest block */
+    unsigned int evictions;
+    unsigned int failed;
+    uint32_t client_used[VRAM_CLIENT_NUM];
+    uint32_t client_budget[VRAM_CLIENT_NUM];
+} vram_stats;
+
+int vram_heap_init(void* base, uint32_t size);
+
+/* Clients may go past their budget while memory is free. When it runs out,
+ * clients over budget are evicted first, then lower priorities. */
+void vram_client_set(enum VRAM_CLIENT client, uint32_t budget, int priority, vram_evict_cb evict, void* user);
+void vram_client_set_budget(enum VRAM_CLIENT client, uint32_t budget);
+
+void* vram_alloc(enum VRAM_CLIENT client, uint32_t size);
+/* Only takes memory that is already free, never evicts */
+void* vram_try_alloc(enum VRAM_CLIENT client, uint32_t size);
+void vram_free(void* ptr);
+/* Hands everything past size back to the heap, ptr stays valid */
+void vram_trim(void* ptr, uint32_t size);
+
+void vram_get_stats(vram_stats* stats);
+void vram_print_stats(void);
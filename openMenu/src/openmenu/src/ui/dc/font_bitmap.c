@@ -10,6 +10,7 @@
 #include <dc/pvr.h>
 
 #include <dbgprint.h>
+#include "ui/dc/text_cache.h"
 #include "ui/draw_prototypes.h"
 
 typedef struct bitmap_font {
@@ -35,15 +36,15 @@ static pvr_vertex_t charbuf[BUFFER_MAX_CHARS * VERT_PER_CHAR] __attribute__((ali
 #endif
 
 static int charbuffered;
+static text_run* layout_run; /* kept as it is sent, NULL if it isnt */
 
 int
 font_bmp_init(const char* filename, int char_width, int char_height) {
-    unsigned int temp = texman_create();
-    draw_load_texture_buffer(filename, &font.texture, texman_get_tex_data(temp));
-    texman_reserve_memory(font.texture.width, font.texture.height, 2 /* 16Bit */);
+    texman_load(filename, &font.texture);
 
     font.char_height = char_height;
     font.char_width = char_width;
+    text_cache_clear(TEXT_FONT_BMP);
 
     font_color = 0xFFFFFFFF; // White
 
@@ -75,6 +76,7 @@ font_bmp_set_color(uint32_t color) {
     font_header.argb = color;
 #endif
     /* Start a textured polygon set (with the font texture and color) */
+    draw_flush();
     pvr_prim(&font_header, sizeof(font_header));
 }
 
@@ -88,6 +90,15 @@ font_bmp_set_color_components(int r, int g, int b, int a) {
     font_color = PVR_PACK_ARGB(a, r, g, b);
 }
 
+static void
+font_bmp_flush_chars(void) {
+    pvr_prim(charbuf, charbuffered * sizeof(charbuf[0]));
+    if (layout_run && text_cache_append(layout_run, 0, charbuf, charbuffered)) {
+        layout_run = NULL;
+    }
+    charbuffered = 0;
+}
+
 /* Draws a font letter using two triangle strips */
 static void
 font_bmp_draw_char(int x, int y, unsigned char ch) {
@@ -112,6 +123,9 @@ font_bmp_draw_char(int x, int y, unsigned char ch) {
     if (index == -1) {
         return;
     }
+    if (charbuffered == BUFFER_MAX_CHARS * VERT_PER_CHAR) {
+        font_bmp_flush_chars();
+    }
 
 #ifdef KOS_SPRITE
     pvr_sprite_txr_t vert = {
@@ -188,12 +202,20 @@ _font_bmp_draw_string(int x1, int y1, const char* str) {
     z_inc();
     charbuffered = 0;
 
+    /* Fixed width cells move exactly, anywhere */
+    text_run* run = text_cache_find(TEXT_FONT_BMP, str, 1.0f, 0);
+    if (run) {
+        text_cache_draw(run, x1, y1, z_get(), font_color, NULL);
+        return;
+    }
+    layout_run = text_cache_begin(TEXT_FONT_BMP, str, 1.0f, 0, x1, y1, z_get(), font_color);
+
     do {
         unsigned char chr = (*str);
         font_bmp_draw_char(x1, y1, chr);
         x1 += (int)(font.char_width);
     } while (*++str);
-    pvr_prim(charbuf, charbuffered * sizeof(charbuf[0]));
+    font_bmp_flush_chars();
 }
 
 /* @Note: revisit this */
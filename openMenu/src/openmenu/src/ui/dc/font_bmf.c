@@ -9,6 +9,7 @@
 
 #include <dc/pvr.h>
 #include <kos/fs.h>
+#include <malloc.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -16,6 +17,8 @@
 #include <string.h>
 
 #include <dbgprint.h>
+#include <texture/font_pack.h>
+#include "ui/dc/text_cache.h"
 #include "ui/draw_prototypes.h"
 
 #define PRINT_MEMBER(struct, member)                                                                                   \
@@ -26,7 +29,8 @@
 #define round(x)  (x)
 
 /* BMFont implementation */
-#define BMF_MAGIC (54938946) /* BMF(0x3) */
+#define BMF_MAGIC     (54938946) /* BMF(0x3) */
+#define BMF_MAX_PAGES (FONT_PACK_MAX_PAGES)
 
 typedef struct bm_header {
     char bmf[3];
@@ -105,19 +109,13 @@ typedef struct __attribute__((__packed__)) bm_kern_pair {
     int16_t amount;
 } bm_kern_pair;
 
-typedef struct __attribute__((__packed__)) bm_char_ex {
-    uint32_t id;
-    uint16_t x;
-    uint16_t y;
-    uint16_t width;
-    uint16_t height;
-    int16_t xoffset;
-    int16_t yoffset;
-    int16_t xadvance;
-    uint8_t page;
-    uint8_t chnl;
-    bm_kern_pair* kerns;
-} bm_char_ex;
+/* Kerning is compiled at load into a row of amounts per char that starts any
+ * pair, indexed by the second char. Fonts kern a handful of chars by a few
+ * pixels, so rows are small and amounts fit in a byte. Pairs with a char from
+ * 256 up go in a sorted list instead. A font pack holds both compiled already. */
+typedef font_pack_char bm_char_ex;
+typedef font_pack_kern_row bm_kern_row;
+typedef font_pack_kern_pair bm_kern_wide;
 
 typedef struct __attribute__((__packed__)) bm_font {
     uint16_t height;
@@ -125,13 +123,19 @@ typedef struct __attribute__((__packed__)) bm_font {
     uint32_t lineHeight;
     uint32_t fontSize;
     uint32_t num_chars;
-    uint32_t num_kerns;
-    bm_char_ex chars[256];
-    bm_kern_pair* kerns;
+    uint32_t num_kern_rows;
+    uint32_t num_pages;
+    uint32_t num_wide_chars;
+    uint32_t num_wide_pairs;
+    bm_char_ex chars[256]; /* by id, everything Latin-1 covers */
+    bm_kern_row* kern_rows;
+    bm_char_ex* wide_chars;   /* ids from 256 up, sorted */
+    bm_kern_wide* wide_pairs; /* pairs with either char from 256 up, sorted */
 } bm_font;
 
 static bm_font font_basilea;
 static int font_loaded = 0;
+static int font_packed = 0; /* metrics came from a font pack */
 static float current_scale = 1.0;
 static unsigned int current_color;
 
@@ -193,31 +197,80 @@ BMF_parse_common(file_t fd, size_t block_size, bm_font* font) {
 static int
 BMF_parse_pages(file_t fd, size_t block_size, bm_font* font) {
     DBG_PRINT("BMF found pages block!\n");
-    (void)font;
 
-    /* Do nothing! */
-    fs_seek(fd, block_size, SEEK_CUR);
+    /* Only counted, the textures are named after the one font_bmf_init is given */
+    char* names = malloc(block_size);
+    if (!names) {
+        printf("%s no free memory\n", __func__);
+        fs_seek(fd, block_size, SEEK_CUR);
+        return 0;
+    }
+    fs_read(fd, names, block_size);
+    for (size_t i = 0; i < block_size; i++) {
+        font->num_pages += names[i] == '\0';
+    }
+    free(names);
+
+    DBG_PRINT("BMF %d pages present\n", (int)font->num_pages);
+    if (font->num_pages > BMF_MAX_PAGES) {
+        printf("BMF:Error %d pages, only %d supported\n", (int)font->num_pages, BMF_MAX_PAGES);
+        font->num_pages = BMF_MAX_PAGES;
+    }
 
     DBG_PRINT("\n");
 
     return 0;
 }
 
+static int
+_wide_char_sort(const void* a, const void* b) {
+    const bm_char_ex* ia = (const bm_char_ex*)a;
+    const bm_char_ex* ib = (const bm_char_ex*)b;
+    return (ia->id > ib->id) - (ia->id < ib->id);
+}
+
+static int
+_wide_pair_sort(const void* a, const void* b) {
+    const bm_kern_wide* ia = (const bm_kern_wide*)a;
+    const bm_kern_wide* ib = (const bm_kern_wide*)b;
+    if (ia->first != ib->first) {
+        return (ia->first > ib->first) - (ia->first < ib->first);
+    }
+    return (ia->second > ib->second) - (ia->second < ib->second);
+}
+
 static int
 BMF_parse_chars(file_t fd, size_t block_size, bm_font* font) {
     DBG_PRINT("BMF found char block!\n");
 
     int num_chars = block_size / sizeof(bm_char);
     bm_char_ex temp_char;
+    /* The pages block comes first, without one everything is on page 0 */
+    const uint32_t num_pages = font->num_pages ? font->num_pages : 1;
 
     font->num_chars = num_chars;
 
     DBG_PRINT("BMF %d chars present\n", num_chars);
 
+    /* Room for every char past 255, trimmed once the block is read */
+    font->wide_chars = malloc(sizeof(bm_char_ex) * num_chars);
+    if (!font->wide_chars) {
+        printf("%s no free memory\n", __func__);
+    }
+
     /* Read one at a time to font charset */
     for (int i = 0; i < num_chars; i++) {
         fs_read(fd, &temp_char, sizeof(bm_char));
-        if (temp_char.id < 256) {
+        temp_char.kern_row = 0;
+        if (temp_char.page >= num_pages) {
+            printf("BMF:Error char %u on page %d\n", (unsigned int)temp_char.id, temp_char.page);
+            continue;
+        }
+        if (temp_char.id >= 256) {
+            if (font->wide_chars) {
+                font->wide_chars[font->num_wide_chars++] = temp_char;
+            }
+        } else {
             /* Optionally print out info for each char parsed */
 #if defined(DBG_CHAR_INFO) && DBG_CHAR_INFO
             char temp = (char)temp_char.id;
@@ -234,24 +287,25 @@ BMF_parse_chars(file_t fd, size_t block_size, bm_font* font) {
 #endif
 
             font->chars[temp_char.id] = temp_char;
-            font->chars[temp_char.id].kerns = NULL;
         }
     }
 
+    if (font->num_wide_chars) {
+        qsort(font->wide_chars, font->num_wide_chars, sizeof(bm_char_ex), _wide_char_sort);
+        bm_char_ex* trimmed = realloc(font->wide_chars, sizeof(bm_char_ex) * font->num_wide_chars);
+        if (trimmed) {
+            font->wide_chars = trimmed;
+        }
+    } else {
+        free(font->wide_chars);
+        font->wide_chars = NULL;
+    }
+    DBG_PRINT("BMF %d chars past 255\n", (int)font->num_wide_chars);
+
     DBG_PRINT("\n");
     return 0;
 }
 
-static int
-_kern_pair_sort(const void* a, const void* b) {
-    const bm_kern_pair* ia = (const bm_kern_pair*)a;
-    const bm_kern_pair* ib = (const bm_kern_pair*)b;
-    if (ia->first == ib->first) {
-        return ia->second - ib->second;
-    }
-    return ia->first - ib->first;
-}
-
 static int
 BMF_parse_kerning(file_t fd, size_t block_size, bm_font* font) {
     DBG_PRINT("BMF found kerning block!\n");
@@ -261,23 +315,51 @@ BMF_parse_kerning(file_t fd, size_t block_size, bm_font* font) {
 
     DBG_PRINT("BMF %d kerning pairs present\n", num_pairs);
 
-    font->kerns = malloc(sizeof(bm_kern_pair) * num_pairs);
-    if (!font->kerns) {
+    bm_kern_pair* pairs = malloc(sizeof(bm_kern_pair) * num_pairs);
+    if (!pairs) {
         printf("%s no free memory\n", __func__);
         return 0;
     }
-    font->num_kerns = num_pairs;
-    fs_read(fd, font->kerns, num_pairs * sizeof(bm_kern_pair));
-
-    /* Sort Kerning pairs */
-    qsort(font->kerns, num_pairs, sizeof(bm_kern_pair), _kern_pair_sort);
+    fs_read(fd, pairs, num_pairs * sizeof(bm_kern_pair));
 
-    /* List the now sorted pairs*/
+    /* A row for every char starting a pair, the rest go on the wide list */
+    int num_wide_pairs = 0;
     for (int i = 0; i < num_pairs; i++) {
-        bm_kern_pair* pair = &font->kerns[i];
+        bm_kern_pair* pair = &pairs[i];
+        if (pair->first >= 256 || pair->second >= 256) {
+            num_wide_pairs++;
+        } else if (!font->chars[pair->first].kern_row) {
+            font->chars[pair->first].kern_row = (uint16_t)++font->num_kern_rows;
+        }
+    }
+    if (num_wide_pairs) {
+        font->wide_pairs = malloc(sizeof(bm_kern_wide) * num_wide_pairs);
+        if (!font->wide_pairs) {
+            printf("%s no free memory\n", __func__);
+        }
+    }
+    font->kern_rows = calloc(font->num_kern_rows, sizeof(bm_kern_row));
+    if (!font->kern_rows && font->num_kern_rows) {
+        printf("%s no free memory\n", __func__);
+        for (int i = 0; i < 256; i++) {
+            font->chars[i].kern_row = 0;
+        }
+        font->num_kern_rows = 0;
+        free(pairs);
+        return 0;
+    }
 
-        if (pair->first < 256) {
-            font->chars[pair->first].kerns = pair;
+    for (int i = 0; i < num_pairs; i++) {
+        bm_kern_pair* pair = &pairs[i];
+
+        if (pair->first < 256 && pair->second < 256) {
+            const int amount = pair->amount < INT8_MIN ? INT8_MIN : pair->amount > INT8_MAX ? INT8_MAX : pair->amount;
+            font->kern_rows[font->chars[pair->first].kern_row - 1][pair->second] = (int8_t)amount;
+        } else if (font->wide_pairs) {
+            bm_kern_wide* wide = &font->wide_pairs[font->num_wide_pairs++];
+            wide->first = pair->first;
+            wide->second = pair->second;
+            wide->amount = pair->amount;
         }
 
 #if defined(DBG_KERN_INFO) && DBG_KERN_INFO
@@ -289,7 +371,12 @@ BMF_parse_kerning(file_t fd, size_t block_size, bm_font* font) {
         DBG_PRINT("\n");
 #endif
     }
+    free(pairs);
+    if (font->num_wide_pairs) {
+        qsort(font->wide_pairs, font->num_wide_pairs, sizeof(bm_kern_wide), _wide_pair_sort);
+    }
 
+    DBG_PRINT("BMF %d kerning rows, %d wide pairs\n", (int)font->num_kern_rows, (int)font->num_wide_pairs);
     DBG_PRINT("\n");
     return 0;
 }
@@ -342,24 +429,239 @@ BMF_load(const char* file, bm_font* font) {
 
     fs_close(fd);
 
+    if (!font->num_pages) {
+        font->num_pages = 1;
+    }
     font_loaded = 1;
 
     return 0;
 }
 
-int
-BMF_adjust_kerning(unsigned char first, unsigned char second, bm_font* font) {
-    const bm_kern_pair* kern_pairs = font->chars[first].kerns;
-    if (kern_pairs) {
-        do {
-            if (kern_pairs->second == second) {
-                return kern_pairs->amount;
+static int
+BMF_pack_valid(const unsigned char* pack, size_t size) {
+    const font_pack_header* hdr = (const font_pack_header*)pack;
+
+    if (size < sizeof(font_pack_header) || memcmp(hdr->magic, FONT_PACK_MAGIC, sizeof(hdr->magic))
+        || hdr->version != FONT_PACK_VERSION || !hdr->num_pages || hdr->num_pages > BMF_MAX_PAGES
+        || hdr->num_kern_rows > 256 || hdr->num_wide_chars > size / sizeof(bm_char_ex)
+        || hdr->num_wide_pairs > size / sizeof(bm_kern_wide)) {
+        return 0;
+    }
+    const size_t metrics = sizeof(font_pack_header) + sizeof(bm_char_ex) * (256 + hdr->num_wide_chars)
+                           + sizeof(bm_kern_row) * hdr->num_kern_rows + sizeof(bm_kern_wide) * hdr->num_wide_pairs;
+    if (metrics > size) {
+        return 0;
+    }
+
+    /* Char records index the kerning rows and the page textures */
+    const bm_char_ex* chars = (const bm_char_ex*)(pack + sizeof(font_pack_header));
+    const bm_char_ex* wide_chars = (const bm_char_ex*)((const unsigned char*)(chars + 256)
+                                                       + sizeof(bm_kern_row) * hdr->num_kern_rows);
+    for (uint32_t i = 0; i < 256 + hdr->num_wide_chars; i++) {
+        const bm_char_ex* chr = (i < 256) ? &chars[i] : &wide_chars[i - 256];
+        if (chr->kern_row > hdr->num_kern_rows || chr->page >= hdr->num_pages) {
+            return 0;
+        }
+    }
+
+    /* Every page a whole PVR, the GBIX header is always there */
+    for (uint32_t page = 0; page < hdr->num_pages; page++) {
+        const uint32_t offset = hdr->page_offset[page];
+        if (offset < metrics || offset > size || hdr->page_size[page] > size - offset || hdr->page_size[page] < 32
+            || memcmp(pack + offset + 16, "PVRT", 4)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* The whole pack in one read, NULL if there is none or it is broken */
+static unsigned char*
+BMF_read_pack(const char* file) {
+    file_t fd = fs_open(file, O_RDONLY);
+
+    if (fd == -1) {
+        return NULL;
+    }
+    const size_t size = fs_total(fd);
+    unsigned char* pack = memalign(FONT_PACK_ALIGN, size ? size : 1);
+    if (!pack) {
+        printf("%s no free memory\n", __func__);
+        fs_close(fd);
+        return NULL;
+    }
+    const ssize_t read = fs_read(fd, pack, size);
+    fs_close(fd);
+
+    if (read != (ssize_t)size || !BMF_pack_valid(pack, size)) {
+        printf("BMF:Error font pack %s is broken!\n", file);
+        free(pack);
+        return NULL;
+    }
+    return pack;
+}
+
+/* Everything is compiled already, chars and kerning rows are only copied out */
+static void
+BMF_load_pack(const unsigned char* pack, bm_font* font) {
+    const font_pack_header* hdr = (const font_pack_header*)pack;
+    const unsigned char* data = pack + sizeof(font_pack_header);
+
+    memset(font, '\0', sizeof(bm_font));
+    font->height = hdr->height;
+    font->width = hdr->width;
+    font->lineHeight = hdr->lineHeight;
+    font->fontSize = hdr->fontSize;
+    font->num_chars = hdr->num_chars;
+    font->num_pages = hdr->num_pages;
+
+    memcpy(font->chars, data, sizeof(font->chars));
+    data += sizeof(font->chars);
+
+    if (hdr->num_kern_rows) {
+        font->kern_rows = malloc(sizeof(bm_kern_row) * hdr->num_kern_rows);
+        if (font->kern_rows) {
+            memcpy(font->kern_rows, data, sizeof(bm_kern_row) * hdr->num_kern_rows);
+            font->num_kern_rows = hdr->num_kern_rows;
+        } else {
+            printf("%s no free memory\n", __func__);
+            for (int i = 0; i < 256; i++) {
+                font->chars[i].kern_row = 0;
             }
-        } while ((unsigned char)(kern_pairs++)->first == first);
+        }
+    }
+    data += sizeof(bm_kern_row) * hdr->num_kern_rows;
+
+    if (hdr->num_wide_chars) {
+        font->wide_chars = malloc(sizeof(bm_char_ex) * hdr->num_wide_chars);
+        if (font->wide_chars) {
+            memcpy(font->wide_chars, data, sizeof(bm_char_ex) * hdr->num_wide_chars);
+            font->num_wide_chars = hdr->num_wide_chars;
+        } else {
+            printf("%s no free memory\n", __func__);
+        }
+    }
+    data += sizeof(bm_char_ex) * hdr->num_wide_chars;
+
+    if (hdr->num_wide_pairs) {
+        font->wide_pairs = malloc(sizeof(bm_kern_wide) * hdr->num_wide_pairs);
+        if (font->wide_pairs) {
+            memcpy(font->wide_pairs, data, sizeof(bm_kern_wide) * hdr->num_wide_pairs);
+            font->num_wide_pairs = hdr->num_wide_pairs;
+        } else {
+            printf("%s no free memory\n", __func__);
+        }
+    }
+
+    DBG_PRINT("BMF pack %d chars %d past 255, %d kerning rows %d wide pairs, %d pages\n", (int)font->num_chars,
+              (int)font->num_wide_chars, (int)font->num_kern_rows, (int)font->num_wide_pairs, (int)font->num_pages);
+    font_loaded = 1;
+}
+
+/* Chars the font doesnt have draw as nothing, like missing ones below 256 */
+static const bm_char_ex BMF_missing_char;
+
+static const bm_char_ex*
+BMF_find_wide_char(const bm_font* font, uint32_t id) {
+    int low = 0;
+    int high = (int)font->num_wide_chars - 1;
+
+    while (low <= high) {
+        const int mid = (low + high) / 2;
+        const uint32_t mid_id = font->wide_chars[mid].id;
+        if (mid_id == id) {
+            return &font->wide_chars[mid];
+        }
+        if (mid_id < id) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return &BMF_missing_char;
+}
+
+static inline const bm_char_ex*
+BMF_get_char(const bm_font* font, uint32_t id) {
+    return id < 256 ? &font->chars[id] : BMF_find_wide_char(font, id);
+}
+
+static int
+BMF_find_wide_kerning(const bm_font* font, uint32_t first, uint32_t second) {
+    int low = 0;
+    int high = (int)font->num_wide_pairs - 1;
+
+    while (low <= high) {
+        const int mid = (low + high) / 2;
+        const bm_kern_wide* pair = &font->wide_pairs[mid];
+        if (pair->first == first && pair->second == second) {
+            return pair->amount;
+        }
+        if (pair->first < first || (pair->first == first && pair->second < second)) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
     }
     return 0;
 }
 
+/* Rows cover pairs between chars below 256, the wide list the rest */
+static inline int
+BMF_adjust_kerning(uint32_t first, uint32_t second, const bm_font* font) {
+    if ((first | second) >= 256) {
+        return BMF_find_wide_kerning(font, first, second);
+    }
+    const uint16_t row = font->chars[first].kern_row;
+    return row ? font->kern_rows[row - 1][second] : 0;
+}
+
+static uint32_t
+utf8_next_multi(const char** str) {
+    const unsigned char* s = (const unsigned char*)*str;
+    uint32_t code;
+    int len;
+
+    if ((s[0] & 0xE0) == 0xC0) {
+        code = s[0] & 0x1F;
+        len = 2;
+    } else if ((s[0] & 0xF0) == 0xE0) {
+        code = s[0] & 0x0F;
+        len = 3;
+    } else if ((s[0] & 0xF8) == 0xF0) {
+        code = s[0] & 0x07;
+        len = 4;
+    } else {
+        len = 0;
+    }
+    for (int i = 1; i < len; i++) {
+        if ((s[i] & 0xC0) != 0x80) {
+            len = 0;
+            break;
+        }
+        code = (code << 6) | (s[i] & 0x3F);
+    }
+
+    /* Not UTF-8, taken as the Latin-1 byte older lists are written in */
+    if (!len || code < 0x80) {
+        (*str)++;
+        return s[0];
+    }
+    *str += len;
+    return code;
+}
+
+/* Next char of a UTF-8 string, str moves past it */
+static inline uint32_t
+utf8_next(const char** str) {
+    const unsigned char chr = (unsigned char)**str;
+    if (chr < 0x80) {
+        (*str)++;
+        return chr;
+    }
+    return utf8_next_multi(str);
+}
+
 /* Drawing */
 
 void
@@ -383,13 +685,89 @@ font_bmf_set_scale(float scale) {
 static float X_SCALE;
 
 #ifdef KOS_SPRITE
-static pvr_sprite_hdr_t font_header;
+static pvr_sprite_hdr_t font_headers[BMF_MAX_PAGES];
 #define VERT_PER_CHAR (1)
 #else
-static pvr_poly_hdr_t font_header;
+static pvr_poly_hdr_t font_headers[BMF_MAX_PAGES];
 #define VERT_PER_CHAR (4)
 #endif
-static image font_texture;
+static image font_textures[BMF_MAX_PAGES];
+static int header_page; /* whose header went out last */
+
+/* Page 0 is the texture given, the others are named after it with their page
+ * number ahead of the extension: FONT/BASILEA_W.PVR, FONT/BASILEA_W_1.PVR.. */
+static void
+font_bmf_page_texture(char* out, size_t len, const char* texture, int page) {
+    const char* ext = strrchr(texture, '.');
+    const int name_len = ext ? (int)(ext - texture) : (int)strlen(texture);
+    snprintf(out, len, "%.*s_%d%s", name_len, texture, page, ext ? ext : "");
+}
+
+/* A pack is named after the texture it holds, FONT/BASILEA_W.PVR packs into
+ * FONT/BASILEA_W.FPK. Its textures are kept under its name, page numbered
+ * like page textures are. */
+static void
+font_bmf_pack_key(char* out, size_t len, const char* texture, int page) {
+    const char* ext = strrchr(texture, '.');
+    const int name_len = ext ? (int)(ext - texture) : (int)strlen(texture);
+    if (page) {
+        snprintf(out, len, "%.*s_%d.FPK", name_len, texture, page);
+    } else {
+        snprintf(out, len, "%.*s.FPK", name_len, texture);
+    }
+}
+
+/* Textures found without a usable pack, so UI switches don't look again */
+#define BMF_NO_PACK_MAX (4)
+static char font_no_pack[BMF_NO_PACK_MAX][64];
+static int font_no_pack_next;
+
+/* Returns non zero if texture has no pack or it is broken */
+static int
+font_bmf_load_pack(const char* texture) {
+    char key[128];
+    int page;
+
+    if (font_packed) {
+        /* Read before, its textures usually stay resident between UIs */
+        for (page = 0; page < (int)font_basilea.num_pages; page++) {
+            font_bmf_pack_key(key, sizeof(key), texture, page);
+            if (!texman_load_resident(key, &font_textures[page])) {
+                break;
+            }
+        }
+        if (page == (int)font_basilea.num_pages) {
+            return 0;
+        }
+    }
+
+    char temp_pack[128];
+    font_bmf_pack_key(key, sizeof(key), texture, 0);
+    for (int i = 0; i < BMF_NO_PACK_MAX; i++) {
+        if (!strncmp(font_no_pack[i], key, sizeof(font_no_pack[i]) - 1)) {
+            return 1;
+        }
+    }
+    snprintf(temp_pack, 127, "/cd/%s", key);
+    unsigned char* pack = BMF_read_pack(temp_pack);
+    if (!pack) {
+        snprintf(font_no_pack[font_no_pack_next], sizeof(font_no_pack[0]), "%s", key);
+        font_no_pack_next = (font_no_pack_next + 1) % BMF_NO_PACK_MAX;
+        return 1;
+    }
+    if (!font_loaded) {
+        BMF_load_pack(pack, &font_basilea);
+        font_packed = 1;
+    }
+
+    const font_pack_header* hdr = (const font_pack_header*)pack;
+    for (page = 0; page < (int)font_basilea.num_pages && page < (int)hdr->num_pages; page++) {
+        font_bmf_pack_key(key, sizeof(key), texture, page);
+        texman_load_buffer(key, pack + hdr->page_offset[page], &font_textures[page]);
+    }
+    free(pack);
+    return 0;
+}
 
 /* Font prototype generics */
 int
@@ -403,14 +781,25 @@ font_bmf_init(const char* fnt, const char* texture, int is_wide) {
     char temp_fnt[128];
     snprintf(temp_fnt, 127, "/cd/%s", fnt);
 
+    text_cache_clear(TEXT_FONT_BMF);
+
+    /* A pack has the metrics and textures in one read, otherwise the .FNT
+     * and every page texture are read one after the other */
+    if (!font_bmf_load_pack(texture)) {
+        return 0;
+    }
+
     /* If we arent loaded then load eveyrthing, otherwise just load texture */
     if (!font_loaded) {
         ret += BMF_load(temp_fnt, &font_basilea);
     }
 
-    unsigned int temp = texman_create();
-    draw_load_texture_buffer(texture, &font_texture, texman_get_tex_data(temp));
-    texman_reserve_memory(font_texture.width, font_texture.height, 2 /* 16Bit */);
+    texman_load(texture, &font_textures[0]);
+    for (int page = 1; page < (int)font_basilea.num_pages; page++) {
+        char page_texture[128];
+        font_bmf_page_texture(page_texture, sizeof(page_texture), texture, page);
+        texman_load(page_texture, &font_textures[page]);
+    }
 
     return ret;
 }
@@ -420,40 +809,53 @@ font_bmf_destroy(void) { /*@Todo: release safely */ }
 
 void
 font_bmf_begin_draw(void) {
-    /* Make a polygon header */
+    /* Make a polygon header per page */
+    for (int page = 0; page < (int)font_basilea.num_pages; page++) {
+        const image* texture = &font_textures[page];
 #ifdef KOS_SPRITE
-    pvr_sprite_cxt_t tmp;
-    pvr_sprite_cxt_txr(&tmp, draw_get_list(), font_texture.format, font_texture.width, font_texture.height,
-                       font_texture.texture, PVR_FILTER_BILINEAR);
-    pvr_sprite_compile(&font_header, &tmp);
+        pvr_sprite_cxt_t tmp;
+        pvr_sprite_cxt_txr(&tmp, draw_get_list(), texture->format, texture->width, texture->height, texture->texture,
+                           PVR_FILTER_BILINEAR);
+        pvr_sprite_compile(&font_headers[page], &tmp);
 #else
-    pvr_poly_cxt_t tmp;
-    pvr_poly_cxt_txr(&tmp, draw_get_list(), font_texture.format, font_texture.width, font_texture.height,
-                     font_texture.texture, PVR_FILTER_BILINEAR);
-    if (tmp.txr.enable != PVR_TEXTURE_DISABLE) {
-        switch (tmp.txr.width) {
-            case 8:
-            case 16:
-            case 32:
-            case 64:
-            case 128:
-            case 256:
-            case 512:
-            case 1024: break;
-            default:
-                printf("%s error tex size %d(%ld) %d(%ld)\n", __func__, tmp.txr.width, font_texture.width,
-                       tmp.txr.height, font_texture.height);
-                return;
-                break;
+        pvr_poly_cxt_t tmp;
+        pvr_poly_cxt_txr(&tmp, draw_get_list(), texture->format, texture->width, texture->height, texture->texture,
+                         PVR_FILTER_BILINEAR);
+        if (tmp.txr.enable != PVR_TEXTURE_DISABLE) {
+            switch (tmp.txr.width) {
+                case 8:
+                case 16:
+                case 32:
+                case 64:
+                case 128:
+                case 256:
+                case 512:
+                case 1024: break;
+                default:
+                    printf("%s error tex size %d(%ld) %d(%ld)\n", __func__, tmp.txr.width, texture->width,
+                           tmp.txr.height, texture->height);
+                    return;
+                    break;
+            }
         }
-    }
-    pvr_poly_compile(&font_header, &tmp);
+        pvr_poly_compile(&font_headers[page], &tmp);
 #endif
+    }
     font_bmf_set_height_default();
-    pvr_prim(&font_header, sizeof(font_header));
+    draw_flush();
+    pvr_prim(&font_headers[0], sizeof(font_headers[0]));
+    header_page = 0;
     current_color = PVR_PACK_ARGB(0xff, 0xff, 0xff, 0xff);
 }
 
+static void
+font_bmf_use_page(int page) {
+    if (page != header_page) {
+        pvr_prim(&font_headers[page], sizeof(font_headers[page]));
+        header_page = page;
+    }
+}
+
 #define BUFFER_MAX_CHARS (128)
 #ifdef KOS_SPRITE
 static pvr_sprite_txr_t charbuf[BUFFER_MAX_CHARS * VERT_PER_CHAR] __attribute__((aligned(32)));
@@ -461,29 +863,67 @@ static pvr_sprite_txr_t charbuf[BUFFER_MAX_CHARS * VERT_PER_CHAR] __attribute__(
 static pvr_vertex_t charbuf[BUFFER_MAX_CHARS * VERT_PER_CHAR] __attribute__((aligned(32)));
 #endif
 static int charbuffered;
+static text_run* layout_run; /* kept as it is sent, NULL if it isnt */
+
+/* Text is laid out once per page it uses, each pass only sends the glyphs on
+ * its page so every page goes out under a single header */
+static int layout_page;
+static unsigned int layout_pages_seen;
+
+static void
+font_bmf_flush_chars(void) {
+    pvr_prim(charbuf, charbuffered * sizeof(charbuf[0]));
+    if (layout_run && text_cache_append(layout_run, layout_page, charbuf, charbuffered)) {
+        layout_run = NULL;
+    }
+    charbuffered = 0;
+}
+
+/* Returns non zero if str was laid out before and has been drawn, otherwise
+ * the layout about to be made is kept. Pen positions are truncated as they
+ * advance, so a layout only moves exactly while they stay positive. */
+static int
+font_bmf_draw_cached(int x, int y, const char* str, int width) {
+    layout_run = NULL;
+    if (x < 0 || y < 0) {
+        return 0;
+    }
+
+    text_run* run = text_cache_find(TEXT_FONT_BMF, str, current_scale, width);
+    if (run) {
+        text_cache_draw(run, x, y, z_get(), current_color, font_bmf_use_page);
+        return 1;
+    }
+    layout_run = text_cache_begin(TEXT_FONT_BMF, str, current_scale, width, x, y, z_get(), current_color);
+    return 0;
+}
 
 /* Draws a font letter using two triangle strips */
 static int
-font_bmf_draw_char(int x, int y, unsigned char chr) {
+font_bmf_draw_char(int x, int y, const bm_char_ex* glyph) {
     bm_font* font = &font_basilea;
 
+    layout_pages_seen |= 1u << glyph->page;
+    if (glyph->page != layout_page) {
+        return (current_scale * glyph->xadvance) * X_SCALE;
+    }
+
     /* Upper left */
-    const float x1 = round(x + (current_scale * (float)font->chars[chr].xoffset) * X_SCALE);
-    const float y1 = round(y + current_scale * (float)font->chars[chr].yoffset);
-    const float u1 = (float)font->chars[chr].x / (float)font->width;
-    const float v1 = (float)font->chars[chr].y / (float)font->height;
+    const float x1 = round(x + (current_scale * (float)glyph->xoffset) * X_SCALE);
+    const float y1 = round(y + current_scale * (float)glyph->yoffset);
+    const float u1 = (float)glyph->x / (float)font->width;
+    const float v1 = (float)glyph->y / (float)font->height;
 
     /* Lower right */
-    const float x2 = round(x + (current_scale * ((float)font->chars[chr].width + font->chars[chr].xoffset)) * X_SCALE);
-    const float y2 = round(y + current_scale * ((float)font->chars[chr].height + font->chars[chr].yoffset));
-    const float u2 = (float)(font->chars[chr].x + font->chars[chr].width) / (float)font->width;
-    const float v2 = (float)(font->chars[chr].y + font->chars[chr].height) / (float)font->height;
+    const float x2 = round(x + (current_scale * ((float)glyph->width + glyph->xoffset)) * X_SCALE);
+    const float y2 = round(y + current_scale * ((float)glyph->height + glyph->yoffset));
+    const float u2 = (float)(glyph->x + glyph->width) / (float)font->width;
+    const float v2 = (float)(glyph->y + glyph->height) / (float)font->height;
 
     const float z = z_get();
 
-    if (charbuffered > BUFFER_MAX_CHARS) {
-        pvr_prim(charbuf, charbuffered * sizeof(charbuf[0]));
-        charbuffered = 0;
+    if (charbuffered == BUFFER_MAX_CHARS * VERT_PER_CHAR) {
+        font_bmf_flush_chars();
     }
 
 #ifdef KOS_SPRITE
@@ -555,56 +995,195 @@ font_bmf_draw_char(int x, int y, unsigned char chr) {
 #endif
     charbuffered += VERT_PER_CHAR;
 
-    return (current_scale * font->chars[chr].xadvance) * X_SCALE;
+    return (current_scale * glyph->xadvance) * X_SCALE;
 }
 
 static void
-_font_bmf_draw_string(int x1, int y1, uint32_t color, const char* str) {
-    current_color = color;
-    charbuffered = 0;
-    z_inc();
-
-    unsigned char prev = 0;
-    do {
-        unsigned char chr = *str;
+_font_bmf_layout_line(int x1, int y1, const char* str) {
+    uint32_t prev = 0;
+    while (*str) {
+        const uint32_t chr = utf8_next(&str);
         if (chr != ' ') {
             /* Add possible kerning adjustment */
             x1 += round(current_scale * BMF_adjust_kerning(prev, chr, &font_basilea));
-            x1 += font_bmf_draw_char(x1, y1, chr);
+            x1 += font_bmf_draw_char(x1, y1, BMF_get_char(&font_basilea, chr));
         } else {
             x1 += round(current_scale * (float)font_basilea.chars[' '].width);
         }
 
         prev = chr;
-    } while (*++str);
+    }
+}
 
-    pvr_prim(charbuf, charbuffered * sizeof(charbuf[0]));
+static void
+_font_bmf_layout_wrap(int x1, int y1, const char* str, const text_lines* lines) {
+    for (int i = 0; i < lines->count; i++) {
+        const char* current_text_temp = str + lines->line[i].start;
+        const char* row_end = str + lines->line[i].end;
+        int x = x1;
+        uint32_t prev = 0;
+
+        do {
+            const uint32_t chr = utf8_next(&current_text_temp);
+            if (chr != ' ') {
+                /* Add possible kerning adjustment */
+                x += round(current_scale * BMF_adjust_kerning(prev, chr, &font_basilea));
+                x += font_bmf_draw_char(x, y1, BMF_get_char(&font_basilea, chr));
+            } else {
+                x += round(current_scale * (float)font_basilea.chars[' '].width);
+            }
+            prev = chr;
+        } while (current_text_temp < row_end);
+
+        /* prepare for next row */
+        y1 += (current_scale * font_basilea.lineHeight * 1.2f /* Makes Text more natural */);
+    }
 }
 
 static float
-_font_bmf_calculate_length_full(const char* str, int length) {
+_font_bmf_measure(const char* str) {
     /* Not sure if its worth calculating kerning for this */
     float width = 0;
-    char prev = 0;
-    bm_font* font = &font_basilea;
-    int cursor = 0;
+    uint32_t prev = 0;
 
-    while (*str && cursor++ < length) {
-        int chr = *str;
+    while (*str) {
+        const uint32_t chr = utf8_next(&str);
         /* Add possible kerning adjustment */
-        width += BMF_adjust_kerning(prev, chr, &font_basilea); /* slow */
-        width += font->chars[chr].xadvance;
+        width += BMF_adjust_kerning(prev, chr, &font_basilea);
+        width += BMF_get_char(&font_basilea, chr)->xadvance;
 
         prev = chr;
-        str++;
     }
 
     return round(current_scale * round(width)) * X_SCALE;
 }
 
+/* Splits str into the longest rows broken by spaces that fit in width */
+static void
+_font_bmf_break_rows(const char* str, int width, text_lines* lines) {
+    const char* text_end = strrchr(str, '\0');
+    const char* current_text_start = str;
+
+    lines->count = 0;
+    while (current_text_start < text_end && lines->count < TEXT_LINES_MAX) {
+        float current_text_width = 0.0f;
+        float row_width = 0.0f;
+        float overflow_width = 0.0f;
+        const char* current_text_temp = current_text_start;
+        const char* row_end = NULL;
+        const char* overflow = current_text_start;
+        uint32_t prev = ' ';
+        do {
+            const char* current_text_pos = current_text_temp;
+            if (current_text_pos >= text_end) {
+                row_end = text_end;
+                row_width = current_text_width;
+                break;
+            }
+            const uint32_t current_char = utf8_next(&current_text_temp);
+            if (current_char == ' ') {
+                row_end = current_text_pos;
+                row_width = current_text_width;
+            }
+            if (current_char == '\n') {
+                /* not space but safe breaking point */
+                row_end = current_text_pos;
+                row_width = current_text_width;
+                break;
+            }
+            overflow = current_text_pos;
+            overflow_width = current_text_width;
+            current_text_width +=
+                (int)((current_scale * BMF_get_char(&font_basilea, current_char)->xadvance) * X_SCALE);
+            current_text_width += round(current_scale * BMF_adjust_kerning(prev, current_char, &font_basilea));
+            prev = current_char;
+        } while (current_text_width < width);
+
+        /* Nowhere to break, a word wider than the row or text without spaces
+         * like Japanese, so the row ends at the char that didnt fit */
+        const char* next_start;
+        if (row_end) {
+            next_start = row_end + 1;
+        } else if (overflow > current_text_start) {
+            row_end = next_start = overflow;
+            row_width = overflow_width;
+        } else {
+            row_end = next_start = current_text_temp;
+            row_width = current_text_width;
+        }
+
+        lines->line[lines->count++] = (text_line){
+            .start = current_text_start - str,
+            .end = row_end - str,
+            .width = row_width,
+        };
+        current_text_start = next_start;
+    }
+}
+
+/* Rows of str at the current scale, wrapped at width or a single row for 0.
+ * Only measured when the text cache hasnt kept them already. */
+static const text_lines*
+_font_bmf_get_lines(const char* str, int width) {
+    static text_line rows[TEXT_LINES_MAX];
+    static text_lines lines = {.count = 0, .line = rows};
+
+    const text_lines* kept = text_cache_find_lines(TEXT_FONT_BMF, str, current_scale, width);
+    if (kept) {
+        return kept;
+    }
+    if (width) {
+        _font_bmf_break_rows(str, width, &lines);
+    } else {
+        rows[0] = (text_line){.start = 0, .end = strlen(str), .width = _font_bmf_measure(str)};
+        lines.count = 1;
+    }
+
+    return text_cache_keep_lines(TEXT_FONT_BMF, str, current_scale, width, &lines);
+}
+
 static float
 _font_bmf_calculate_length(const char* str) {
-    return _font_bmf_calculate_length_full(str, strlen(str));
+    return _font_bmf_get_lines(str, 0)->line[0].width;
+}
+
+/* Starts on the page whose header is up, then goes through any other page
+ * the text turned out to use. Every row shares the header, they go out together. */
+static void
+_font_bmf_layout(int x1, int y1, const char* str, int width) {
+    unsigned int pages_done = 0;
+    const text_lines* lines = width ? _font_bmf_get_lines(str, width) : NULL;
+
+    charbuffered = 0;
+    layout_page = header_page;
+    layout_pages_seen = 0;
+
+    for (;;) {
+        if (lines) {
+            _font_bmf_layout_wrap(x1, y1, str, lines);
+        } else {
+            _font_bmf_layout_line(x1, y1, str);
+        }
+        font_bmf_flush_chars();
+
+        pages_done |= 1u << layout_page;
+        const unsigned int pages_left = layout_pages_seen & ~pages_done;
+        if (!pages_left) {
+            break;
+        }
+        for (layout_page = 0; !(pages_left & (1u << layout_page)); layout_page++) {}
+        font_bmf_use_page(layout_page);
+    }
+}
+
+static void
+_font_bmf_draw_string(int x1, int y1, uint32_t color, const char* str) {
+    current_color = color;
+    z_inc();
+    if (font_bmf_draw_cached(x1, y1, str, 0)) {
+        return;
+    }
+    _font_bmf_layout(x1, y1, str, 0);
 }
 
 void
@@ -658,63 +1237,8 @@ void
 font_bmf_draw_sub_wrap(int x1, int y1, uint32_t color, const char* str, int width) {
     z_inc();
     current_color = color;
-    unsigned char prev = ' ';
-    unsigned int current_char = 0;
-
-    const int x_start = x1;
-    const char* text_end = strrchr(str, '\0');
-    const char* current_text_start = str;
-    const char* current_text_temp = str;
-    const char* last_known_space = str;
-    int current_text_len = 0;
-
-    do {
-        /* Try to find longest string broken by spaces that will fit in width */
-        float current_text_width = 0.0f;
-        prev = ' ';
-        do {
-            current_char = *(current_text_start + current_text_len);
-            if (current_char == ' ') {
-                last_known_space = current_text_start + current_text_len;
-            }
-            if (current_char == '\n') {
-                /* not space but safe breaking point */
-                last_known_space = current_text_start + current_text_len;
-                break;
-            }
-            if (current_text_start + current_text_len >= text_end) {
-                last_known_space = text_end;
-                break;
-            }
-            current_text_width += (int)((current_scale * font_basilea.chars[current_char].xadvance) * X_SCALE);
-            current_text_width += round(current_scale * BMF_adjust_kerning(prev, current_char, &font_basilea));
-            prev = current_char;
-            current_text_len++;
-        } while (current_text_width < width);
-
-        current_text_temp = current_text_start;
-        charbuffered = 0;
-        prev = 0;
-
-        do {
-            unsigned char chr = (*current_text_temp++);
-            if (chr != ' ') {
-                /* Add possible kerning adjustment */
-                x1 += round(current_scale * BMF_adjust_kerning(prev, chr, &font_basilea));
-                x1 += font_bmf_draw_char(x1, y1, chr);
-            } else {
-                x1 += round(current_scale * (float)font_basilea.chars[' '].width);
-            }
-            prev = chr;
-        } while (current_text_temp < last_known_space);
-
-        pvr_prim(charbuf, charbuffered * sizeof(charbuf[0]));
-
-        /* prepare for next row */
-        y1 += (current_scale * font_basilea.lineHeight * 1.2f /* Makes Text more natural */);
-        x1 = x_start;
-        current_text_start = last_known_space + 1;
-        current_text_len = 0;
-        prev = 0;
-    } while (current_text_start < text_end);
+    if (font_bmf_draw_cached(x1, y1, str, width)) {
+        return;
+    }
+    _font_bmf_layout(x1, y1, str, width);
 }
@@ -7,7 +7,9 @@
  * Copyright (c) 2019 Hayden Kowalchuk
  */
 
+#include <ctype.h>
 #include <kos/fs.h>
+#include <malloc.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -15,64 +17,92 @@
 
 #define PVR_HDR_SIZE 0x20
 
-static unsigned char* _internal_buf = NULL;
+/* 256 entries of 2x2 16bit texels, the hardware expects the indices right after */
+#define PVR_VQ_CODEBOOK_SIZE (256 * 4 * 2)
+
+/* Extra data follows the texture as blocks of a 4 character tag, u32 size and
+ * size bytes. Paletted textures have "PVPL": u16 format, u16 count and count
+ * ARGB1555 entries. */
+#define PVR_BLOCK_HDR_SIZE (8)
+#define PVR_PAL_HDR_SIZE   (4)
+#define PVR_BLOCKS_MAX     (4)
+
+static unsigned char* _stream_block = NULL;
 static char filename_safe[128];
 
+/* Small VQ files only store as many codebook entries as the size can use */
 static uint32_t
-pvr_get_texture_size(const void* input, uint32_t* w, uint32_t* h, uint32_t* txrFormat) {
+pvr_small_vq_codebook_size(int texW) {
+    if (texW <= 16) {
+        return 16 * 4 * 2;
+    } else if (texW == 32) {
+        return 32 * 4 * 2;
+    } else if (texW == 64) {
+        return 128 * 4 * 2;
+    }
+    return PVR_VQ_CODEBOOK_SIZE;
+}
+
+/* Returns the size in vram, codebook is set to the codebook bytes in the file
+ * (0 for anything not VQ) */
+static uint32_t
+pvr_parse_header(const void* input, uint32_t* w, uint32_t* h, uint32_t* txrFormat, uint32_t* codebook) {
     unsigned char* texBuf = (unsigned char*)input;
 
     const int texW = texBuf[PVR_HDR_SIZE - 4] | texBuf[PVR_HDR_SIZE - 3] << 8;
     const int texH = texBuf[PVR_HDR_SIZE - 2] | texBuf[PVR_HDR_SIZE - 1] << 8;
     int texFormat = 0, texColor = 0;
-    int bpp = 2;
+    int bits = 16; /* per texel */
 
     switch ((unsigned int)texBuf[PVR_HDR_SIZE - 8]) {
         case 0x00:
             texColor = PVR_TXRFMT_ARGB1555;
-            bpp = 2;
+            bits = 16;
             break; //(bilevel translucent alpha 0,255)
 
         case 0x01:
             texColor = PVR_TXRFMT_RGB565;
-            bpp = 2;
+            bits = 16;
             break; //(non translucent RGB565 )
 
         case 0x02:
             texColor = PVR_TXRFMT_ARGB4444;
-            bpp = 2;
+            bits = 16;
             break; //(translucent alpha 0-255)
 
         case 0x03:
             texColor = PVR_TXRFMT_YUV422;
-            bpp = 1;
+            bits = 16;
             break; //(non translucent UYVY )
 
         case 0x04:
             texColor = PVR_TXRFMT_BUMP;
-            bpp = 2;
+            bits = 16;
             break; //(special bump-mapping format)
 
         case 0x05:
             texColor = PVR_TXRFMT_PAL4BPP;
-            bpp = 1;
+            bits = 4;
             break; //(4-bit palleted texture)
 
         case 0x06:
             texColor = PVR_TXRFMT_PAL8BPP;
-            bpp = 1;
+            bits = 8;
             break; //(8-bit palleted texture)
 
         default:
             texColor = PVR_TXRFMT_RGB565;
-            bpp = 2;
+            bits = 16;
             break;
     }
 
     switch ((unsigned int)texBuf[PVR_HDR_SIZE - 7]) {
         case 0x01: texFormat = PVR_TXRFMT_TWIDDLED; break; // SQUARE TWIDDLED
 
-        case 0x03: texFormat = PVR_TXRFMT_VQ_ENABLE; break; // VQ TWIDDLED
+        case 0x03:
+            texFormat = PVR_TXRFMT_TWIDDLED | PVR_TXRFMT_VQ_ENABLE;
+            *codebook = PVR_VQ_CODEBOOK_SIZE;
+            break; // VQ TWIDDLED
 
         case 0x09: texFormat = PVR_TXRFMT_NONTWIDDLED; break; // RECTANGLE
 
@@ -80,12 +110,16 @@ pvr_get_texture_size(const void* input, uint32_t* w, uint32_t* h, uint32_t* txrF
 
         case 0x0D: texFormat = PVR_TXRFMT_TWIDDLED; break; // RECTANGULAR TWIDDLED
 
-        case 0x10: texFormat = PVR_TXRFMT_VQ_ENABLE | PVR_TXRFMT_NONTWIDDLED; break; // SMALL VQ
+        case 0x10:
+            texFormat = PVR_TXRFMT_TWIDDLED | PVR_TXRFMT_VQ_ENABLE;
+            *codebook = pvr_small_vq_codebook_size(texW);
+            break; // SMALL VQ TWIDDLED
 
         default: texFormat = PVR_TXRFMT_NONE; break;
     }
 
-    const int txr_size = texW * texH * bpp;
+    /* VQ stores one byte per 2x2 block, always behind a full size codebook in vram */
+    const int txr_size = *codebook ? PVR_VQ_CODEBOOK_SIZE + (texW * texH) / 4 : (texW * texH * bits) / 8;
     *w = texW;
     *h = texH;
     *txrFormat = texFormat | texColor;
@@ -93,12 +127,225 @@ pvr_get_texture_size(const void* input, uint32_t* w, uint32_t* h, uint32_t* txrF
     return txr_size;
 }
 
+uint32_t
+pvr_get_texture_size(const void* input, uint32_t* w, uint32_t* h, uint32_t* txrFormat) {
+    uint32_t codebook = 0;
+    return pvr_parse_header(input, w, h, txrFormat, &codebook);
+}
+
+const void*
+pvr_get_block(const void* input, const char* tag, uint32_t* size) {
+    uint32_t w, h, format;
+    const unsigned char* blocks
+        = (const unsigned char*)input + PVR_HDR_SIZE + pvr_get_texture_size(input, &w, &h, &format);
+    return pvr_find_block(blocks, tag, size);
+}
+
+const void*
+pvr_find_block(const void* blocks, const char* tag, uint32_t* size) {
+    const unsigned char* block = (const unsigned char*)blocks;
+
+    /* Only a handful are ever written, stop at anything that isn't one */
+    for (int i = 0; i < PVR_BLOCKS_MAX; i++) {
+        if (!isalpha(block[0]) || !isalpha(block[1]) || !isalpha(block[2]) || !isalpha(block[3])) {
+            break;
+        }
+        const uint32_t block_size = block[4] | block[5] << 8 | block[6] << 16 | (uint32_t)block[7] << 24;
+        if (!strncmp((const char*)block, tag, 4)) {
+            if (size) {
+                *size = block_size;
+            }
+            return block + PVR_BLOCK_HDR_SIZE;
+        }
+        block += PVR_BLOCK_HDR_SIZE + block_size;
+    }
+    return NULL;
+}
+
+const uint16_t*
+pvr_get_palette(const void* input, int* count) {
+    const unsigned char* texBuf = (const unsigned char*)input;
+    const unsigned char* pal;
+
+    /* 0x05 and 0x06 are the paletted color types */
+    if (texBuf[PVR_HDR_SIZE - 8] != 0x05 && texBuf[PVR_HDR_SIZE - 8] != 0x06) {
+        return NULL;
+    }
+    if (!(pal = pvr_get_block(input, "PVPL", NULL))) {
+        return NULL;
+    }
+    *count = pal[2] | pal[3] << 8;
+    return (const uint16_t*)(pal + PVR_PAL_HDR_SIZE);
+}
+
+/* PVR twiddling interleaves the bits of both coordinates, y in the low bit */
+static uint32_t
+pvr_twiddle_offset(uint32_t x, uint32_t y) {
+    uint32_t offset = 0;
+    for (int bit = 0; (x | y) >> bit; bit++) {
+        offset |= ((y >> bit) & 1) << (bit * 2);
+        offset |= ((x >> bit) & 1) << (bit * 2 + 1);
+    }
+    return offset;
+}
+
+int
+pvr_stream_open(pvr_stream* stream, file_t fd, uint32_t start, uint32_t length) {
+    unsigned char header[PVR_HDR_SIZE];
+    uint32_t header_size = PVR_HDR_SIZE;
+    uint32_t codebook = 0;
+
+    memset(stream, '\0', sizeof(pvr_stream));
+    if (length < PVR_HDR_SIZE) {
+        return 0;
+    }
+    fs_seek(fd, start, SEEK_SET);
+    if (fs_read(fd, header, PVR_HDR_SIZE) != PVR_HDR_SIZE) {
+        return 0;
+    }
+
+    /* Same as load_pvr, the GBIX part is optional */
+    if (strncmp((char*)header, "GBIX", 4)) {
+        memmove(header + PVR_HDR_SIZE / 2, header, PVR_HDR_SIZE / 2);
+        memset(header, '\0', PVR_HDR_SIZE / 2);
+        header_size = PVR_HDR_SIZE / 2;
+    }
+    if (strncmp((char*)header + PVR_HDR_SIZE / 2, "PVRT", 4)) {
+        return 0;
+    }
+    stream->size = pvr_parse_header(header, &stream->width, &stream->height, &stream->format, &codebook);
+    stream->pad = (codebook && codebook < PVR_VQ_CODEBOOK_SIZE) ? PVR_VQ_CODEBOOK_SIZE - codebook : 0;
+    stream->remaining = stream->size - stream->pad;
+    if (!stream->size || header_size + stream->remaining > length) {
+        return 0;
+    }
+    stream->fd = fd;
+    stream->next = start + header_size;
+
+    /* The palette comes after the texture, read ahead since it decides where the texture goes */
+    if (header[PVR_HDR_SIZE - 8] == 0x05 || header[PVR_HDR_SIZE - 8] == 0x06) {
+        unsigned char pal[PVR_BLOCK_HDR_SIZE + PVR_PAL_HDR_SIZE];
+        const uint32_t left = length - header_size - stream->remaining;
+
+        fs_seek(fd, stream->next + stream->remaining, SEEK_SET);
+        if (left < sizeof(pal) || fs_read(fd, pal, sizeof(pal)) != sizeof(pal) || strncmp((char*)pal, "PVPL", 4)) {
+            return 1;
+        }
+        int count = pal[PVR_BLOCK_HDR_SIZE + 2] | pal[PVR_BLOCK_HDR_SIZE + 3] << 8;
+        if (count > PVR_STREAM_PALETTE_MAX || sizeof(pal) + count * sizeof(uint16_t) > left) {
+            return 1;
+        }
+        if (fs_read(fd, stream->palette, count * sizeof(uint16_t)) == (ssize_t)(count * sizeof(uint16_t))) {
+            stream->palette_count = count;
+        }
+    }
+    return 1;
+}
+
+int
+pvr_stream_read(pvr_stream* stream, void* block) {
+    /* The first block is short by a header so every later one starts block aligned */
+    uint32_t len = PVR_STREAM_BLOCK_SIZE - (stream->read + PVR_HDR_SIZE) % PVR_STREAM_BLOCK_SIZE;
+
+    if (!stream->remaining) {
+        return 0;
+    }
+    if (len > stream->remaining) {
+        len = stream->remaining;
+    }
+    fs_seek(stream->fd, stream->next, SEEK_SET);
+    if (fs_read(stream->fd, block, len) != (ssize_t)len) {
+        stream->remaining = 0;
+        stream->failed = 1;
+        return -1;
+    }
+    stream->next += len;
+    stream->read += len;
+    stream->remaining -= len;
+    return (int)len;
+}
+
+void
+pvr_stream_upload(pvr_stream* stream, const pvr_stream_dest* dest, const void* block, uint32_t len) {
+    const unsigned char* src = (const unsigned char*)block;
+
+    while (len) {
+        uint32_t run = len;
+        unsigned char* dst = dest->base + stream->uploaded;
+
+        if (dest->row) {
+            const uint32_t in_row = stream->uploaded % dest->row;
+            if (run > dest->row - in_row) {
+                run = dest->row - in_row;
+            }
+            dst = dest->base + (stream->uploaded / dest->row) * dest->pitch + in_row;
+        }
+        pvr_txr_load(src, (pvr_ptr_t)dst, run);
+        src += run;
+        len -= run;
+        stream->uploaded += run;
+    }
+}
+
+int
+pvr_stream_load(pvr_stream* stream, const pvr_stream_dest* dest, void* block) {
+    int len;
+
+    while ((len = pvr_stream_read(stream, block)) > 0) {
+        pvr_stream_upload(stream, dest, block, (uint32_t)len);
+    }
+    return pvr_stream_complete(stream);
+}
+
+void
+pvr_stream_dest_buffer(const pvr_stream* stream, void* buffer, pvr_stream_dest* dest) {
+    /* Small codebooks go at the end of the full size area, so the indices
+     * following them in the file land where the hardware looks */
+    dest->base = (unsigned char*)buffer + stream->pad;
+    dest->row = dest->pitch = 0;
+}
+
+int
+pvr_stream_dest_page(const pvr_stream* stream, void* page, uint32_t page_size, uint32_t x, uint32_t y,
+                     pvr_stream_dest* dest) {
+    const uint32_t w = stream->width;
+    const uint32_t bits = (stream->size * 8) / (w * stream->height);
+
+    if ((stream->format & PVR_TXRFMT_VQ_ENABLE) || w != stream->height || (x | y) & (w - 1)) {
+        return 0;
+    }
+
+    if (!(stream->format & PVR_TXRFMT_NONTWIDDLED)) {
+        /* An aligned square of a twiddled page is one run in the same order */
+        dest->base = (unsigned char*)page + pvr_twiddle_offset(x, y) * bits / 8;
+        dest->row = dest->pitch = 0;
+        return 1;
+    }
+
+    /* Rows have to suit the store queues */
+    dest->row = w * bits / 8;
+    if (dest->row & 31) {
+        return 0;
+    }
+    dest->pitch = page_size * bits / 8;
+    dest->base = (unsigned char*)page + (y * page_size + x) * bits / 8;
+    return 1;
+}
+
 pvr_ptr_t
 load_pvr_from_buffer_to_buffer(const void* input, uint32_t* w, uint32_t* h, uint32_t* txrFormat, void* buffer) {
     unsigned char* texBuf = (unsigned char*)input;
-    uint32_t txr_size = pvr_get_texture_size(input, w, h, txrFormat);
-
-    pvr_txr_load(texBuf + PVR_HDR_SIZE, (pvr_ptr_t)buffer, txr_size);
+    uint32_t codebook = 0;
+    uint32_t txr_size = pvr_parse_header(input, w, h, txrFormat, &codebook);
+
+    if (codebook && codebook < PVR_VQ_CODEBOOK_SIZE) {
+        /* Small codebooks go at the end of the full size area, so the indices
+         * following them in the file land where the hardware looks */
+        const uint32_t pad = PVR_VQ_CODEBOOK_SIZE - codebook;
+        pvr_txr_load(texBuf + PVR_HDR_SIZE, (pvr_ptr_t)((unsigned char*)buffer + pad), txr_size - pad);
+    } else {
+        pvr_txr_load(texBuf + PVR_HDR_SIZE, (pvr_ptr_t)buffer, txr_size);
+    }
 
     return buffer;
 }
@@ -106,7 +353,6 @@ load_pvr_from_buffer_to_buffer(const void* input, uint32_t* w, uint32_t* h, uint
 pvr_ptr_t
 load_pvr_from_buffer(const void* input, uint32_t* w, uint32_t* h, uint32_t* txrFormat) {
     pvr_ptr_t rv;
-    unsigned char* texBuf = (unsigned char*)input;
     uint32_t txr_size = pvr_get_texture_size(input, w, h, txrFormat);
 
     if (!txr_size) {
@@ -117,26 +363,23 @@ load_pvr_from_buffer(const void* input, uint32_t* w, uint32_t* h, uint32_t* txrF
         printf("PVR: Couldn't allocate memory for texture!\n");
         return NULL;
     }
-    pvr_txr_load(texBuf + PVR_HDR_SIZE, rv, txr_size);
-
-    return rv;
+    return load_pvr_from_buffer_to_buffer(input, w, h, txrFormat, rv);
 }
 
 void*
-pvr_get_internal_buffer(void) {
-    if (!_internal_buf) {
-        _internal_buf = malloc(512 * 512 * 2);
-        if (!_internal_buf) {
+pvr_get_stream_block(void) {
+    if (!_stream_block) {
+        _stream_block = memalign(32, PVR_STREAM_BLOCK_SIZE);
+        if (!_stream_block) {
             printf("%s no free memory\n", __func__);
             return NULL;
         }
     }
-    return _internal_buf;
+    return _stream_block;
 }
 
-static void
-pvr_read_to_internal(const char* filename) {
-    uint32_t texSize;
+static file_t
+pvr_open_cd(const char* filename) {
     file_t tex_fd;
     snprintf(filename_safe, 127, "/cd/%s", filename);
 
@@ -148,41 +391,62 @@ pvr_read_to_internal(const char* filename) {
         }
     }
 
-    unsigned char* texBuf = pvr_get_internal_buffer();
-    memset(texBuf, '\0', PVR_HDR_SIZE);
-
     tex_fd = fs_open(filename_safe, O_RDONLY);
     if (tex_fd == -1) {
         printf("PVR:Error opening %s!\n", filename_safe);
-        return;
     }
+    return tex_fd;
+}
 
-    fs_seek(tex_fd, 0, SEEK_END);
-    texSize = fs_tell(tex_fd);
+static void*
+pvr_alloc_default(uint32_t size, void* user) {
+    (void)user;
+    return pvr_mem_malloc(size);
+}
 
-    fs_seek(tex_fd, 0, SEEK_SET);
-    fs_read(tex_fd, texBuf, PVR_HDR_SIZE / 2);
+/* Reads the file a block at a time straight into buffer, or memory from alloc if NULL */
+static pvr_ptr_t
+pvr_stream_file(const char* filename, uint32_t* w, uint32_t* h, uint32_t* txrFormat, void* buffer,
+                pvr_alloc_cb alloc, void* user) {
+    void* block = pvr_get_stream_block();
+    pvr_stream stream;
+    pvr_stream_dest dest;
+    file_t tex_fd;
 
-    if (!strncmp((char*)texBuf, "GBIX", 4)) {
-        fs_read(tex_fd, texBuf + (PVR_HDR_SIZE / 2), texSize - (PVR_HDR_SIZE / 2));
-    } else {
-        fs_seek(tex_fd, 0, SEEK_SET);
-        fs_read(tex_fd, texBuf + (PVR_HDR_SIZE / 2), texSize);
+    if (!block || (tex_fd = pvr_open_cd(filename)) == -1) {
+        return NULL;
     }
-
+    if (!pvr_stream_open(&stream, tex_fd, 0, fs_total(tex_fd))) {
+        printf("PVR:%s is not a texture!\n", filename);
+        fs_close(tex_fd);
+        return NULL;
+    }
+    if (!buffer && !(buffer = (*alloc)(stream.size, user))) {
+        printf("PVR: Couldn't allocate memory for texture!\n");
+        fs_close(tex_fd);
+        return NULL;
+    }
+    pvr_stream_dest_buffer(&stream, buffer, &dest);
+    pvr_stream_load(&stream, &dest, block);
     fs_close(tex_fd);
+
+    *w = stream.width;
+    *h = stream.height;
+    *txrFormat = stream.format;
+    return buffer;
 }
 
 pvr_ptr_t
 load_pvr(const char* filename, uint32_t* w, uint32_t* h, uint32_t* txrFormat) {
-    pvr_read_to_internal(filename);
-
-    return load_pvr_from_buffer(_internal_buf, w, h, txrFormat);
+    return pvr_stream_file(filename, w, h, txrFormat, NULL, pvr_alloc_default, NULL);
 }
 
 pvr_ptr_t
 load_pvr_to_buffer(const char* filename, uint32_t* w, uint32_t* h, uint32_t* txrFormat, void* buffer) {
-    pvr_read_to_internal(filename);
+    return pvr_stream_file(filename, w, h, txrFormat, buffer, NULL, NULL);
+}
 
-    return load_pvr_from_buffer_to_buffer(_internal_buf, w, h, txrFormat, buffer);
+pvr_ptr_t
+load_pvr_alloc(const char* filename, uint32_t* w, uint32_t* h, uint32_t* txrFormat, pvr_alloc_cb alloc, void* user) {
+    return pvr_stream_file(filename, w, h, txrFormat, NULL, alloc, user);
 }
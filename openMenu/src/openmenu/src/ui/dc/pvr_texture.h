@@ -10,6 +10,7 @@
 #pragma once
 
 #include <dc/pvr.h>
+#include <kos/fs.h>
 #include <stdint.h>
 
 /* Offset and dimensions of each sprite within a spritesheet (romdisk/foo.txt file) */
@@ -18,13 +19,78 @@ typedef struct image {
     uint32_t width, height;
     uint32_t format;
     pvr_ptr_t texture;
+    /* Images on a shared page, texture and format are the page's */
+    uint16_t atlas_x, atlas_y;
+    uint16_t atlas_size; /* page texels across, 0 for a texture of its own */
 } image;
 
-void* pvr_get_internal_buffer(void);
+/* Reads a PVR from a file a block at a time and uploads each block as it
+ * comes in, nothing bigger than a block is held in RAM. Blocks line up with
+ * the file from start on, the first is short by a header. */
+#define PVR_STREAM_BLOCK_SIZE  (16 * 1024)
+#define PVR_STREAM_PALETTE_MAX (256)
+
+typedef struct pvr_stream {
+    file_t fd;
+    uint32_t next;      /* file offset of the next block */
+    uint32_t read;      /* texture bytes read */
+    uint32_t remaining; /* texture bytes still in the file */
+    uint32_t uploaded;  /* texture bytes in vram */
+    int failed;
+    uint32_t width, height, format;
+    uint32_t size; /* in vram */
+    uint32_t pad;  /* small VQ codebooks start this far in */
+    int palette_count;
+    uint16_t palette[PVR_STREAM_PALETTE_MAX];
+} pvr_stream;
+
+/* Where texture data goes, rows of row bytes land pitch apart, one run if row is 0 */
+typedef struct pvr_stream_dest {
+    unsigned char* base;
+    uint32_t row, pitch;
+} pvr_stream_dest;
+
+/* Reads the header at start and the palette if there is one, length is what
+ * the file holds from start on. Returns 0 if it isn't a texture. */
+int pvr_stream_open(pvr_stream* stream, file_t fd, uint32_t start, uint32_t length);
+/* Next block into block, returns its length, 0 at the end and -1 if the read failed */
+int pvr_stream_read(pvr_stream* stream, void* block);
+/* Uploads the len bytes just read */
+void pvr_stream_upload(pvr_stream* stream, const pvr_stream_dest* dest, const void* block, uint32_t len);
+/* Reads and uploads the rest through block, returns pvr_stream_complete */
+int pvr_stream_load(pvr_stream* stream, const pvr_stream_dest* dest, void* block);
+
+static inline int
+pvr_stream_complete(const pvr_stream* stream) {
+    return !stream->failed && stream->uploaded == stream->size - stream->pad;
+}
+
+/* Destination for a texture of its own at buffer */
+void pvr_stream_dest_buffer(const pvr_stream* stream, void* buffer, pvr_stream_dest* dest);
+/* Destination for a square texture on a page of the same format and page_size
+ * texels across at x, y, which have to be a multiple of its size. VQ can't
+ * share a page, returns 0 for anything that doesn't fit. */
+int pvr_stream_dest_page(const pvr_stream* stream, void* page, uint32_t page_size, uint32_t x, uint32_t y,
+                         pvr_stream_dest* dest);
+/* Block for streams read on the main thread */
+void* pvr_get_stream_block(void);
+
+/* Reads the header of a PVR in memory, returns the texture data size */
+uint32_t pvr_get_texture_size(const void* input, uint32_t* w, uint32_t* h, uint32_t* txrFormat);
+/* Block of extra data stored after the texture, NULL if there is no tag */
+const void* pvr_get_block(const void* input, const char* tag, uint32_t* size);
+/* Same, for blocks already read somewhere else */
+const void* pvr_find_block(const void* blocks, const char* tag, uint32_t* size);
+/* Palette stored after the texture data, NULL if not paletted */
+const uint16_t* pvr_get_palette(const void* input, int* count);
 /* Convenience functions */
 extern pvr_ptr_t load_pvr(const char* filename, uint32_t* w, uint32_t* h, uint32_t* txrFormat);
 extern pvr_ptr_t load_pvr_to_buffer(const char* filename, uint32_t* w, uint32_t* h, uint32_t* txrFormat, void* buffer);
 extern pvr_ptr_t load_pvr_from_buffer(const void* input, uint32_t* w, uint32_t* h, uint32_t* txrFormat);
+/* Memory for the texture comes from alloc once its size is known, NULL from it fails the load */
+typedef void* (*pvr_alloc_cb)(uint32_t size, void* user);
+extern pvr_ptr_t load_pvr_alloc(const char* filename, uint32_t* w, uint32_t* h, uint32_t* txrFormat, pvr_alloc_cb alloc,
+                                void* user);
 
 /* base method */
 extern pvr_ptr_t load_pvr_from_buffer_to_buffer(const void* input, uint32_t* w, uint32_t* h, uint32_t* txrFormat,
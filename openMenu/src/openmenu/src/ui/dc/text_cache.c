@@ -0,0 +1,395 @@
+/*
+ * File: text_cache.c
+ * Project: ui
+ * File Created: Sunday, 18th October 2026 11:52:37 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "text_cache.h"
+
+/* Enough for every string on screen in the busiest UI, vertices are sized to
+ * their run and the budget bounds them all */
+#define TEXT_CACHE_RUNS    (128)
+#define TEXT_CACHE_BUCKETS (256)
+#define TEXT_CACHE_BYTES   (192 * 1024)
+#define TEXT_RUN_NONE      (0) /* runs link by number, one past their index */
+#define TEXT_RUN_MIN_VERTS (16)
+#define TEXT_RUN_SEGMENTS  (4)
+#define TEXT_BREAK_SETS    (64)
+#define TEXT_CACHE_SEEN    (256) /* strings laid out once, by hash */
+
+typedef struct text_segment {
+    int page;
+    int count;
+} text_segment;
+
+struct text_run {
+    char* str; /* NULL when free */
+    text_vertex* verts;
+    int count, capacity;
+    text_segment segments[TEXT_RUN_SEGMENTS];
+    int num_segments;
+    uint32_t hash;
+    float scale;
+    int width;
+    text_font font;
+    int16_t next; /* in the same bucket */
+    uint32_t used;
+    /* where the kept vertices are */
+    int x, y;
+    float z;
+    uint32_t color;
+};
+
+/* Rows of a string, kept apart from runs as measuring alone needs them and
+ * they are a fraction of the size */
+typedef struct text_breaks {
+    char* str; /* NULL when free */
+    text_lines lines;
+    uint32_t hash;
+    float scale;
+    int width;
+    text_font font;
+    int16_t next; /* in the same bucket */
+    uint32_t used;
+} text_breaks;
+
+static text_run runs[TEXT_CACHE_RUNS];
+static int16_t buckets[TEXT_CACHE_BUCKETS];
+static text_breaks break_sets[TEXT_BREAK_SETS];
+static int16_t break_buckets[TEXT_CACHE_BUCKETS];
+static uint32_t seen_runs[TEXT_CACHE_SEEN];
+static uint32_t seen_breaks[TEXT_CACHE_SEEN];
+static uint32_t use_clock;
+static text_cache_stats stats;
+
+static uint32_t
+_text_hash(text_font font, const char* str, float scale, int width) {
+    uint32_t hash = 2166136261u;
+    uint32_t scale_bits;
+
+    while (*str) {
+        hash = (hash ^ (unsigned char)*str++) * 16777619u;
+    }
+    memcpy(&scale_bits, &scale, sizeof(scale_bits));
+    hash ^= scale_bits * 0x9E3779B1u;
+    hash ^= ((uint32_t)width << 8) ^ (uint32_t)font;
+    return hash ^ (hash >> 16);
+}
+
+static inline int16_t*
+_text_bucket(uint32_t hash) {
+    return &buckets[hash & (TEXT_CACHE_BUCKETS - 1)];
+}
+
+static inline int16_t*
+_text_break_bucket(uint32_t hash) {
+    return &break_buckets[hash & (TEXT_CACHE_BUCKETS - 1)];
+}
+
+/* Text is only kept the second time it is laid out, so a string that changes
+ * every frame never pushes out the ones that don't */
+static int
+_text_seen_before(uint32_t* seen, uint32_t hash) {
+    uint32_t* entry = &seen[hash % TEXT_CACHE_SEEN];
+
+    if (*entry == hash) {
+        return 1;
+    }
+    *entry = hash;
+    return 0;
+}
+
+static void
+_text_run_remove(text_run* run) {
+    int16_t* link = _text_bucket(run->hash);
+    const int16_t num = (int16_t)(run - runs + 1);
+
+    while (*link != num) {
+        link = &runs[*link - 1].next;
+    }
+    *link = run->next;
+
+    stats.bytes -= run->capacity * sizeof(text_vertex);
+    stats.runs--;
+    free(run->str);
+    free(run->verts);
+    *run = (text_run){0};
+}
+
+/* Oldest run other than keep goes, 0 if there was none */
+static int
+_text_evict(const text_run* keep) {
+    text_run* oldest = NULL;
+
+    for (int i = 0; i < TEXT_CACHE_RUNS; i++) {
+        text_run* run = &runs[i];
+        if (run->str && run != keep && (!oldest || run->used < oldest->used)) {
+            oldest = run;
+        }
+    }
+    if (!oldest) {
+        return 0;
+    }
+    _text_run_remove(oldest);
+    stats.evictions++;
+    return 1;
+}
+
+text_run*
+text_cache_find(text_font font, const char* str, float scale, int width) {
+    const uint32_t hash = _text_hash(font, str, scale, width);
+
+    for (int16_t num = *_text_bucket(hash); num != TEXT_RUN_NONE; num = runs[num - 1].next) {
+        text_run* run = &runs[num - 1];
+        if (run->hash == hash && run->font == font && run->scale == scale && run->width == width
+            && !strcmp(run->str, str)) {
+            run->used = ++use_clock;
+            stats.hits++;
+            return run;
+        }
+    }
+    return NULL;
+}
+
+text_run*
+text_cache_begin(text_font font, const char* str, float scale, int width, int x, int y, float z, uint32_t color) {
+    const uint32_t hash = _text_hash(font, str, scale, width);
+    text_run* run = NULL;
+
+    if (!_text_seen_before(seen_runs, hash)) {
+        return NULL;
+    }
+
+    while (!run) {
+        for (int i = 0; i < TEXT_CACHE_RUNS && !run; i++) {
+            if (!runs[i].str) {
+                run = &runs[i];
+            }
+        }
+        if (!run) {
+            _text_evict(NULL);
+        }
+    }
+
+    const size_t len = strlen(str) + 1;
+    run->str = malloc(len);
+    if (!run->str) {
+        printf("%s no free memory\n", __func__);
+        return NULL;
+    }
+    memcpy(run->str, str, len);
+
+    run->hash = hash;
+    run->font = font;
+    run->scale = scale;
+    run->width = width;
+    run->used = ++use_clock;
+    run->x = x;
+    run->y = y;
+    run->z = z;
+    run->color = color;
+
+    int16_t* bucket = _text_bucket(run->hash);
+    run->next = *bucket;
+    *bucket = (int16_t)(run - runs + 1);
+    stats.runs++;
+    stats.layouts++;
+    return run;
+}
+
+int
+text_cache_append(text_run* run, int page, const text_vertex* verts, int count) {
+    if (!count) {
+        return 0;
+    }
+    if (!run->num_segments || run->segments[run->num_segments - 1].page != page) {
+        if (run->num_segments == TEXT_RUN_SEGMENTS) {
+            _text_run_remove(run);
+            return -1;
+        }
+        run->segments[run->num_segments++] = (text_segment){.page = page, .count = 0};
+    }
+    if (run->count + count > run->capacity) {
+        int capacity = run->capacity ? run->capacity * 2 : TEXT_RUN_MIN_VERTS;
+        while (capacity < run->count + count) {
+            capacity *= 2;
+        }
+
+        const unsigned int grow = (capacity - run->capacity) * sizeof(text_vertex);
+        while (stats.bytes + grow > TEXT_CACHE_BYTES && _text_evict(run)) {}
+
+        text_vertex* grown = stats.bytes + grow <= TEXT_CACHE_BYTES ? memalign(32, capacity * sizeof(text_vertex))
+                                                                    : NULL;
+        if (!grown) {
+            _text_run_remove(run);
+            return -1;
+        }
+        if (run->verts) {
+            memcpy(grown, run->verts, run->count * sizeof(text_vertex));
+            free(run->verts);
+        }
+        run->verts = grown;
+        run->capacity = capacity;
+        stats.bytes += grow;
+    }
+
+    memcpy(run->verts + run->count, verts, count * sizeof(text_vertex));
+    run->count += count;
+    run->segments[run->num_segments - 1].count += count;
+    return 0;
+}
+
+static void
+_text_run_move(text_run* run, int x, int y, float z, uint32_t color) {
+    const float dx = (float)(x - run->x);
+    const float dy = (float)(y - run->y);
+    text_vertex* vert = run->verts;
+
+    for (int i = 0; i < run->count; i++, vert++) {
+#ifdef KOS_SPRITE
+        vert->ax += dx;
+        vert->bx += dx;
+        vert->cx += dx;
+        vert->dx += dx;
+        vert->ay += dy;
+        vert->by += dy;
+        vert->cy += dy;
+        vert->dy += dy;
+        vert->az = vert->bz = vert->cz = z;
+        (void)color; /* sprites are colored by their header */
+#else
+        vert->x += dx;
+        vert->y += dy;
+        vert->z = z;
+        vert->argb = color;
+#endif
+    }
+    run->x = x;
+    run->y = y;
+    run->z = z;
+    run->color = color;
+}
+
+void
+text_cache_draw(text_run* run, int x, int y, float z, uint32_t color, text_page_cb use_page) {
+    const text_vertex* vert = run->verts;
+
+    if (run->x != x || run->y != y || run->z != z || run->color != color) {
+        _text_run_move(run, x, y, z, color);
+    }
+    for (int i = 0; i < run->num_segments; i++) {
+        if (use_page) {
+            use_page(run->segments[i].page);
+        }
+        pvr_prim(vert, run->segments[i].count * sizeof(text_vertex));
+        vert += run->segments[i].count;
+    }
+}
+
+static void
+_text_breaks_remove(text_breaks* set) {
+    int16_t* link = _text_break_bucket(set->hash);
+    const int16_t num = (int16_t)(set - break_sets + 1);
+
+    while (*link != num) {
+        link = &break_sets[*link - 1].next;
+    }
+    *link = set->next;
+
+    free(set->str);
+    free(set->lines.line);
+    *set = (text_breaks){0};
+}
+
+const text_lines*
+text_cache_find_lines(text_font font, const char* str, float scale, int width) {
+    const uint32_t hash = _text_hash(font, str, scale, width);
+
+    for (int16_t num = *_text_break_bucket(hash); num != TEXT_RUN_NONE; num = break_sets[num - 1].next) {
+        text_breaks* set = &break_sets[num - 1];
+        if (set->hash == hash && set->font == font && set->scale == scale && set->width == width
+            && !strcmp(set->str, str)) {
+            set->used = ++use_clock;
+            stats.break_hits++;
+            return &set->lines;
+        }
+    }
+    return NULL;
+}
+
+const text_lines*
+text_cache_keep_lines(text_font font, const char* str, float scale, int width, const text_lines* lines) {
+    const uint32_t hash = _text_hash(font, str, scale, width);
+    text_breaks* set = NULL;
+
+    if (!_text_seen_before(seen_breaks, hash)) {
+        return lines;
+    }
+
+    for (int i = 0; i < TEXT_BREAK_SETS; i++) {
+        if (!break_sets[i].str) {
+            set = &break_sets[i];
+            break;
+        }
+        if (!set || break_sets[i].used < set->used) {
+            set = &break_sets[i];
+        }
+    }
+    if (set->str) {
+        _text_breaks_remove(set);
+    }
+
+    const size_t len = strlen(str) + 1;
+    set->str = malloc(len);
+    set->lines.line = malloc((lines->count ? lines->count : 1) * sizeof(text_line));
+    if (!set->str || !set->lines.line) {
+        printf("%s no free memory\n", __func__);
+        free(set->str);
+        free(set->lines.line);
+        *set = (text_breaks){0};
+        return lines;
+    }
+    memcpy(set->str, str, len);
+    memcpy(set->lines.line, lines->line, lines->count * sizeof(text_line));
+    set->lines.count = lines->count;
+
+    set->hash = hash;
+    set->font = font;
+    set->scale = scale;
+    set->width = width;
+    set->used = ++use_clock;
+
+    int16_t* bucket = _text_break_bucket(set->hash);
+    set->next = *bucket;
+    *bucket = (int16_t)(set - break_sets + 1);
+    stats.breaks++;
+    return &set->lines;
+}
+
+void
+text_cache_clear(text_font font) {
+    for (int i = 0; i < TEXT_CACHE_RUNS; i++) {
+        if (runs[i].str && runs[i].font == font) {
+            _text_run_remove(&runs[i]);
+        }
+    }
+    for (int i = 0; i < TEXT_BREAK_SETS; i++) {
+        if (break_sets[i].str && break_sets[i].font == font) {
+            _text_breaks_remove(&break_sets[i]);
+        }
+    }
+}
+
+void
+text_cache_get_stats(text_cache_stats* out) {
+    *out = stats;
+}
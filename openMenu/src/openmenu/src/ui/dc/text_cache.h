@@ -0,0 +1,82 @@
+/*
+ * File: text_cache.h
+ * Project: ui
+ * File Created: Sunday, 18th October 2026 11:52:37 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <dc/pvr.h>
+
+/* Laid out text, kept as the vertices the fonts sent for it. A run is found
+ * by what decides its layout: font, string, scale and wrap width. Drawing it
+ * somewhere else, deeper or in another color patches the kept vertices in
+ * place, only new text is laid out again. Fonts with several page textures
+ * send a run a page at a time, each page is a segment of it. */
+
+#ifdef KOS_SPRITE
+typedef pvr_sprite_txr_t text_vertex;
+#else
+typedef pvr_vertex_t text_vertex;
+#endif
+
+typedef enum text_font { TEXT_FONT_BMF = 0, TEXT_FONT_BMP } text_font;
+
+typedef struct text_run text_run;
+
+/* Called before a segment is sent, to put its page's header in place */
+typedef void (*text_page_cb)(int page);
+
+typedef struct text_cache_stats {
+    unsigned int hits;
+    unsigned int layouts;   /* misses laid out and kept */
+    unsigned int evictions; /* runs pushed out to make room */
+    unsigned int runs;
+    unsigned int bytes;
+    unsigned int break_hits;
+    unsigned int breaks; /* strings broken into rows and kept */
+} text_cache_stats;
+
+/* Where text breaks into rows, found once per font, string, scale and wrap
+ * width. A row is a byte range of the string, width how far it was measured
+ * to reach. Text that isnt wrapped is a single row, its width is the length
+ * centering and fitting go by. */
+#define TEXT_LINES_MAX (48)
+
+typedef struct text_line {
+    int start, end;
+    float width;
+} text_line;
+
+typedef struct text_lines {
+    int count;
+    text_line* line;
+} text_lines;
+
+text_run* text_cache_find(text_font font, const char* str, float scale, int width);
+/* Keeps the layout about to be sent for str at x, y, z in color, NULL when it
+ * cant or str is laid out for the first time. The vertices follow through
+ * text_cache_append as they go out. */
+text_run* text_cache_begin(text_font font, const char* str, float scale, int width, int x, int y, float z,
+                           uint32_t color);
+/* Returns non zero if the run had to be dropped, dont use it afterwards */
+int text_cache_append(text_run* run, int page, const text_vertex* verts, int count);
+/* Sends a run, moved to x, y, z and colored first if it has to be. use_page
+ * may be NULL for fonts with a single page. */
+void text_cache_draw(text_run* run, int x, int y, float z, uint32_t color, text_page_cb use_page);
+
+const text_lines* text_cache_find_lines(text_font font, const char* str, float scale, int width);
+/* Keeps a copy of lines for str and returns it, or lines itself if it couldnt
+ * be kept or str is new. Either stays valid until the next call. */
+const text_lines* text_cache_keep_lines(text_font font, const char* str, float scale, int width,
+                                        const text_lines* lines);
+
+/* Drops everything laid out with font, for when it is loaded again */
+void text_cache_clear(text_font font);
+void text_cache_get_stats(text_cache_stats* stats);
@@ -11,8 +11,10 @@
 
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <backend/dat_format.h>
+#include "texture/vram_heap.h"
 #include "ui/draw_prototypes.h"
 #include "ui/font_prototypes.h"
 
@@ -72,13 +74,12 @@ z_inc(void) {
     return z_depth;
 }
 
-static void* pvr_scratch_buf;
-
 /* Called only once at start */
 void
 draw_init(void) {
-    pvr_scratch_buf = pvr_mem_malloc(TEXMAN_BUFFER_SIZE);
-    texman_reset(pvr_scratch_buf, TEXMAN_BUFFER_SIZE);
+    texman_init();
+    /* Held for good, every missing texture falls back to it whichever UI is up */
+    texman_acquire("EMPTY.PVR", &img_empty_boxart);
 
     z_reset();
 }
@@ -86,16 +87,13 @@ draw_init(void) {
 /* called at the start of each frame */
 void
 draw_setup(void) {
-    texman_reset(pvr_scratch_buf, TEXMAN_BUFFER_SIZE);
+    texman_clear();
 }
 
 void*
 draw_load_missing_icon(void* user) {
     image* img = (image*)user;
-    img->texture = img_empty_boxart.texture;
-    img->width = img_empty_boxart.width;
-    img->height = img_empty_boxart.height;
-    img->format = img_empty_boxart.format;
+    *img = img_empty_boxart;
     return img;
 }
 
@@ -107,13 +105,11 @@ draw_load_texture(const char* filename, void* user) {
     pvr_ptr_t txr;
 
     if (!(txr = load_pvr(filename, &img->width, &img->height, &img->format))) {
-        img->texture = img_empty_boxart.texture;
-        img->width = img_empty_boxart.width;
-        img->height = img_empty_boxart.height;
-        img->format = img_empty_boxart.format;
+        *img = img_empty_boxart;
         return img;
     }
     img->texture = txr;
+    img->atlas_size = 0;
 
     return user;
 }
@@ -125,13 +121,11 @@ draw_load_texture_buffer(const char* filename, void* user, void* buffer) {
     pvr_ptr_t txr;
 
     if (!(txr = load_pvr_to_buffer(filename, &img->width, &img->height, &img->format, buffer))) {
-        img->texture = img_empty_boxart.texture;
-        img->width = img_empty_boxart.width;
-        img->height = img_empty_boxart.height;
-        img->format = img_empty_boxart.format;
+        *img = img_empty_boxart;
         return img;
     }
     img->texture = txr;
+    img->atlas_size = 0;
 
     return user;
 }
@@ -139,18 +133,24 @@ draw_load_texture_buffer(const char* filename, void* user, void* buffer) {
 void*
 draw_load_texture_from_DAT_to_buffer(const struct dat_file* bin, const char* ID, void* user, void* buffer) {
     image* img = (image*)user;
-    pvr_ptr_t txr;
-    int ret = DAT_read_file_by_ID(bin, ID, pvr_get_internal_buffer());
-    if (!ret) {
-        img->texture = img_empty_boxart.texture;
-        img->width = img_empty_boxart.width;
-        img->height = img_empty_boxart.height;
-        img->format = img_empty_boxart.format;
+    const uint32_t offset = DAT_get_offset_by_ID(bin, ID);
+    void* block = pvr_get_stream_block();
+    pvr_stream stream;
+    pvr_stream_dest dest;
+
+    /* Straight from the DAT into buffer a block at a time */
+    if (!offset || !block || !pvr_stream_open(&stream, bin->handle, offset, bin->chunk_size)) {
+        *img = img_empty_boxart;
         return img;
     }
+    pvr_stream_dest_buffer(&stream, buffer, &dest);
+    pvr_stream_load(&stream, &dest, block);
 
-    txr = load_pvr_from_buffer_to_buffer(pvr_get_internal_buffer(), &img->width, &img->height, &img->format, buffer);
-    img->texture = txr;
+    img->width = stream.width;
+    img->height = stream.height;
+    img->format = stream.format;
+    img->texture = buffer;
+    img->atlas_size = 0;
 
     return user;
 }
@@ -163,166 +163,202 @@ draw_draw_image(int x, int y, float width, float height, uint32_t color, void* u
     draw_draw_sub_image(x, y, width, height, color, user, &uv_01);
 }
 
-void
-draw_draw_sub_image(int x, int y, float width, float height, uint32_t color, void* user, const dimen_RECT* rect) {
-    image* img = (image*)user;
+/* One textured quad, positions rounded and uvs already in the texture's range */
+typedef struct image_quad {
+    float x1, y1, x2, y2, z;
+    float u1, v1, u2, v2;
+    uint32_t color;
+} image_quad;
+
+/* What a header sets, texture is NULL for flat color */
+typedef struct quad_state {
+    pvr_ptr_t texture;
+    uint32_t format;
+    uint32_t width, height;
+#ifdef KOS_SPRITE
+    uint32_t argb; /* flat sprites take their color from the header */
+#endif
+} quad_state;
 
-    if (img == NULL || img->width == 0 || img->height == 0) {
-        return;
-    }
+/* Quads drawn into a list are recorded and sent by draw_flush, one header per
+ * run of the same state. A quad joins an earlier run only when nothing recorded
+ * after that run overlaps it, so whatever overlaps keeps its order. */
+#define DRAW_CMD_MAX (256)
+#define DRAW_RUN_MAX (64)
 
-    /* Upper left */
-    const float x1 = round((float)x);
-    const float y1 = round((float)y);
-    const float u1 = (float)rect->x / img->width;
-    const float v1 = (float)rect->y / img->height;
+typedef struct draw_cmd {
+    image_quad quad;
+    int16_t next; /* in the same run */
+} draw_cmd;
 
-    /* Lower right */
-    const float x2 = round((float)x + width);
-    const float y2 = round((float)y + height);
-    const float u2 = (float)(rect->x + rect->w) / img->width;
-    const float v2 = (float)(rect->y + rect->h) / img->height;
+typedef struct draw_run {
+    quad_state state;
+    int16_t first, last;
+    float x1, y1, x2, y2; /* around all of its quads */
+} draw_run;
 
-    const float z = z_inc();
+static draw_cmd cmds[DRAW_CMD_MAX];
+static draw_run runs[DRAW_RUN_MAX];
+static int cmd_len, run_len;
 
-#ifdef KOS_SPRITE
-    pvr_sprite_cxt_t context;
-    pvr_sprite_hdr_t header;
+static draw_frame_stats frame_stats, last_frame_stats;
 
-    pvr_sprite_cxt_txr(&context, draw_get_list(), img->format, img->width, img->height, img->texture,
-                       PVR_FILTER_BILINEAR);
-    pvr_sprite_compile(&header, &context);
+void
+draw_begin_frame(void) {
+    last_frame_stats = frame_stats;
+    memset(&frame_stats, 0, sizeof(frame_stats));
+}
 
-    pvr_prim(&header, sizeof(header));
+void
+draw_get_frame_stats(draw_frame_stats* stats) {
+    *stats = last_frame_stats;
+}
 
-    pvr_sprite_txr_t vert = {
-        .flags = PVR_CMD_VERTEX_EOL, /* Always? */
-        /*  upper left */
-        .ax = x1,
-        .ay = y1,
-        .az = z,
-        /* upper right */
-        .bx = x2,
-        .by = y1,
-        .bz = z,
-        /* lower left */
-        .cx = x2,
-        .cy = y2,
-        .cz = z,
-        /* interpolated */
-        .dx = x1,
-        .dy = y2,
-        .auv = PVR_PACK_16BIT_UV(u1, v1), /* UVS */
-        .buv = PVR_PACK_16BIT_UV(u2, v1), /* UVS */
-        .cuv = PVR_PACK_16BIT_UV(u2, v2), /* UVS */
-    };
-    pvr_prim(&vert, sizeof(vert));
+/* Atlas images are a square of a shared page, the page is the texture */
+static inline uint32_t
+image_tex_width(const image* img) {
+    return img->atlas_size ? img->atlas_size : img->width;
+}
 
-#else
-    pvr_poly_cxt_t context;
-    pvr_poly_hdr_t header;
+static inline uint32_t
+image_tex_height(const image* img) {
+    return img->atlas_size ? img->atlas_size : img->height;
+}
 
-    pvr_poly_cxt_txr(&context, draw_get_list(), img->format, img->width, img->height, img->texture,
-                     PVR_FILTER_BILINEAR);
-    if (context.txr.enable != PVR_TEXTURE_DISABLE) {
-        switch (context.txr.width) {
-            case 8:
-            case 16:
-            case 32:
-            case 64:
-            case 128:
-            case 256:
-            case 512:
-            case 1024: break;
-            default:
-                printf("%s error tex size %d(%ld) %d(%ld)\n", __func__, context.txr.width, img->width,
-                       context.txr.height, img->height);
-                return;
-                break;
-        }
+/* Cells on a page sit edge to edge and filtering reads half a texel around
+ * where it samples, keep atlas UVs that far inside the image's own cell */
+static inline float
+image_atlas_texel(float texel, uint32_t start, uint32_t size) {
+    const float low = (float)start + 0.5f;
+    const float high = (float)(start + size) - 0.5f;
+    return texel < low ? low : (texel > high ? high : texel);
+}
+
+static int
+image_quad_make(image_quad* quad, int x, int y, float width, float height, uint32_t color, const image* img,
+                const dimen_RECT* rect) {
+    if (img == NULL || img->width == 0 || img->height == 0) {
+        return 0;
+    }
+    const float tex_w = image_tex_width(img);
+    const float tex_h = image_tex_height(img);
+    float u1 = (float)(img->atlas_x + rect->x);
+    float v1 = (float)(img->atlas_y + rect->y);
+    float u2 = (float)(img->atlas_x + rect->x + rect->w);
+    float v2 = (float)(img->atlas_y + rect->y + rect->h);
+
+    if (img->atlas_size) {
+        u1 = image_atlas_texel(u1, img->atlas_x, img->width);
+        v1 = image_atlas_texel(v1, img->atlas_y, img->height);
+        u2 = image_atlas_texel(u2, img->atlas_x, img->width);
+        v2 = image_atlas_texel(v2, img->atlas_y, img->height);
     }
-    pvr_poly_compile(&header, &context);
 
-    pvr_prim(&header, sizeof(header));
+    /* Upper left */
+    quad->x1 = round((float)x);
+    quad->y1 = round((float)y);
+    quad->u1 = u1 / tex_w;
+    quad->v1 = v1 / tex_h;
 
-    pvr_vertex_t vert = {.argb = color, .oargb = 0, .flags = PVR_CMD_VERTEX, .z = 1};
-
-    vert.x = x1;
-    vert.y = y2;
-    vert.z = z;
-    vert.u = u1;
-    vert.v = v2;
-    pvr_prim(&vert, sizeof(vert));
-
-    vert.x = x1;
-    vert.y = y1;
-    vert.u = u1;
-    vert.v = v1;
-    pvr_prim(&vert, sizeof(vert));
-
-    vert.x = x2;
-    vert.y = y2;
-    vert.u = u2;
-    vert.v = v2;
-    pvr_prim(&vert, sizeof(vert));
-
-    vert.flags = PVR_CMD_VERTEX_EOL;
-    vert.x = x2;
-    vert.y = y1;
-    vert.u = u2;
-    vert.v = v1;
-    pvr_prim(&vert, sizeof(vert));
+    /* Lower right */
+    quad->x2 = round((float)x + width);
+    quad->y2 = round((float)y + height);
+    quad->u2 = u2 / tex_w;
+    quad->v2 = v2 / tex_h;
+
+    quad->z = z_inc();
+    quad->color = color;
+    return 1;
+}
+
+static inline int
+quad_state_equal(const quad_state* a, const quad_state* b) {
+#ifdef KOS_SPRITE
+    if (a->argb != b->argb) {
+        return 0;
+    }
 #endif
+    return a->texture == b->texture && a->format == b->format && a->width == b->width && a->height == b->height;
 }
 
-/* Draws untextured quad at coords with size and color(rgba) */
-void
-draw_draw_quad(int x, int y, float width, float height, uint32_t color) {
-    /* Upper left */
-    const float x1 = round((float)x);
-    const float y1 = round((float)y);
+static inline int
+draw_run_overlaps(const draw_run* run, const image_quad* quad) {
+    return quad->x1 < run->x2 && run->x1 < quad->x2 && quad->y1 < run->y2 && run->y1 < quad->y2;
+}
 
-    /* Lower right */
-    const float x2 = round((float)x + width);
-    const float y2 = round((float)y + height);
+static void
+draw_record(const quad_state* state, const image_quad* quad) {
+    int run_num = -1;
 
-    const float z = z_inc();
+    if (cmd_len == DRAW_CMD_MAX) {
+        draw_flush();
+    }
+    for (int i = run_len - 1; i >= 0; i--) {
+        if (quad_state_equal(&runs[i].state, state)) {
+            run_num = i;
+            break;
+        }
+        if (draw_run_overlaps(&runs[i], quad)) {
+            break;
+        }
+    }
+    if (run_num == -1) {
+        if (run_len == DRAW_RUN_MAX) {
+            draw_flush();
+        }
+        run_num = run_len++;
+        runs[run_num] = (draw_run){.state = *state, .first = -1, .last = -1};
+        runs[run_num].x1 = quad->x1;
+        runs[run_num].y1 = quad->y1;
+        runs[run_num].x2 = quad->x2;
+        runs[run_num].y2 = quad->y2;
+    }
 
+    draw_run* run = &runs[run_num];
+    cmds[cmd_len].quad = *quad;
+    cmds[cmd_len].next = -1;
+    if (run->last == -1) {
+        run->first = (int16_t)cmd_len;
+    } else {
+        cmds[run->last].next = (int16_t)cmd_len;
+    }
+    run->last = (int16_t)cmd_len;
+    run->x1 = fminf(run->x1, quad->x1);
+    run->y1 = fminf(run->y1, quad->y1);
+    run->x2 = fmaxf(run->x2, quad->x2);
+    run->y2 = fmaxf(run->y2, quad->y2);
+    cmd_len++;
+    frame_stats.quads++;
+}
+
+/* Paletted art selects its palette bank through the format bits, so the
+ * header binds it like any other texture */
+static int
+quad_state_header(const quad_state* state) {
 #ifdef KOS_SPRITE
     pvr_sprite_cxt_t context;
     pvr_sprite_hdr_t header;
 
-    pvr_sprite_cxt_col(&context, draw_get_list());
+    if (state->texture) {
+        pvr_sprite_cxt_txr(&context, draw_get_list(), state->format, state->width, state->height, state->texture,
+                           PVR_FILTER_BILINEAR);
+    } else {
+        pvr_sprite_cxt_col(&context, draw_get_list());
+    }
     pvr_sprite_compile(&header, &context);
-
-    header.argb = color;
-
-    pvr_prim(&header, sizeof(header));
-
-    pvr_sprite_col_t vert = {.flags = PVR_CMD_VERTEX_EOL, /* Always? */
-                             /*  upper left */
-                             .ax = x1,
-                             .ay = y1,
-                             .az = z,
-                             /* upper right */
-                             .bx = x2,
-                             .by = y1,
-                             .bz = z,
-                             /* lower left */
-                             .cx = x2,
-                             .cy = y2,
-                             .cz = z,
-                             /* interpolated */
-                             .dx = x1,
-                             .dy = y2};
-
-    pvr_prim(&vert, sizeof(vert));
-
+    if (!state->texture) {
+        header.argb = state->argb;
+    }
 #else
     pvr_poly_cxt_t context;
     pvr_poly_hdr_t header;
 
-    pvr_poly_cxt_col(&context, draw_get_list());
+    if (state->texture) {
+        pvr_poly_cxt_txr(&context, draw_get_list(), state->format, state->width, state->height, state->texture,
+                         PVR_FILTER_BILINEAR);
+    } else {
+        pvr_poly_cxt_col(&context, draw_get_list());
+    }
     if (context.txr.enable != PVR_TEXTURE_DISABLE) {
         switch (context.txr.width) {
             case 8:
@@ -334,35 +370,140 @@ draw_draw_quad(int x, int y, float width, float height, uint32_t color) {
             case 512:
             case 1024: break;
             default:
-                printf("%s error tex size %d(%f) %d(%f)\n", __func__, context.txr.width, width, context.txr.height,
-                       height);
-                return;
+                printf("%s error tex size %d(%u) %d(%u)\n", __func__, context.txr.width, (unsigned int)state->width,
+                       context.txr.height, (unsigned int)state->height);
+                return 0;
                 break;
         }
     }
     pvr_poly_compile(&header, &context);
+#endif
 
     pvr_prim(&header, sizeof(header));
+    frame_stats.headers++;
+    return 1;
+}
+
+/* Vertices go out through the store queues a buffer at a time */
+#ifdef KOS_SPRITE
+#define VERT_PER_QUAD (1)
+typedef pvr_sprite_txr_t draw_vertex;
+#else
+#define VERT_PER_QUAD (4)
+typedef pvr_vertex_t draw_vertex;
+#endif
+#define DRAW_VERT_MAX (64 * VERT_PER_QUAD)
 
-    pvr_vertex_t vert = {.argb = color, .oargb = 0, .flags = PVR_CMD_VERTEX, .z = z, .u = 0, .v = 0};
+static draw_vertex vert_buf[DRAW_VERT_MAX] __attribute__((aligned(32)));
 
-    vert.x = x1;
-    vert.y = y2;
-    pvr_prim(&vert, sizeof(vert));
+static draw_vertex*
+draw_quad_vertices(draw_vertex* vert, const image_quad* quad) {
+#ifdef KOS_SPRITE
+    *vert = (pvr_sprite_txr_t){
+        .flags = PVR_CMD_VERTEX_EOL, /* Always? */
+        /*  upper left */
+        .ax = quad->x1,
+        .ay = quad->y1,
+        .az = quad->z,
+        /* upper right */
+        .bx = quad->x2,
+        .by = quad->y1,
+        .bz = quad->z,
+        /* lower left */
+        .cx = quad->x2,
+        .cy = quad->y2,
+        .cz = quad->z,
+        /* interpolated */
+        .dx = quad->x1,
+        .dy = quad->y2,
+        .auv = PVR_PACK_16BIT_UV(quad->u1, quad->v1), /* UVS */
+        .buv = PVR_PACK_16BIT_UV(quad->u2, quad->v1), /* UVS */
+        .cuv = PVR_PACK_16BIT_UV(quad->u2, quad->v2), /* UVS */
+    };
+    return vert + 1;
+#else
+    const pvr_vertex_t corner = {.argb = quad->color, .oargb = 0, .flags = PVR_CMD_VERTEX, .z = quad->z};
+
+    vert[0] = corner;
+    vert[0].x = quad->x1;
+    vert[0].y = quad->y2;
+    vert[0].u = quad->u1;
+    vert[0].v = quad->v2;
+
+    vert[1] = corner;
+    vert[1].x = quad->x1;
+    vert[1].y = quad->y1;
+    vert[1].u = quad->u1;
+    vert[1].v = quad->v1;
+
+    vert[2] = corner;
+    vert[2].x = quad->x2;
+    vert[2].y = quad->y2;
+    vert[2].u = quad->u2;
+    vert[2].v = quad->v2;
+
+    vert[3] = corner;
+    vert[3].flags = PVR_CMD_VERTEX_EOL;
+    vert[3].x = quad->x2;
+    vert[3].y = quad->y1;
+    vert[3].u = quad->u2;
+    vert[3].v = quad->v1;
+    return vert + 4;
+#endif
+}
 
-    vert.x = x1;
-    vert.y = y1;
-    pvr_prim(&vert, sizeof(vert));
+void
+draw_flush(void) {
+    for (int i = 0; i < run_len; i++) {
+        if (!quad_state_header(&runs[i].state)) {
+            continue;
+        }
+        draw_vertex* vert = vert_buf;
+        for (int cmd = runs[i].first; cmd != -1; cmd = cmds[cmd].next) {
+            if (vert == vert_buf + DRAW_VERT_MAX) {
+                pvr_prim(vert_buf, sizeof(vert_buf));
+                vert = vert_buf;
+            }
+            vert = draw_quad_vertices(vert, &cmds[cmd].quad);
+            frame_stats.vertices += VERT_PER_QUAD;
+        }
+        pvr_prim(vert_buf, (vert - vert_buf) * sizeof(draw_vertex));
+    }
+    cmd_len = run_len = 0;
+}
+
+void
+draw_draw_sub_image(int x, int y, float width, float height, uint32_t color, void* user, const dimen_RECT* rect) {
+    const image* img = (const image*)user;
+    image_quad quad;
+
+    if (image_quad_make(&quad, x, y, width, height, color, img, rect)) {
+        quad_state state = {.texture = img->texture, .format = img->format};
+        state.width = image_tex_width(img);
+        state.height = image_tex_height(img);
+        draw_record(&state, &quad);
+    }
+}
+
+/* Draws untextured quad at coords with size and color(rgba) */
+void
+draw_draw_quad(int x, int y, float width, float height, uint32_t color) {
+    quad_state state = {.texture = NULL};
+    image_quad quad = {.color = color};
 
-    vert.x = x2;
-    vert.y = y2;
-    pvr_prim(&vert, sizeof(vert));
+    /* Upper left */
+    quad.x1 = round((float)x);
+    quad.y1 = round((float)y);
 
-    vert.flags = PVR_CMD_VERTEX_EOL;
-    vert.x = x2;
-    vert.y = y1;
-    pvr_prim(&vert, sizeof(vert));
+    /* Lower right */
+    quad.x2 = round((float)x + width);
+    quad.y2 = round((float)y + height);
+
+    quad.z = z_inc();
+#ifdef KOS_SPRITE
+    state.argb = color;
 #endif
+    draw_record(&state, &quad);
 }
 
 /* draws an image at coords as a square */
@@ -58,6 +58,22 @@ void draw_draw_sub_image(int x, int y, float width, float height, uint32_t color
 /* Draws untextured quad at coords with size and color(rgba) */
 void draw_draw_quad(int x, int y, float width, float height, uint32_t color);
 
+/* The draw functions above only record, quads sharing a texture (icons on an
+ * atlas page) go out under one header when the list is flushed. Anything
+ * writing to the list itself, like the fonts, flushes first. */
+void draw_flush(void);
+
+/* Sent by the draw functions during the last frame, fonts aside. Without
+ * batching every quad would have been a header of its own. */
+typedef struct draw_frame_stats {
+    unsigned int quads;
+    unsigned int headers;
+    unsigned int vertices;
+} draw_frame_stats;
+
+void draw_begin_frame(void);
+void draw_get_frame_stats(draw_frame_stats* stats);
+
 /* exec proto */
 struct gd_item;
 void bloom_launch(const struct gd_item* disc);
@@ -231,13 +231,14 @@ theme_read(const char* filename, void* theme, int type) {
     }
 
     size_t ini_size = filelength(ini);
-    char* ini_buffer = malloc(ini_size);
+    char* ini_buffer = malloc(ini_size + 1);
     if (!ini_buffer) {
         printf("%s no free memory\n", __func__);
         return -1;
     }
     fs_read(ini, ini_buffer, ini_size);
     fs_close(ini);
+    ini_buffer[ini_size] = '\0';
 
     if (ini_parse_string(ini_buffer, type == 0 ? read_theme_ini : read_scroll_theme_ini, theme) < 0) {
         printf("INI:Error Parsing %s!\n", filename);
@@ -31,6 +31,7 @@
 /* Static resources */
 static image txr_bg_left, txr_bg_right;
 static image txr_focus;
+static txr_view focus_view; /* large art first, small second */
 extern image img_empty_boxart;
 extern image img_dir_boxart;
 
@@ -369,9 +370,9 @@ draw_gameart(void) {
 
     /* Load artwork for games */
     {
-        txr_get_large(item->product, &txr_focus);
+        txr_view_large(&focus_view, 0, item->product, &txr_focus);
         if (txr_focus.texture == img_empty_boxart.texture) {
-            txr_get_small(item->product, &txr_focus);
+            txr_view_small(&focus_view, 1, item->product, &txr_focus);
         }
     }
 
@@ -691,6 +692,8 @@ FUNCTION(UI_NAME, init) {
     txr_empty_small_pool();
     txr_empty_large_pool();
     printf("FOLDERS_init: Texture pools cleared\n");
+    /* One box and no prefetch, spare room keeps recently shown boxes */
+    txr_set_working_set(&(txr_working_set){.icons = 1, .icon_margin = 0, .boxes = 1, .box_margin = 0});
 
     /* Load default FOLDERS theme from THEME.INI */
     theme_read("/cd/THEME/FOLDERS/THEME.INI", &default_theme, 1);
@@ -711,13 +714,8 @@ FUNCTION(UI_NAME, init) {
     }
 
     printf("FOLDERS_init: Loading backgrounds\n");
-    unsigned int temp = texman_create();
-    draw_load_texture_buffer(cur_theme->bg_left, &txr_bg_left, texman_get_tex_data(temp));
-    texman_reserve_memory(txr_bg_left.width, txr_bg_left.height, 2 /* 16Bit */);
-
-    temp = texman_create();
-    draw_load_texture_buffer(cur_theme->bg_right, &txr_bg_right, texman_get_tex_data(temp));
-    texman_reserve_memory(txr_bg_right.width, txr_bg_right.height, 2 /* 16Bit */);
+    texman_load(cur_theme->bg_left, &txr_bg_left);
+    texman_load(cur_theme->bg_right, &txr_bg_right);
 
     /* Initialize font */
     printf("FOLDERS_init: Initializing font\n");
@@ -17,6 +17,7 @@
 #include <backend/gd_list.h>
 
 #include "texture/txr_manager.h"
+#include "texture/txr_prefetch.h"
 #include "ui/animation.h"
 #include "ui/draw_prototypes.h"
 #include "ui/font_prototypes.h"
@@ -96,6 +97,8 @@ static image txr_icon_list[/*ROWS * COLUMNS*/ 4 * 3 /* Assume the worst */]; /*
 static image txr_focus;
 static image txr_highlight; /* Highlight square */
 static image txr_bg_left, txr_bg_right;
+static txr_view icon_view;
+static txr_view focus_view;
 
 extern image img_empty_boxart;
 extern image img_dir_boxart;
@@ -160,7 +163,7 @@ current_selected(void) {
 static void
 draw_large_art(void) {
     if (anim_active(&anim_large_art_scale.time)) {
-        txr_get_large(list_current[current_selected()]->product, &txr_focus);
+        txr_view_large(&focus_view, 0, list_current[current_selected()]->product, &txr_focus);
         if (txr_focus.texture == img_empty_boxart.texture
             || !strncmp(list_current[current_selected()]->disc, "DIR", 3)) {
             /* Only draw if large is present */
@@ -210,6 +213,9 @@ draw_animated_highlight(int width, int height) {
 
 static void
 draw_grid_boxes(void) {
+    int highlighted = 0;
+    float highlight_x = 0.0f, highlight_y = 0.0f;
+
     for (int row = 0; row < ROWS; row++) {
         for (int column = 0; column < COLUMNS; column++) {
             int idx = (row * COLUMNS) + column;
@@ -227,31 +233,35 @@ draw_grid_boxes(void) {
 
             if (!strncmp(list_current[current_starting_index + idx]->disc, "DIR", 3)
                 && !strncmp(list_current[current_starting_index + idx]->name, "Back", 4)) {
-                txr_icon_list[idx].texture = img_dir_boxart.texture;
-                txr_icon_list[idx].width = img_dir_boxart.width;
-                txr_icon_list[idx].height = img_dir_boxart.height;
-                txr_icon_list[idx].format = img_dir_boxart.format;
+                txr_icon_list[idx] = img_dir_boxart;
             } else {
-                txr_get_small(list_current[current_starting_index + idx]->product, &txr_icon_list[idx]);
+                txr_view_small(&icon_view, idx, list_current[current_starting_index + idx]->product,
+                               &txr_icon_list[idx]);
             }
             draw_draw_image((int)x_pos, (int)y_pos, TILE_SIZE_X * X_SCALE, TILE_SIZE_Y, COLOR_WHITE,
                             &txr_icon_list[idx]);
 
-            /* Highlight */
             if ((current_starting_index + idx) == current_selected()) {
-                if (anim_alive(&anim_highlight.time)) {
-                    draw_animated_highlight((TILE_SIZE_X + (HIGHLIGHT_OVERHANG * 2)) * X_SCALE,
-                                            TILE_SIZE_Y + (HIGHLIGHT_OVERHANG * 2));
-                } else {
-                    pos_highlight.x = x_pos - (HIGHLIGHT_OVERHANG * X_SCALE);
-                    pos_highlight.y = y_pos - (HIGHLIGHT_OVERHANG);
-                    draw_static_highlight((TILE_SIZE_X + (HIGHLIGHT_OVERHANG * 2)) * X_SCALE,
-                                          TILE_SIZE_Y + (HIGHLIGHT_OVERHANG * 2));
-                }
+                highlighted = 1;
+                highlight_x = x_pos;
+                highlight_y = y_pos;
             }
         }
     }
 
+    /* Highlight */
+    if (highlighted) {
+        if (anim_alive(&anim_highlight.time)) {
+            draw_animated_highlight((TILE_SIZE_X + (HIGHLIGHT_OVERHANG * 2)) * X_SCALE,
+                                    TILE_SIZE_Y + (HIGHLIGHT_OVERHANG * 2));
+        } else {
+            pos_highlight.x = highlight_x - (HIGHLIGHT_OVERHANG * X_SCALE);
+            pos_highlight.y = highlight_y - (HIGHLIGHT_OVERHANG);
+            draw_static_highlight((TILE_SIZE_X + (HIGHLIGHT_OVERHANG * 2)) * X_SCALE,
+                                  TILE_SIZE_Y + (HIGHLIGHT_OVERHANG * 2));
+        }
+    }
+
     /* Get multidisc settings */
     int hide_multidisc = sf_multidisc[0];
 
@@ -614,6 +624,10 @@ FUNCTION(UI_NAME, init) {
     region_current = sf_region[0];
     recalculate_aspect(sf_aspect[0]);
 
+    /* A page of icons and the next one, box art only for the focused tile */
+    txr_set_working_set(&(txr_working_set){
+        .icons = ROWS * COLUMNS, .icon_margin = ROWS * COLUMNS, .boxes = 1, .box_margin = 2, .atlas = 1});
+
     /* Get the current themes, original + custom */
     region_themes = theme_get_default(sf_aspect[0], &num_default_themes);
     custom_themes = theme_get_custom(&num_custom_themes);
@@ -626,45 +640,26 @@ FUNCTION(UI_NAME, init) {
     }
 
     /* on user for now, may change */
-    unsigned int temp = texman_create();
-    draw_load_texture_buffer("EMPTY.PVR", &img_empty_boxart, texman_get_tex_data(temp));
-    texman_reserve_memory(img_empty_boxart.width, img_empty_boxart.height, 2 /* 16Bit */);
-
-    temp = texman_create();
-    draw_load_texture_buffer("DIR.PVR", &img_dir_boxart, texman_get_tex_data(temp));
-    texman_reserve_memory(img_dir_boxart.width, img_dir_boxart.height, 2 /* 16Bit */);
-
-    temp = texman_create();
-    draw_load_texture_buffer("THEME/SHARED/HIGHLIGHT.PVR", &txr_highlight, texman_get_tex_data(temp));
-    texman_reserve_memory(txr_highlight.width, txr_highlight.height, 2 /* 16Bit */);
+    texman_load("EMPTY.PVR", &img_empty_boxart);
+    texman_load("DIR.PVR", &img_dir_boxart);
+    texman_load("THEME/SHARED/HIGHLIGHT.PVR", &txr_highlight);
 
     if ((int)region_current >= num_default_themes) {
         region_current -= num_default_themes;
         current_theme_colors = &custom_themes[region_current].colors;
 
-        temp = texman_create();
-        draw_load_texture_buffer(custom_themes[region_current].bg_left, &txr_bg_left, texman_get_tex_data(temp));
-        texman_reserve_memory(txr_bg_left.width, txr_bg_left.height, 2 /* 16Bit */);
-
-        temp = texman_create();
-        draw_load_texture_buffer(custom_themes[region_current].bg_right, &txr_bg_right, texman_get_tex_data(temp));
-        texman_reserve_memory(txr_bg_right.width, txr_bg_right.height, 2 /* 16Bit */);
+        texman_load(custom_themes[region_current].bg_left, &txr_bg_left);
+        texman_load(custom_themes[region_current].bg_right, &txr_bg_right);
     } else {
         current_theme_colors = &region_themes[region_current].colors;
 
-        temp = texman_create();
-        draw_load_texture_buffer(region_themes[region_current].bg_left, &txr_bg_left, texman_get_tex_data(temp));
-        texman_reserve_memory(txr_bg_left.width, txr_bg_left.height, 2 /* 16Bit */);
-
-        temp = texman_create();
-        draw_load_texture_buffer(region_themes[region_current].bg_right, &txr_bg_right, texman_get_tex_data(temp));
-        texman_reserve_memory(txr_bg_right.width, txr_bg_right.height, 2 /* 16Bit */);
+        texman_load(region_themes[region_current].bg_left, &txr_bg_left);
+        texman_load(region_themes[region_current].bg_right, &txr_bg_right);
     }
 
     font_bmf_init("FONT/BASILEA.FNT", "FONT/BASILEA_W.PVR", sf_aspect[0]);
 
-    printf("Texture scratch free: %d/%d KB (%d/%d bytes)\n", texman_get_space_available() / 1024,
-           TEXMAN_BUFFER_SIZE / 1024, texman_get_space_available(), TEXMAN_BUFFER_SIZE);
+    texman_print_stats();
 }
 
 static void
@@ -799,6 +794,7 @@ FUNCTION(UI_NAME, drawTR) {
 
     draw_grid_boxes();
     draw_game_title();
+    txr_prefetch_update(current_selected(), current_starting_index, ROWS * COLUMNS);
 
     switch (draw_current) {
         case DRAW_MENU: {
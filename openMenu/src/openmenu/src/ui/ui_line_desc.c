@@ -19,6 +19,7 @@
 #include <backend/gd_list.h>
 
 #include "texture/txr_manager.h"
+#include "texture/txr_prefetch.h"
 #include "ui/draw_prototypes.h"
 #include "ui/font_prototypes.h"
 #include "ui/ui_common.h"
@@ -61,6 +62,8 @@ static image txr_icon_list[16]; /* Lower list of 9 icons */
 static image txr_focus;         /* current selected item, either lowres or hires */
 static image txr_highlight;     /* Highlight square*/
 static image txr_bg_left, txr_bg_right;
+static txr_view icon_view;
+static txr_view focus_view; /* large art first, small second */
 static image txr_icons_white /*, txr_icons_black*/;
 static image* txr_icons_current;
 
@@ -149,12 +152,9 @@ draw_small_boxes(void) {
     for (i = 0; (i < num_icons) && (i + starting_icon_idx < list_len); i++) {
         if (!strncmp(list_current[starting_icon_idx + i]->disc, "DIR", 3)
             && !strncmp(list_current[starting_icon_idx + i]->name, "Back", 4)) {
-            txr_icon_list[i].texture = img_dir_boxart.texture;
-            txr_icon_list[i].width = img_dir_boxart.width;
-            txr_icon_list[i].height = img_dir_boxart.height;
-            txr_icon_list[i].format = img_dir_boxart.format;
+            txr_icon_list[i] = img_dir_boxart;
         } else {
-            txr_get_small(list_current[starting_icon_idx + i]->product, &txr_icon_list[i]);
+            txr_view_small(&icon_view, i, list_current[starting_icon_idx + i]->product, &txr_icon_list[i]);
         }
         draw_draw_image((x_start + (ICON_SIZE_X + ICON_SPACING) * i) * X_SCALE, y_pos, ICON_SIZE_X * X_SCALE,
                         ICON_SIZE_Y, COLOR_WHITE, &txr_icon_list[i]);
@@ -283,7 +283,7 @@ draw_game_meta(void) {
 static void
 menu_changed_item(void) {
     frames_focused = 0;
-    db_get_meta(list_current[current_selected_item]->product, &current_meta);
+    db_get_meta_by_slot(list_slot_index(list_current[current_selected_item]), &current_meta);
 }
 
 static bool
@@ -510,18 +510,15 @@ static void
 update_data(void) {
     if (!strncmp(list_current[current_selected_item]->disc, "DIR", 3)
         && !strncmp(list_current[current_selected_item]->name, "Back", 4)) {
-        txr_focus.texture = img_dir_boxart.texture;
-        txr_focus.width = img_dir_boxart.width;
-        txr_focus.height = img_dir_boxart.height;
-        txr_focus.format = img_dir_boxart.format;
+        txr_focus = img_dir_boxart;
     } else {
         if (frames_focused > FOCUSED_HIRES_FRAMES) {
-            txr_get_large(list_current[current_selected_item]->product, &txr_focus);
+            txr_view_large(&focus_view, 0, list_current[current_selected_item]->product, &txr_focus);
             if (txr_focus.texture == img_empty_boxart.texture) {
-                txr_get_small(list_current[current_selected_item]->product, &txr_focus);
+                txr_view_small(&focus_view, 1, list_current[current_selected_item]->product, &txr_focus);
             }
         } else {
-            txr_get_small(list_current[current_selected_item]->product, &txr_focus);
+            txr_view_small(&focus_view, 1, list_current[current_selected_item]->product, &txr_focus);
         }
     }
 
@@ -549,6 +546,10 @@ FUNCTION(UI_NAME, init) {
     region_current = sf_region[0];
     recalculate_aspect(sf_aspect[0]);
 
+    /* The strip and as much again ahead of it, box art only for the focused item */
+    txr_set_working_set(&(txr_working_set){
+        .icons = NUM_ICONS, .icon_margin = NUM_ICONS, .boxes = 1, .box_margin = 2, .atlas = 1});
+
     /* Get the current themes, original + custom */
     region_themes = theme_get_default(sf_aspect[0], &num_default_themes);
     custom_themes = theme_get_custom(&num_custom_themes);
@@ -561,57 +562,33 @@ FUNCTION(UI_NAME, init) {
     }
 
     /* on user for now, may change */
-    uint32_t temp = texman_create();
-    draw_load_texture_buffer("EMPTY.PVR", &img_empty_boxart, texman_get_tex_data(temp));
-    texman_reserve_memory(img_empty_boxart.width, img_empty_boxart.height, 2 /* 16Bit */);
-
-    temp = texman_create();
-    draw_load_texture_buffer("DIR.PVR", &img_dir_boxart, texman_get_tex_data(temp));
-    texman_reserve_memory(img_dir_boxart.width, img_dir_boxart.height, 2 /* 16Bit */);
-
-    temp = texman_create();
-    draw_load_texture_buffer("THEME/SHARED/HIGHLIGHT.PVR", &txr_highlight, texman_get_tex_data(temp));
-    texman_reserve_memory(txr_highlight.width, txr_highlight.height, 2 /* 16Bit */);
-
-    temp = texman_create();
-    draw_load_texture_buffer("THEME/SHARED/ICON_WHITE.PVR", &txr_icons_white, texman_get_tex_data(temp));
-    texman_reserve_memory(txr_icons_white.width, txr_icons_white.height, 2 /* 16Bit */);
+    texman_load("EMPTY.PVR", &img_empty_boxart);
+    texman_load("DIR.PVR", &img_dir_boxart);
+    texman_load("THEME/SHARED/HIGHLIGHT.PVR", &txr_highlight);
+    texman_load("THEME/SHARED/ICON_WHITE.PVR", &txr_icons_white);
 
     if ((int)region_current >= num_default_themes) {
         region_current -= num_default_themes;
         current_theme_colors = &custom_themes[region_current].colors;
 
-        temp = texman_create();
-        draw_load_texture_buffer(custom_themes[region_current].bg_left, &txr_bg_left, texman_get_tex_data(temp));
-        texman_reserve_memory(txr_bg_left.width, txr_bg_left.height, 2 /* 16Bit */);
-
-        temp = texman_create();
-        draw_load_texture_buffer(custom_themes[region_current].bg_right, &txr_bg_right, texman_get_tex_data(temp));
-        texman_reserve_memory(txr_bg_right.width, txr_bg_right.height, 2 /* 16Bit */);
+        texman_load(custom_themes[region_current].bg_left, &txr_bg_left);
+        texman_load(custom_themes[region_current].bg_right, &txr_bg_right);
     } else {
         current_theme_colors = &region_themes[region_current].colors;
 
-        temp = texman_create();
-        draw_load_texture_buffer(region_themes[region_current].bg_left, &txr_bg_left, texman_get_tex_data(temp));
-        texman_reserve_memory(txr_bg_left.width, txr_bg_left.height, 2 /* 16Bit */);
-
-        temp = texman_create();
-        draw_load_texture_buffer(region_themes[region_current].bg_right, &txr_bg_right, texman_get_tex_data(temp));
-        texman_reserve_memory(txr_bg_right.width, txr_bg_right.height, 2 /* 16Bit */);
+        texman_load(region_themes[region_current].bg_left, &txr_bg_left);
+        texman_load(region_themes[region_current].bg_right, &txr_bg_right);
     }
 
     txr_icons_current = &txr_icons_white;
 
 #if 0
-  temp = texman_create();
-  draw_load_texture_buffer("THEME/SHARED/ICON_BLACK.PVR", &txr_icons_black, texman_get_tex_data(temp));
-  texman_reserve_memory(txr_icons_black.width, txr_icons_black.height, 2 /* 16Bit */);
+  texman_load("THEME/SHARED/ICON_BLACK.PVR", &txr_icons_black);
 #endif
 
     font_bmf_init("FONT/BASILEA.FNT", "FONT/BASILEA_W.PVR", sf_aspect[0]);
 
-    printf("Texture scratch free: %d/%d KB (%d/%d bytes)\n", texman_get_space_available() / 1024,
-           TEXMAN_BUFFER_SIZE / 1024, texman_get_space_available(), TEXMAN_BUFFER_SIZE);
+    texman_print_stats();
 }
 
 static void
@@ -713,6 +690,7 @@ FUNCTION(UI_NAME, drawTR) {
         draw_small_box_highlight();
         draw_small_boxes();
         draw_big_box();
+        txr_prefetch_update(current_selected_item, current_selected_item - (NUM_ICONS / 2), NUM_ICONS);
     }
 
     switch (draw_current) {
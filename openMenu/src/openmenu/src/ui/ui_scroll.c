@@ -18,6 +18,7 @@
 #include <backend/gd_list.h>
 #include <openmenu_settings.h>
 #include "texture/txr_manager.h"
+#include "texture/txr_prefetch.h"
 #include "ui/draw_prototypes.h"
 #include "ui/font_prototypes.h"
 #include "ui/ui_common.h"
@@ -170,6 +171,7 @@ get_marquee_speed_frames(void) {
 };*/
 
 static image txr_focus;
+static txr_view focus_view; /* large art first, small second */
 extern image img_empty_boxart;
 extern image img_dir_boxart;
 
@@ -427,14 +429,11 @@ draw_gameart(void) {
 
     if (!strncmp(list_current[current_selected_item]->disc, "DIR", 3)
         && !strncmp(list_current[current_selected_item]->name, "Back", 4)) {
-        txr_focus.texture = img_dir_boxart.texture;
-        txr_focus.width = img_dir_boxart.width;
-        txr_focus.height = img_dir_boxart.height;
-        txr_focus.format = img_dir_boxart.format;
+        txr_focus = img_dir_boxart;
     } else {
-        txr_get_large(list_current[current_selected_item]->product, &txr_focus);
+        txr_view_large(&focus_view, 0, list_current[current_selected_item]->product, &txr_focus);
         if (txr_focus.texture == img_empty_boxart.texture) {
-            txr_get_small(list_current[current_selected_item]->product, &txr_focus);
+            txr_view_small(&focus_view, 1, list_current[current_selected_item]->product, &txr_focus);
         }
     }
 
@@ -604,6 +603,8 @@ FUNCTION(UI_NAME, init) {
    * without forcing it and old data doesn't matter */
     txr_empty_small_pool();
     txr_empty_large_pool();
+    /* One box, icons only stand in when it's missing */
+    txr_set_working_set(&(txr_working_set){.icons = 1, .icon_margin = 1, .boxes = 1, .box_margin = 2});
     if (sf_custom_theme[0]) {
         int custom_theme_num = 0;
         custom = theme_get_scroll(&custom_theme_num);
@@ -616,22 +617,13 @@ FUNCTION(UI_NAME, init) {
         cur_theme = (theme_scroll*)&default_theme;
     }
 
-    unsigned int temp = texman_create();
-    draw_load_texture_buffer(cur_theme->bg_left, &txr_bg_left, texman_get_tex_data(temp));
-    texman_reserve_memory(txr_bg_left.width, txr_bg_left.height, 2 /* 16Bit */);
-
-    temp = texman_create();
-    draw_load_texture_buffer("DIR.PVR", &img_dir_boxart, texman_get_tex_data(temp));
-    texman_reserve_memory(img_dir_boxart.width, img_dir_boxart.height, 2 /* 16Bit */);
-
-    temp = texman_create();
-    draw_load_texture_buffer(cur_theme->bg_right, &txr_bg_right, texman_get_tex_data(temp));
-    texman_reserve_memory(txr_bg_right.width, txr_bg_right.height, 2 /* 16Bit */);
+    texman_load(cur_theme->bg_left, &txr_bg_left);
+    texman_load("DIR.PVR", &img_dir_boxart);
+    texman_load(cur_theme->bg_right, &txr_bg_right);
 
     font_bmp_init(cur_theme->font, 8, 16);
 
-    printf("Texture scratch free: %d/%d KB (%d/%d bytes)\n", texman_get_space_available() / 1024,
-           TEXMAN_BUFFER_SIZE / 1024, texman_get_space_available(), TEXMAN_BUFFER_SIZE);
+    texman_print_stats();
 }
 
 static void
@@ -752,6 +744,7 @@ FUNCTION(UI_NAME, drawTR) {
     draw_gamelist();
     draw_gameinfo();
     draw_gameart();
+    txr_prefetch_update(current_selected_item, current_selected_item, 1);
 
     switch (draw_current) {
         case DRAW_MENU: {
@@ -0,0 +1,104 @@
+/*
+ * File: ui_stats_overlay.c
+ * Project: ui
+ * File Created: Sunday, 18th October 2026 8:12:40 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License,
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ */
+
+#include <stdio.h>
+
+#include <openmenu_settings.h>
+
+#include "texture/txr_manager.h"
+#include "ui/dc/input.h"
+#include "ui/dc/text_cache.h"
+#include "ui/draw_kos.h"
+#include "ui/draw_prototypes.h"
+#include "ui/font_prototypes.h"
+
+#include "ui/ui_stats_overlay.h"
+
+#define OVERLAY_LINES (10)
+
+static int visible;
+static int combo_held;
+
+int
+stats_overlay_handle_input(void) {
+    const int combo = INPT_TriggerPressed(TRIGGER_L) && INPT_TriggerPressed(TRIGGER_R) && INPT_Button(BTN_Y);
+
+    if (combo && !combo_held) {
+        visible = !visible;
+    }
+    combo_held = combo;
+    return combo;
+}
+
+static int
+pool_lines(char lines[][64], const char* name, const txr_pool_stats* pool_stats) {
+    const unsigned int lookups = pool_stats->hits + pool_stats->misses + pool_stats->pending;
+    char* hist = lines[2];
+    int len;
+
+    snprintf(lines[0], 64, "%s %u/%u %uK/%uK fly %u", name, pool_stats->resident, pool_stats->entries,
+             (unsigned int)pool_stats->vram_used / 1024, (unsigned int)pool_stats->vram_budget / 1024,
+             pool_stats->in_flight);
+    snprintf(lines[1], 64, " hit %u%% miss %u pend %u ev %u rd %uK fail %u",
+             lookups ? pool_stats->hits * 100 / lookups : 0, pool_stats->misses, pool_stats->pending,
+             pool_stats->evictions, (unsigned int)pool_stats->bytes_read / 1024, pool_stats->failed_loads);
+    len = snprintf(hist, 64, " ms");
+    for (int i = 0; i < TXR_LATENCY_BUCKETS && len < 64; i++) {
+        len += snprintf(hist + len, 64 - len, " %u", pool_stats->latency[i]);
+    }
+    return 3;
+}
+
+void
+stats_overlay_draw_tr(void) {
+    const txr_stats* stats;
+    draw_frame_stats frame;
+    text_cache_stats text;
+    char lines[OVERLAY_LINES][64];
+    int count = 0;
+    const int x = 8;
+    const int y = 8;
+
+    if (!visible) {
+        return;
+    }
+    stats = txr_get_stats();
+    count += pool_lines(&lines[count], "icon", &stats->icon);
+    count += pool_lines(&lines[count], "box", &stats->box);
+    draw_get_frame_stats(&frame);
+    snprintf(lines[count++], 64, "pf %u used %u drop %u atlas %u", stats->prefetch_issued, stats->prefetch_used,
+             stats->prefetch_cancelled, stats->atlas_pages);
+    snprintf(lines[count++], 64, "hdr %u of %u quads vtx %u", frame.headers, frame.quads, frame.vertices);
+    text_cache_get_stats(&text);
+    snprintf(lines[count++], 64, "txt %u %uK hit %u lay %u ev %u", text.runs, text.bytes / 1024, text.hits,
+             text.layouts, text.evictions);
+    snprintf(lines[count++], 64, "rows hit %u broken %u", text.break_hits, text.breaks);
+
+    z_set_cond(250.0f);
+    if (sf_ui[0] == UI_SCROLL || sf_ui[0] == UI_FOLDERS) {
+        const int line_height = 10;
+        draw_draw_quad(x - 4, y - 4, 320, count * line_height + 8, PVR_PACK_ARGB(192, 0, 0, 0));
+        font_bmp_begin_draw();
+        font_bmp_set_color(COLOR_WHITE);
+        for (int i = 0; i < count; i++) {
+            font_bmp_draw_main(x, y + i * line_height, lines[i]);
+        }
+    } else {
+        const int line_height = 14;
+        draw_draw_quad(x - 4, y - 4, 360, count * line_height + 8, PVR_PACK_ARGB(192, 0, 0, 0));
+        font_bmf_begin_draw();
+        font_bmf_set_height(12.0f);
+        for (int i = 0; i < count; i++) {
+            font_bmf_draw(x, y + i * line_height, COLOR_WHITE, lines[i]);
+        }
+        font_bmf_set_height_default();
+    }
+}
@@ -0,0 +1,18 @@
+/*
+ * File: ui_stats_overlay.h
+ * Project: ui
+ * File Created: Sunday, 18th October 2026 8:12:40 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+
+#pragma once
+
+/* Texture cache diagnostics, L + R + Y toggles it over any UI */
+
+/* Call after input is read, returns non zero if the combo was used this frame */
+int stats_overlay_handle_input(void);
+/* Call at the end of the TR list */
+void stats_overlay_draw_tr(void);
@@ -13,12 +13,17 @@
 #include <stdint.h>
 #include <uthash.h>
 
+#include "product_key.h"
+
 #ifdef _arch_dreamcast
 #include <kos/fs.h>
 #endif
 
 typedef struct bin_item {
-    char ID[12];
+    union {
+        char ID[12];
+        product_key key; /* hashed key, zero padded on load */
+    };
     uint32_t offset;
     UT_hash_handle hh; /* makes this structure hashable */
 } bin_item;
@@ -56,5 +61,8 @@ void DAT_info(const dat_file* bin);
 
 uint32_t DAT_get_offset_by_ID(const dat_file* bin, const char* ID);
 uint32_t DAT_get_index_by_ID(const dat_file* bin, const char* ID);
+uint32_t DAT_get_offset_by_key(const dat_file* bin, const product_key* key);
+uint32_t DAT_get_index_by_key(const dat_file* bin, const product_key* key);
+uint32_t DAT_get_offset_by_num(const dat_file* bin, uint32_t chunk_num); /* 0 if out of range */
 int DAT_read_file_by_ID(const dat_file* bin, const char* ID, void* buf);
 int DAT_read_file_by_num(const dat_file* bin, uint32_t chunk_num, void* buf);
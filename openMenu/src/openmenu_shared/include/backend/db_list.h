@@ -10,10 +10,16 @@
 
 #pragma once
 
+#include <stdint.h>
 #include "db_item.h"
 
+/* Slot has no entry in META.DAT */
+#define DB_META_NONE (0xFFFFFFFF)
+
 int db_load_DAT(void);
+int db_join_list(void);
 int db_get_meta(const char* id, struct db_item** item);
+int db_get_meta_by_slot(int slot_idx, struct db_item** item);
 
 const char* db_format_nplayers_str(int nplayers);
 const char* db_format_vmu_blocks_str(int num_blocks);
\ No newline at end of file
@@ -10,6 +10,8 @@
 
 #pragma once
 
+#include "product_key.h"
+
 struct gd_item;
 int list_read(const char* filename);
 int list_read_default(void);
@@ -36,6 +38,18 @@ int list_length(void);
 int list_multidisc_length(void);
 const struct gd_item* list_item_get(int idx);
 
+/* Base slot access, independent of current sort/filter */
+int list_slots_length(void);
+const struct gd_item* list_slot_get(int slot_idx);
+int list_slot_index(const struct gd_item* item);
+
+/* Interned product numbers, slots sharing a product (disc sets) share one */
+#define LIST_PRODUCT_NONE (-1)
+int list_products_length(void);
+int list_product_find(const char* product);
+int list_slot_product(int slot_idx);
+const product_key* list_product_key(int product_num);
+
 /* Folder navigation functions */
 void list_folder_init(void);
 void list_set_folder_root(void);
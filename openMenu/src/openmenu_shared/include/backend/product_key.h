@@ -0,0 +1,57 @@
+/*
+ * File: product_key.h
+ * Project: backend
+ * File Created: Sunday, 18th October 2026 1:20:52 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/* Product IDs are at most 11 characters, packed zero padded into 12 bytes so
+ * they hash and compare as three words. str is always a valid C string. */
+typedef union product_key {
+    char str[12];
+    uint32_t words[3];
+} product_key;
+
+#define PRODUCT_KEY_MAX_LEN (11)
+
+static inline void
+product_key_make(product_key* key, const char* id) {
+    key->words[0] = key->words[1] = key->words[2] = 0;
+    for (int i = 0; i < PRODUCT_KEY_MAX_LEN && id[i]; i++) {
+        key->str[i] = id[i];
+    }
+}
+
+static inline uint32_t
+product_key_hash(const product_key* key) {
+    uint32_t h = key->words[0] * 0x9E3779B1u;
+    h = (h ^ (h >> 15) ^ key->words[1]) * 0x85EBCA77u;
+    h = (h ^ (h >> 13) ^ key->words[2]) * 0xC2B2AE3Du;
+    return h ^ (h >> 16);
+}
+
+static inline int
+product_key_equal(const product_key* a, const product_key* b) {
+    return ((a->words[0] ^ b->words[0]) | (a->words[1] ^ b->words[1]) | (a->words[2] ^ b->words[2])) == 0;
+}
+
+static inline int
+product_key_empty(const product_key* key) {
+    return key->words[0] == 0;
+}
+
+/* uthash hooks for translation units whose tables are all keyed by an aligned
+ * product_key, define before including uthash.h:
+ *   #define HASH_FUNCTION PRODUCT_KEY_HASH_FUNCTION
+ *   #define HASH_KEYCMP   PRODUCT_KEY_KEYCMP
+ */
+#define PRODUCT_KEY_HASH_FUNCTION(keyptr, keylen, hashv)                                                               \
+    ((hashv) = product_key_hash((const product_key*)(const void*)(keyptr)))
+#define PRODUCT_KEY_KEYCMP(a, b, n) (!product_key_equal((const product_key*)(const void*)(a), (const product_key*)(const void*)(b)))
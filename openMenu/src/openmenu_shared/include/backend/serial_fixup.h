@@ -0,0 +1,17 @@
+/*
+ * File: serial_fixup.h
+ * Project: backend
+ * File Created: Sunday, 18th October 2026 12:04:17 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+
+#pragma once
+
+/* Corrections for releases whose IP.BIN product collides with another game,
+ * table lives in serial_fixup.def and is shared by the menu and host tools */
+
+/* Returns the corrected product or NULL if this product/date/name needs none */
+const char* serial_fixup_product(const char* product, const char* date, const char* name);
@@ -0,0 +1,72 @@
+/*
+ * File: font_pack.h
+ * Project: texture
+ * File Created: Monday, 19th October 2026 2:14:51 am
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/* BMFont compiled by fontpack into what font_bmf draws from, so the menu
+ * reads it in one go instead of parsing the .FNT and opening every page
+ * texture after it. Named after the font's first texture, FONT/BASILEA_W.FPK.
+
+   File, little endian:
+     font_pack_header
+     font_pack_char chars[256], by id
+     font_pack_kern_row kern_rows[num_kern_rows]
+     font_pack_char wide_chars[num_wide_chars], sorted by id
+     font_pack_kern_pair wide_pairs[num_wide_pairs], sorted by first then second
+     every page's texture as a PVR file with its GBIX header, at
+     page_offset which is FONT_PACK_ALIGN aligned */
+
+#define FONT_PACK_MAGIC     "BMFP"
+#define FONT_PACK_VERSION   (2)
+#define FONT_PACK_MAX_PAGES (4)
+#define FONT_PACK_ALIGN     (32)
+
+typedef struct __attribute__((__packed__)) font_pack_char {
+    uint32_t id;
+    uint16_t x;
+    uint16_t y;
+    uint16_t width;
+    uint16_t height;
+    int16_t xoffset;
+    int16_t yoffset;
+    int16_t xadvance;
+    uint8_t page;
+    uint8_t chnl;
+    uint16_t kern_row; /* 0 when no pair starts with this char */
+} font_pack_char;
+
+/* Amounts for every pair a char starts, indexed by the second char. Only
+ * pairs between chars below 256 are kept here. */
+typedef int8_t font_pack_kern_row[256];
+
+/* Pair with either char from 256 up, few fonts have any */
+typedef struct font_pack_kern_pair {
+    uint32_t first;
+    uint32_t second;
+    int32_t amount;
+} font_pack_kern_pair;
+
+typedef struct font_pack_header {
+    char magic[4];
+    uint32_t version;
+    uint16_t height; /* of the page textures */
+    uint16_t width;
+    uint32_t lineHeight;
+    uint32_t fontSize;
+    uint32_t num_chars;
+    uint32_t num_kern_rows;
+    uint32_t num_pages;
+    uint32_t num_wide_chars;
+    uint32_t num_wide_pairs;
+    uint32_t page_offset[FONT_PACK_MAX_PAGES];
+    uint32_t page_size[FONT_PACK_MAX_PAGES];
+} font_pack_header;
@@ -0,0 +1,57 @@
+/*
+ * File: serial_remap.h
+ * Project: texture
+ * File Created: Sunday, 18th October 2026 10:12:40 am
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "backend/product_key.h"
+
+/* Shared between serial_sanitize.c and the remapgen host tool, the generated
+ * table is only valid if both sides hash identically */
+
+enum REMAP_TYPE {
+    REMAP_NONE = (0 << 0), // 0
+    REMAP_ART = (1 << 0),  // 1
+    REMAP_META = (1 << 1), // 2
+};
+
+typedef struct serial_remap {
+    product_key ip_serial;
+    product_key art_serial;
+    product_key meta_serial;
+    enum REMAP_TYPE remap_choice;
+} serial_remap;
+
+/* h1 is the shared product_key hash, h2 is h1 through a finalizer (forced odd
+ * so displacements cycle every slot) */
+static inline void
+serial_remap_hash(const product_key* id, uint32_t* h1, uint32_t* h2) {
+    uint32_t h = product_key_hash(id);
+    *h1 = h;
+
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    *h2 = h | 1;
+}
+
+/* Buckets take the high half of h2, slots use the low bits */
+static inline uint32_t
+serial_remap_bucket(uint32_t h2, uint32_t num_buckets) {
+    return (h2 >> 16) & (num_buckets - 1);
+}
+
+static inline uint32_t
+serial_remap_slot(uint32_t h1, uint32_t h2, uint32_t disp, uint32_t num_slots) {
+    return (h1 + disp * h2) & (num_slots - 1);
+}
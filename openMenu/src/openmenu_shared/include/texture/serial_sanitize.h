@@ -10,6 +10,12 @@
 
 #pragma once
 
+#include "backend/product_key.h"
+
+/* Key variants return either id itself or the remapped key */
+const product_key* serial_santize_art_key(const product_key* id);
+const product_key* serial_santize_meta_key(const product_key* id);
+
 const char* serial_santize_art(const char* id);
 const char* serial_santize_meta(const char* id);
 int serial_sanitizer_init(void);
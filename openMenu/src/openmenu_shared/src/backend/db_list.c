@@ -15,11 +15,56 @@
 #include "backend/dat_format.h"
 #include "texture/serial_sanitize.h"
 #include "backend/db_item.h"
+#include "backend/gd_item.h"
+#include "backend/gd_list.h"
 
 static dat_file dat_meta;
 static db_item* db;
 static int dat_first_index;
 
+/* Per interned product index into db, resolved once after loading */
+static uint32_t* product_meta = NULL;
+static int num_product_meta = 0;
+
+static uint32_t
+db_lookup_index(const product_key* id) {
+    const product_key* id_santized = serial_santize_meta_key(id);
+    uint32_t index = DAT_get_index_by_key(&dat_meta, id_santized);
+
+    if (index == 0xFFFFFFFF) {
+        return DB_META_NONE;
+    }
+
+    return index - dat_first_index;
+}
+
+int
+db_join_list(void) {
+    int num_products = list_products_length();
+
+    free(product_meta);
+    product_meta = NULL;
+    num_product_meta = 0;
+
+    if (!db || num_products <= 0) {
+        return 0;
+    }
+
+    product_meta = malloc(num_products * sizeof(uint32_t));
+    if (!product_meta) {
+        printf("%s no free memory\n", __func__);
+        return 1;
+    }
+
+    /* Once per distinct product, every disc of a set shares the result */
+    for (int i = 0; i < num_products; i++) {
+        product_meta[i] = db_lookup_index(list_product_key(i));
+    }
+    num_product_meta = num_products;
+
+    return 0;
+}
+
 int
 db_load_DAT(void) {
     DAT_init(&dat_meta);
@@ -37,22 +82,38 @@ db_load_DAT(void) {
 
     DAT_info(&dat_meta);
 
-    return 0;
+    /* Game list is read first, resolve every slot now so lookups are plain indexing */
+    return db_join_list();
 }
 
 /* Returns 0 on success and places a pointer in item, otherwise returns 1 and
  * item = NULL */
 int
 db_get_meta(const char* id, struct db_item** item) {
-    const char* id_santized = serial_santize_meta(id);
-    uint32_t index = DAT_get_index_by_ID(&dat_meta, id_santized);
+    product_key key;
+    product_key_make(&key, id);
+    uint32_t index = db_lookup_index(&key);
 
-    if (index == 0xFFFFFFFF) {
+    if (index == DB_META_NONE) {
+        *item = NULL;
+        return 1;
+    }
+
+    *item = &db[index];
+    return 0;
+}
+
+/* Same as db_get_meta but uses the join built at load, slot_idx is a base
+ * slot index (see list_slot_index) */
+int
+db_get_meta_by_slot(int slot_idx, struct db_item** item) {
+    int product_num = list_slot_product(slot_idx);
+    if (product_num < 0 || product_num >= num_product_meta || product_meta[product_num] == DB_META_NONE) {
         *item = NULL;
         return 1;
     }
 
-    *item = &db[index - dat_first_index];
+    *item = &db[product_meta[product_num]];
     return 0;
 }
 
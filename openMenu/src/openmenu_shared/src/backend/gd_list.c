@@ -17,10 +17,18 @@
 
 #include <ini.h>
 
+#include "backend/product_key.h"
+
+/* The only table in here interns product_key */
+#define HASH_FUNCTION PRODUCT_KEY_HASH_FUNCTION
+#define HASH_KEYCMP   PRODUCT_KEY_KEYCMP
+#include <uthash.h>
+
 #include "backend/db_item.h"
 #include "backend/db_list.h"
 #include "backend/gd_item.h"
 #include "backend/gd_list.h"
+#include "backend/serial_fixup.h"
 
 #ifdef _arch_dreamcast
 #include <kos/fs.h>
@@ -45,6 +53,18 @@ static gd_item** list_temp = NULL;
 static int num_items_current = -1;
 static gd_item** list_current = NULL;
 
+/* Interned products, discs of a set share one number */
+typedef struct product_intern {
+    product_key key;
+    int product_num;
+    UT_hash_handle hh;
+} product_intern;
+
+static int num_products = 0;
+static product_intern* product_items = NULL;
+static product_intern* product_hash = NULL;
+static int* slot_product = NULL;
+
 static int num_items_alphabet = 27;
 static const struct gd_item list_alphabet_tmp[27] = {
     {"#", "", "A0", "DIR", "", "", 0, {' '}, ""},  {"A", "", "AA", "DIR", "", "", 1, {' '}, ""},
@@ -333,7 +353,7 @@ list_set_sort_filter(const char type, int num) {
 
         switch (type) {
             case 'G':
-                if (!db_get_meta(temp_item->product, &temp_meta)) {
+                if (!db_get_meta_by_slot(base_idx, &temp_meta)) {
                     if (num == 16 && !temp_meta->genre) {
                         list_temp[temp_idx++] = temp_item;
                     } else if (temp_meta->genre & matching_genre) {
@@ -399,7 +419,7 @@ list_set_genre(int matching_genre) {
 
         gd_item* temp_item = &gd_slots_BASE[base_idx];
         db_item* temp_meta;
-        if (!db_get_meta(temp_item->product, &temp_meta)) {
+        if (!db_get_meta_by_slot(base_idx, &temp_meta)) {
             if (temp_meta->genre & matching_genre) {
                 list_temp[temp_idx++] = temp_item;
             }
@@ -430,10 +450,11 @@ list_set_genre_sort(int genre, int sort) {
 void
 list_set_multidisc(const char* product_id) {
     int base_idx, temp_idx = 0;
+    int product_num = list_product_find(product_id);
 
     /* Skip openMenu itself */
-    for (base_idx = 1; base_idx < num_items_BASE; base_idx++) {
-        if (strcmp(gd_slots_BASE[base_idx].product, product_id)) {
+    for (base_idx = 1; base_idx < num_items_BASE && temp_idx < MULTIDISC_MAX_GAMES_PER_SET; base_idx++) {
+        if (product_num == LIST_PRODUCT_NONE || slot_product[base_idx] != product_num) {
             continue;
         }
 
@@ -454,73 +475,56 @@ list_multidisc_length(void) {
 
 static void
 fix_sega_serials(void) {
-    /* fixing Sega serial issues... */
+    /* fixing Sega serial issues, see serial_fixup.def */
 
     /* Skip openMenu itself */
     for (int base_idx = 1; base_idx < num_items_BASE; base_idx++) {
         gd_item* item = &gd_slots_BASE[base_idx];
 
-        /* Fix Alone in the Dark (PAL) overlapping Alone in the Dark (USA) */
-        if (!strcmp(item->product, "T15117N") && !strcmp(item->date, "20010423")) {
-            strcpy(item->product, "T15112D05");
-        }
-        /* Fix Crazy Taxi (PAL) overlapping Crazy Taxi (USA) */
-        if (!strcmp(item->product, "MK51035") && !strcmp(item->date, "20000120")) {
-            strcpy(item->product, "MK5103550");
-        }
-        /* Fix Disney's Donald Duck: Goin' Quackers (USA) overlapping Disney's
-     * Donald Duck: Quack Attack (PAL) */
-        if (!strcmp(item->product, "T17714D50") && !strcmp(item->date, "20001116")) {
-            strcpy(item->product, "T17719N");
-        }
-        /* Fix Floigan Bros (PAL) overlapping Floigan Bros (USA) */
-        if (!strcmp(item->product, "MK51114") && !strcmp(item->date, "20010920")) {
-            strcpy(item->product, "MK5111450");
-        }
-        /* Fix Legacy of Kain: Soul Reaver (PAL) overlapping Legacy of Kain: Soul
-     * Reaver (USA) */
-        if (!strcmp(item->product, "T36802N") && !strcmp(item->date, "19991220")) {
-            strcpy(item->product, "T36803D05");
-        }
-        /* Fix NBA2K2 (PAL) overlapping NBA2K2 (USA) */
-        if (!strcmp(item->product, "MK51178") && !strcmp(item->date, "20011129")) {
-            strcpy(item->product, "MK5117850");
-        }
-        /* Fix NBA Showtime (PAL) overlapping 4 Wheel Thunder (PAL) */
-        if (!strcmp(item->product, "T9706D50") && !strcmp(item->date, "19991201")) {
-            strcpy(item->product, "T9705D50");
-        }
-        /* Fix Nightmare Creatures II (USA) overlapping Dancing Blade 2 (JAP) */
-        if (!strcmp(item->product, "T9504M") && !strcmp(item->date, "20000407")) {
-            strcpy(item->product, "T9504N");
-        }
-        /* Fix Plasma Sword (PAL) overlapping Street Fighter Alpha 3 (PAL) */
-        if (!strcmp(item->product, "T7005D") && !strcmp(item->date, "20000711")) {
-            strcpy(item->product, "T7003D");
-        }
-        /* Fix Skies of Arcadia (PAL) overlapping Skies of Arcadia (USA) */
-        if (!strcmp(item->product, "MK51052") && !strcmp(item->date, "20010306")) {
-            strcpy(item->product, "MK5105250");
-        }
-        /* Fix Spider-Man (PAL) overlapping Spider-Man (USA) */
-        if (!strcmp(item->product, "T13008N") && !strcmp(item->date, "20010402")) {
-            strcpy(item->product, "T13011D50");
-        }
-        /* Fix TNN Motorsports (USA) overlapping Metal Slug 6 (AW) */
-        if (!strcmp(item->product, "T0000M") && !strcmp(item->date, "19990813")) {
-            strcpy(item->product, "T13701N");
+        const char* fixed_product = serial_fixup_product(item->product, item->date, item->name);
+        if (fixed_product) {
+            strcpy(item->product, fixed_product);
         }
+    }
+}
 
-        /* Fix Maximum Speed (AW) overlapping Dolphin Blue (AW) */
-        if (!strcmp(item->product, "T0006M") && !strcmp(item->date, "20030609")) {
-            strcpy(item->product, "T0010M");
-        }
+static void
+list_products_destroy(void) {
+    HASH_CLEAR(hh, product_hash);
+    free(product_items);
+    free(slot_product);
+    product_items = NULL;
+    slot_product = NULL;
+    num_products = 0;
+}
+
+static int
+list_intern_products(void) {
+    list_products_destroy();
+
+    product_items = malloc(num_items_BASE * sizeof(product_intern));
+    slot_product = malloc(num_items_BASE * sizeof(int));
+    if (!product_items || !slot_product) {
+        printf("%s no free memory\n", __func__);
+        return -1;
+    }
 
-        /* Fix Fist of North Star (AW) overlapping Rumble Fish (AW) */
-        if (!strcmp(item->product, "T0009M") && strstr(item->name, "orth")) {
-            strcpy(item->product, "T0026M");
+    for (int base_idx = 0; base_idx < num_items_BASE; base_idx++) {
+        product_key key;
+        product_intern* intern;
+
+        product_key_make(&key, gd_slots_BASE[base_idx].product);
+        HASH_FIND(hh, product_hash, &key, sizeof(product_key), intern);
+        if (!intern) {
+            intern = &product_items[num_products];
+            intern->key = key;
+            intern->product_num = num_products++;
+            HASH_ADD(hh, product_hash, key, sizeof(product_key), intern);
         }
+        slot_product[base_idx] = intern->product_num;
     }
+
+    return 0;
 }
 
 int
@@ -575,6 +579,9 @@ list_read(const char* filename) {
     }
 
     fix_sega_serials();
+    if (list_intern_products()) {
+        return -1;
+    }
 
     printf("INI:Parse success (%d items)!\n", num_items_BASE);
     list_temp_reset();
@@ -590,6 +597,7 @@ list_read_default(void) {
 
 void
 list_destroy(void) {
+    list_products_destroy();
     num_items_BASE = -1;
     num_items_temp = -1;
     free(gd_slots_BASE);
@@ -607,6 +615,65 @@ list_item_get(int idx) {
     return NULL;
 }
 
+int
+list_slots_length(void) {
+    return num_items_BASE;
+}
+
+const gd_item*
+list_slot_get(int slot_idx) {
+    if ((slot_idx >= 0) && (slot_idx < num_items_BASE)) {
+        return (const gd_item*)&gd_slots_BASE[slot_idx];
+    }
+
+    return NULL;
+}
+
+/* Returns the base slot index backing item, or -1 for synthetic entries
+ * (directories, back button, folder nodes) */
+int
+list_slot_index(const struct gd_item* item) {
+    if (!gd_slots_BASE || item < gd_slots_BASE || item >= gd_slots_BASE + num_items_BASE) {
+        return -1;
+    }
+
+    return (int)(item - gd_slots_BASE);
+}
+
+int
+list_products_length(void) {
+    return num_products;
+}
+
+int
+list_product_find(const char* product) {
+    product_key key;
+    const product_intern* intern;
+
+    product_key_make(&key, product);
+    HASH_FIND(hh, product_hash, &key, sizeof(product_key), intern);
+
+    return intern ? intern->product_num : LIST_PRODUCT_NONE;
+}
+
+int
+list_slot_product(int slot_idx) {
+    if (slot_product && (slot_idx >= 0) && (slot_idx < num_items_BASE)) {
+        return slot_product[slot_idx];
+    }
+
+    return LIST_PRODUCT_NONE;
+}
+
+const product_key*
+list_product_key(int product_num) {
+    if ((product_num >= 0) && (product_num < num_products)) {
+        return &product_items[product_num].key;
+    }
+
+    return NULL;
+}
+
 /* Folder navigation system functions */
 
 static int
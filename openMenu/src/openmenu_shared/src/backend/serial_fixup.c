@@ -0,0 +1,108 @@
+/*
+ * File: serial_fixup.c
+ * Project: backend
+ * File Created: Sunday, 18th October 2026 12:04:17 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License,
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "backend/serial_fixup.h"
+
+typedef struct serial_fixup {
+    const char* product;
+    const char* date;
+    const char* name_contains;
+    const char* fixed_product;
+} serial_fixup;
+
+static const serial_fixup fixup_members[] = {
+#define FIXUP(product, date, name_contains, fixed) {product, date, name_contains, fixed},
+#include "backend/serial_fixup.def"
+};
+
+#define FIXUP_COUNT ((int)(sizeof(fixup_members) / sizeof(serial_fixup)))
+/* Power of two, kept at least 4x the entry count so probes stay short */
+#define FIXUP_TABLE_SIZE (64)
+#define FIXUP_EMPTY (0xFF)
+
+_Static_assert(FIXUP_COUNT * 4 <= FIXUP_TABLE_SIZE, "grow FIXUP_TABLE_SIZE");
+
+static uint8_t fixup_table[FIXUP_TABLE_SIZE];
+static int fixup_table_ready = 0;
+
+/* FNV-1a, product then date so the product-only hash is a prefix state */
+static uint32_t
+fixup_hash(uint32_t h, const char* str) {
+    while (*str) {
+        h ^= (uint8_t)*str++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static uint32_t
+fixup_key_product(const char* product) {
+    uint32_t h = fixup_hash(2166136261u, product);
+    /* Separator keeps ("T1", "23") apart from ("T12", "3") */
+    h ^= 0xFF;
+    h *= 16777619u;
+    return h;
+}
+
+static void
+fixup_table_build(void) {
+    memset(fixup_table, FIXUP_EMPTY, sizeof(fixup_table));
+    for (int i = 0; i < FIXUP_COUNT; i++) {
+        const serial_fixup* fixup = &fixup_members[i];
+        uint32_t key = fixup_key_product(fixup->product);
+        if (fixup->date) {
+            key = fixup_hash(key, fixup->date);
+        }
+
+        uint32_t slot = key & (FIXUP_TABLE_SIZE - 1);
+        while (fixup_table[slot] != FIXUP_EMPTY) {
+            slot = (slot + 1) & (FIXUP_TABLE_SIZE - 1);
+        }
+        fixup_table[slot] = (uint8_t)i;
+    }
+    fixup_table_ready = 1;
+}
+
+static const serial_fixup*
+fixup_find(uint32_t key, const char* product, const char* date, const char* name) {
+    uint32_t slot = key & (FIXUP_TABLE_SIZE - 1);
+
+    while (fixup_table[slot] != FIXUP_EMPTY) {
+        const serial_fixup* fixup = &fixup_members[fixup_table[slot]];
+        if (!strcmp(fixup->product, product) && (!fixup->date || (date && !strcmp(fixup->date, date)))
+            && (!fixup->name_contains || (name && strstr(name, fixup->name_contains)))) {
+            return fixup;
+        }
+        slot = (slot + 1) & (FIXUP_TABLE_SIZE - 1);
+    }
+    return NULL;
+}
+
+const char*
+serial_fixup_product(const char* product, const char* date, const char* name) {
+    if (!fixup_table_ready) {
+        fixup_table_build();
+    }
+
+    /* Exact release first, then entries that only need the product (and name) */
+    uint32_t key_product = fixup_key_product(product);
+    uint32_t key_release = (date && date[0]) ? fixup_hash(key_product, date) : key_product;
+
+    const serial_fixup* fixup = fixup_find(key_release, product, date, name);
+    if (!fixup && key_release != key_product) {
+        fixup = fixup_find(key_product, product, date, name);
+    }
+
+    return fixup ? fixup->fixed_product : NULL;
+}
@@ -12,6 +12,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <backend/product_key.h>
+
+/* Every table in here is keyed by product_key */
+#define HASH_FUNCTION PRODUCT_KEY_HASH_FUNCTION
+#define HASH_KEYCMP   PRODUCT_KEY_KEYCMP
 #include <uthash.h>
 
 #include <backend/dat_format.h>
@@ -98,7 +103,11 @@ DAT_load_parse(dat_file* bin, const char* path) {
 #else
         fread(&bin->items[i], sizeof(bin_item_raw), 1, bin->handle);
 #endif
-        HASH_ADD_STR(bin->hash, ID, &bin->items[i]);
+        /* IDs on disc may carry junk after the terminator, repack them */
+        product_key key;
+        product_key_make(&key, bin->items[i].ID);
+        bin->items[i].key = key;
+        HASH_ADD(hh, bin->hash, key, sizeof(product_key), &bin->items[i]);
     }
 
     /* Leave our handle in a handy place in case we need to read after */
@@ -121,11 +130,11 @@ DAT_info(const dat_file* bin) {
 }
 
 uint32_t
-DAT_get_offset_by_ID(const dat_file* bin, const char* ID) {
+DAT_get_offset_by_key(const dat_file* bin, const product_key* key) {
     const bin_item* item;
     uint32_t ret;
 
-    HASH_FIND_STR(bin->hash, ID, item);
+    HASH_FIND(hh, bin->hash, key, sizeof(product_key), item);
     if (item) {
         ret = item->offset * bin->chunk_size;
     } else {
@@ -136,11 +145,11 @@ DAT_get_offset_by_ID(const dat_file* bin, const char* ID) {
 }
 
 uint32_t
-DAT_get_index_by_ID(const dat_file* bin, const char* ID) {
+DAT_get_index_by_key(const dat_file* bin, const product_key* key) {
     const bin_item* item;
     uint32_t ret;
 
-    HASH_FIND_STR(bin->hash, ID, item);
+    HASH_FIND(hh, bin->hash, key, sizeof(product_key), item);
     if (item) {
         ret = item->offset;
     } else {
@@ -150,6 +159,29 @@ DAT_get_index_by_ID(const dat_file* bin, const char* ID) {
     return ret;
 }
 
+uint32_t
+DAT_get_offset_by_num(const dat_file* bin, uint32_t chunk_num) {
+    /* chunk 0 is the header */
+    if (!chunk_num || chunk_num > bin->num_chunks) {
+        return 0;
+    }
+    return chunk_num * bin->chunk_size;
+}
+
+uint32_t
+DAT_get_offset_by_ID(const dat_file* bin, const char* ID) {
+    product_key key;
+    product_key_make(&key, ID);
+    return DAT_get_offset_by_key(bin, &key);
+}
+
+uint32_t
+DAT_get_index_by_ID(const dat_file* bin, const char* ID) {
+    product_key key;
+    product_key_make(&key, ID);
+    return DAT_get_index_by_key(bin, &key);
+}
+
 int
 DAT_read_file_by_ID(const dat_file* bin, const char* ID, void* buf) {
     uint32_t offset = DAT_get_offset_by_ID(bin, ID);
@@ -0,0 +1,136 @@
+/* Generated by remapgen from serial_remap.tsv, do not edit by hand */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "texture/serial_remap.h"
+
+#define SERIAL_REMAP_COUNT (117)
+#define SERIAL_REMAP_BUCKETS (32)
+#define SERIAL_REMAP_SLOTS (256)
+
+static const uint16_t serial_remap_disp[SERIAL_REMAP_BUCKETS] = {
+    1, 0, 1, 8, 4, 2, 0, 3, 0, 3, 3, 4, 0, 0, 0, 0,
+    0, 0, 5, 5, 0, 1, 5, 1, 2, 5, 0, 3, 1, 0, 0, 1,
+};
+
+static const serial_remap serial_remap_table[SERIAL_REMAP_SLOTS] = {
+    [0] = {{.str = "T15109D"}, {{0}}, {.str = "T15108N"}, REMAP_META},
+    [4] = {{.str = "MK5102850"}, {{0}}, {.str = "MK51028"}, REMAP_META},
+    [6] = {{.str = "T8101D50"}, {{0}}, {.str = "T8102N"}, REMAP_META},
+    [7] = {{.str = "T9503D"}, {{0}}, {.str = "T9512N"}, REMAP_META},
+    [10] = {{.str = "T8102D"}, {{0}}, {.str = "T8101N"}, REMAP_META},
+    [12] = {{.str = "T30803M"}, {{0}}, {.str = "T40211N"}, REMAP_META},
+    [17] = {{.str = "T8104D"}, {{0}}, {.str = "T8106N"}, REMAP_META},
+    [21] = {{.str = "T40204D"}, {{0}}, {.str = "T40205N"}, REMAP_META},
+    [23] = {{.str = "T17710D50"}, {{0}}, {.str = "T17713N"}, REMAP_META},
+    [25] = {{.str = "T7004D"}, {{0}}, {.str = "T1205N"}, REMAP_META},
+    [26] = {{.str = "MK5109450"}, {{0}}, {.str = "T44301N"}, REMAP_META},
+    [27] = {{.str = "HDR0129"}, {{0}}, {.str = "MK51100"}, REMAP_META},
+    [28] = {{.str = "T45001D18"}, {.str = "T45001D05"}, {.str = "T45001D05"}, REMAP_ART | REMAP_META}, /* Tom Clancy's Rainbow Six */
+    [30] = {{.str = "T45002D09"}, {.str = "T45002D05"}, {.str = "T45002D05"}, REMAP_ART | REMAP_META}, /* Tom Clancy's Rainbow Six: Rogue Spear */
+    [31] = {{.str = "T7009D50"}, {{0}}, {.str = "T1208N"}, REMAP_META},
+    [34] = {{.str = "MK5100050"}, {{0}}, {.str = "MK51000"}, REMAP_META},
+    [37] = {{.str = "T41401D"}, {{0}}, {.str = "T41401N"}, REMAP_META},
+    [39] = {{.str = "T36815D06"}, {.str = "T36804D05"}, {.str = "T36804D05"}, REMAP_ART | REMAP_META}, /* Tomb Raider Chronicles */
+    [40] = {{.str = "T40601D"}, {{0}}, {.str = "T40601N"}, REMAP_META},
+    [41] = {{.str = "MK5100450"}, {{0}}, {.str = "MK51004"}, REMAP_META},
+    [45] = {{.str = "T23001D"}, {{0}}, {.str = "T23001N"}, REMAP_META},
+    [48] = {{.str = "T8112D50"}, {{0}}, {.str = "T8116N"}, REMAP_META},
+    [49] = {{.str = "T45001D05"}, {{0}}, {.str = "T40401N"}, REMAP_META},
+    [52] = {{.str = "HDR0163"}, {{0}}, {.str = "MK51193"}, REMAP_META},
+    [54] = {{.str = "T9709D50"}, {{0}}, {.str = "T9707N"}, REMAP_META},
+    [57] = {{.str = "T15106D"}, {{0}}, {.str = "T15113N"}, REMAP_META},
+    [58] = {{.str = "T15113D"}, {{0}}, {.str = "T15125N"}, REMAP_META},
+    [60] = {{.str = "T10001D"}, {{0}}, {.str = "T10004N"}, REMAP_META},
+    [62] = {{.str = "T36804D05"}, {{0}}, {.str = "T36806N"}, REMAP_META},
+    [63] = {{.str = "T13011D50"}, {{0}}, {.str = "T13008N"}, REMAP_META}, /* Spider-Man */
+    [65] = {{.str = "HDR0029"}, {{0}}, {.str = "MK51051"}, REMAP_META},
+    [66] = {{.str = "T13002D"}, {{0}}, {.str = "T13002N"}, REMAP_META},
+    [69] = {{.str = "T7013D50"}, {{0}}, {.str = "T1213N"}, REMAP_META},
+    [73] = {{.str = "HDR0053"}, {{0}}, {.str = "MK51035"}, REMAP_META},
+    [75] = {{.str = "MK5109506"}, {.str = "MK5109505"}, {.str = "MK5109505"}, REMAP_ART | REMAP_META}, /* UEFA Dream Soccer */
+    [76] = {{.str = "MK5101950"}, {{0}}, {.str = "MK51019"}, REMAP_META},
+    [78] = {{.str = "MK5109509"}, {.str = "MK5109505"}, {.str = "MK5109505"}, REMAP_ART | REMAP_META}, /* UEFA Dream Soccer */
+    [79] = {{.str = "T45001D09"}, {.str = "T45001D05"}, {.str = "T45001D05"}, REMAP_ART | REMAP_META}, /* Tom Clancy's Rainbow Six */
+    [80] = {{.str = "T8103N50"}, {{0}}, {.str = "T8103N"}, REMAP_META},
+    [82] = {{.str = "T17726D"}, {{0}}, {.str = "T40212N"}, REMAP_META},
+    [96] = {{.str = "T36807D"}, {{0}}, {.str = "T36805N"}, REMAP_META},
+    [98] = {{.str = "T17702D"}, {{0}}, {.str = "T17702N"}, REMAP_META},
+    [99] = {{.str = "T8117D50"}, {{0}}, {.str = "T8118N"}, REMAP_META},
+    [101] = {{.str = "HDR0016"}, {{0}}, {.str = "MK5105950"}, REMAP_META},
+    [102] = {{.str = "T17722D"}, {{0}}, {.str = "T40207N"}, REMAP_META},
+    [104] = {{.str = "MK5117850"}, {{0}}, {.str = "MK51178"}, REMAP_META}, /* NBA 2K2 */
+    [105] = {{.str = "17707D"}, {{0}}, {.str = "17707N"}, REMAP_META},
+    [107] = {{.str = "MK5105450"}, {{0}}, {.str = "MK51054"}, REMAP_META},
+    [111] = {{.str = "T8107D"}, {{0}}, {.str = "T8109N"}, REMAP_META},
+    [112] = {{.str = "T9713D"}, {{0}}, {.str = "T9709N"}, REMAP_META},
+    [113] = {{.str = "T7003D"}, {{0}}, {.str = "T1207N"}, REMAP_META},
+    [115] = {{.str = "T7006D"}, {{0}}, {.str = "T1210N"}, REMAP_META},
+    [116] = {{.str = "T3602M"}, {{0}}, {.str = "T3601N"}, REMAP_META},
+    [117] = {{.str = "T7021D"}, {{0}}, {.str = "T1220N"}, REMAP_META},
+    [118] = {{.str = "MK5106050"}, {{0}}, {.str = "MK51060"}, REMAP_META},
+    [120] = {{.str = "T40210D"}, {{0}}, {.str = "T40211N"}, REMAP_META},
+    [122] = {{.str = "MK5100250"}, {{0}}, {.str = "MK51002"}, REMAP_META},
+    [123] = {{.str = "T36810D"}, {{0}}, {.str = "T36810N"}, REMAP_META},
+    [124] = {{.str = "T17721D"}, {{0}}, {.str = "T40216N"}, REMAP_META},
+    [125] = {{.str = "T8111D58"}, {.str = "T8111D50"}, {.str = "T8111D50"}, REMAP_ART | REMAP_META}, /* ECW Hardcore Revolution */
+    [131] = {{.str = "T40206D"}, {{0}}, {.str = "T40206N"}, REMAP_META},
+    [132] = {{.str = "T8103N18"}, {.str = "T8103N50"}, {.str = "T8103N50"}, REMAP_ART | REMAP_META}, /* WWF Attitude */
+    [133] = {{.str = "T40203D"}, {{0}}, {.str = "T40204N"}, REMAP_META},
+    [135] = {{.str = "T40504D"}, {{0}}, {.str = "T8111N"}, REMAP_META},
+    [137] = {{.str = "T13008D"}, {{0}}, {.str = "T13006N"}, REMAP_META},
+    [141] = {{.str = "T10003D"}, {{0}}, {.str = "T10005N"}, REMAP_META},
+    [142] = {{.str = "T8110D50"}, {{0}}, {.str = "T8110N"}, REMAP_META},
+    [143] = {{.str = "MK5100650"}, {{0}}, {.str = "MK51006"}, REMAP_META},
+    [145] = {{.str = "T36808D"}, {{0}}, {.str = "T36808N"}, REMAP_META},
+    [150] = {{.str = "HDR0010"}, {{0}}, {.str = "MK51019"}, REMAP_META},
+    [155] = {{.str = "T7012D"}, {{0}}, {.str = "T40218N"}, REMAP_META},
+    [156] = {{.str = "T22901D"}, {{0}}, {.str = "T22901N"}, REMAP_META},
+    [161] = {{.str = "T45006D50"}, {{0}}, {.str = "17701N"}, REMAP_META},
+    [162] = {{.str = "MK5105150"}, {{0}}, {.str = "MK51051"}, REMAP_META},
+    [167] = {{.str = "T9502D50"}, {{0}}, {.str = "T9504N"}, REMAP_META}, /* Nightmare Creatures II */
+    [168] = {{.str = "T40201D"}, {{0}}, {.str = "T40202N"}, REMAP_META},
+    [170] = {{.str = "T15104D"}, {{0}}, {.str = "T15106N"}, REMAP_META},
+    [172] = {{.str = "T8105D50"}, {{0}}, {.str = "T8105N"}, REMAP_META},
+    [175] = {{.str = "MK5109518"}, {.str = "MK5109505"}, {.str = "MK5109505"}, REMAP_ART | REMAP_META}, /* UEFA Dream Soccer */
+    [176] = {{.str = "T9705D50"}, {{0}}, {.str = "T9706N"}, REMAP_META},
+    [180] = {{.str = "T8108D"}, {{0}}, {.str = "T8108N"}, REMAP_META},
+    [181] = {{.str = "T9505D"}, {{0}}, {.str = "T9507N"}, REMAP_META},
+    [183] = {{.str = "T36816D"}, {{0}}, {.str = "T1216N"}, REMAP_META},
+    [184] = {{.str = "MK5106150"}, {{0}}, {.str = "MK51061"}, REMAP_META},
+    [185] = {{.str = "T17713D"}, {{0}}, {.str = "T17718N"}, REMAP_META},
+    [186] = {{.str = "T45002D05"}, {{0}}, {.str = "T40402N"}, REMAP_META},
+    [187] = {{.str = "MK5110250"}, {{0}}, {.str = "MK51102"}, REMAP_META},
+    [189] = {{.str = "T17723D"}, {{0}}, {.str = "T40209N"}, REMAP_META},
+    [192] = {{.str = "T7005D"}, {{0}}, {.str = "T1203N"}, REMAP_META},
+    [193] = {{.str = "T8106D50"}, {{0}}, {.str = "T31101N"}, REMAP_META},
+    [195] = {{.str = "T40903M"}, {{0}}, {.str = "T40901M"}, REMAP_META},
+    [197] = {{.str = "HDR0054"}, {{0}}, {.str = "MK51053"}, REMAP_META}, /* Sega GT */
+    [200] = {{.str = "MK5105350"}, {{0}}, {.str = "MK51053"}, REMAP_META},
+    [202] = {{.str = "T1401D"}, {{0}}, {.str = "T1401N"}, REMAP_META},
+    [203] = {{.str = "T9703D50"}, {{0}}, {.str = "T9703N"}, REMAP_META},
+    [207] = {{.str = "T13001D05"}, {.str = "T13001D"}, {.str = "T13001D"}, REMAP_ART | REMAP_META}, /* Blue Stinger */
+    [210] = {{.str = "HDR0164"}, {{0}}, {.str = "MK5118450"}, REMAP_META},
+    [211] = {{.str = "T36815D05"}, {{0}}, {.str = "T36812N"}, REMAP_META},
+    [212] = {{.str = "T36815D13"}, {.str = "T36804D05"}, {.str = "T36804D05"}, REMAP_ART | REMAP_META}, /* Tomb Raider Chronicles */
+    [215] = {{.str = "T36815D18"}, {.str = "T36804D05"}, {.str = "T36804D05"}, REMAP_ART | REMAP_META}, /* Tomb Raider Chronicles */
+    [219] = {{.str = "T17711D"}, {{0}}, {.str = "T17708N"}, REMAP_META},
+    [222] = {{.str = "T3601M"}, {{0}}, {.str = "T3602M"}, REMAP_META},
+    [224] = {{.str = "MK5101153"}, {{0}}, {.str = "MK51011"}, REMAP_META},
+    [225] = {{.str = "T36809D"}, {{0}}, {.str = "T36804N"}, REMAP_META},
+    [227] = {{.str = "T17703D"}, {{0}}, {.str = "T17703N"}, REMAP_META},
+    [228] = {{.str = "MK5102050"}, {{0}}, {.str = "MK57020"}, REMAP_META},
+    [230] = {{.str = "HDR0159"}, {{0}}, {.str = "MK51136"}, REMAP_META},
+    [232] = {{.str = "T13010D"}, {{0}}, {.str = "T23003N"}, REMAP_META},
+    [233] = {{.str = "17701D"}, {{0}}, {.str = "17701N"}, REMAP_META},
+    [234] = {{.str = "MK5102151"}, {{0}}, {.str = "T40215N"}, REMAP_META},
+    [239] = {{.str = "MK5102550"}, {{0}}, {.str = "MK51025"}, REMAP_META},
+    [242] = {{.str = "MK5100150"}, {{0}}, {.str = "MK51001"}, REMAP_META},
+    [244] = {{.str = "T7016D"}, {{0}}, {.str = "T22904N"}, REMAP_META},
+    [248] = {{.str = "HDR0178"}, {{0}}, {.str = "MK5119250"}, REMAP_META},
+    [250] = {{.str = "HDR0063"}, {{0}}, {.str = "MK51092"}, REMAP_META},
+    [251] = {{.str = "T45004D"}, {{0}}, {.str = "T41704N"}, REMAP_META},
+    [255] = {{.str = "T30801M"}, {{0}}, {.str = "T40202N"}, REMAP_META},
+};
@@ -0,0 +1,286 @@
+/*
+ * File: atlaspack.c
+ * Project: tools
+ * File Created: Sunday, 18th October 2026 9:40:18 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+#include <ctype.h>
+#include <dirent.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32) || defined(WIN32)
+#define PATH_SEP "\\"
+#else
+#define PATH_SEP "/"
+#endif
+
+/* Called:
+./atlaspack INPUT_FOLDER OUTPUT_FOLDER [page_size]
+
+packs every 16bit square .pvr in the folder onto twiddled atlas pages of
+page_size texels across (512 or 1024), written as ICONATL0.PVR and up. Each
+page is a normal PVR followed by a "PVAT" block indexing the icons on it by
+filename, openMenu keeps these resident and draws icons from them without
+loading them from ICON.DAT. Icons of different color formats go on different
+pages. Larger icons are placed first in twiddled order, which keeps every
+icon on a boundary of its own size with no gaps.
+*/
+
+#define NUM_ARGS (2)
+#define MAX_FILES (8192)
+#define MAX_PAGES (8) /* the menu stops looking after this many */
+#define MIN_CELL (32)
+#define ENTRY_SIZE (20)
+
+/* PVRT color formats, only 16bit ones can be packed */
+#define PVR_ARGB4444 (0x02)
+
+/* PVRT layouts */
+#define PVR_TWIDDLED (0x01)
+#define PVR_RECTANGLE (0x09)
+#define PVR_RECT_TWIDDLED (0x0D)
+
+typedef struct icon {
+  char id[12];
+  int color, layout;
+  int size;
+  unsigned char *file;
+  const unsigned char *pixels;
+} icon;
+
+static icon icons[MAX_FILES];
+static int num_icons = 0;
+static const char *in_folder;
+static const char *out_folder;
+static int page_size = 512;
+
+static uint32_t twiddle(uint32_t x, uint32_t y) {
+  uint32_t out = 0;
+  for (int bit = 0; bit < 16; bit++) {
+    out |= ((y >> bit) & 1) << (bit * 2);
+    out |= ((x >> bit) & 1) << (bit * 2 + 1);
+  }
+  return out;
+}
+
+static void untwiddle(uint32_t offset, uint32_t *x, uint32_t *y) {
+  *x = *y = 0;
+  for (int bit = 0; bit < 16; bit++) {
+    *y |= ((offset >> (bit * 2)) & 1) << bit;
+    *x |= ((offset >> (bit * 2 + 1)) & 1) << bit;
+  }
+}
+
+static void put_u16(unsigned char *dst, uint16_t v) {
+  dst[0] = v & 0xFF;
+  dst[1] = v >> 8;
+}
+
+static void put_u32(unsigned char *dst, uint32_t v) {
+  put_u16(dst, v & 0xFFFF);
+  put_u16(dst + 2, v >> 16);
+}
+
+static unsigned char *read_file(const char *name, size_t *size) {
+  char path[FILENAME_MAX];
+  snprintf(path, sizeof(path), "%s%s%s", in_folder, PATH_SEP, name);
+  FILE *fd = fopen(path, "rb");
+  if (!fd) {
+    printf("ERR: cant read %s\n", path);
+    return NULL;
+  }
+  fseek(fd, 0, SEEK_END);
+  *size = (size_t)ftell(fd);
+  fseek(fd, 0, SEEK_SET);
+  unsigned char *data = malloc(*size);
+  if (!data || fread(data, *size, 1, fd) != 1) {
+    printf("ERR: cant read %s\n", path);
+    free(data);
+    data = NULL;
+  }
+  fclose(fd);
+  return data;
+}
+
+/* Only square power of two 16bit textures up to a page, 0 if it can't be packed */
+static int parse_icon(const unsigned char *in, size_t in_size, icon *ico) {
+  size_t pvrt = 0;
+  if (in_size >= 16 && !memcmp(in, "GBIX", 4))
+    pvrt = 8 + (in[4] | in[5] << 8 | in[6] << 16 | (uint32_t)in[7] << 24);
+  if (in_size < pvrt + 16 || memcmp(in + pvrt, "PVRT", 4))
+    return 0;
+
+  const int width = in[pvrt + 12] | in[pvrt + 13] << 8;
+  const int height = in[pvrt + 14] | in[pvrt + 15] << 8;
+  ico->color = in[pvrt + 8];
+  ico->layout = in[pvrt + 9];
+  ico->size = width;
+  ico->pixels = in + pvrt + 16;
+
+  if (ico->color > PVR_ARGB4444 || width != height || width < MIN_CELL || width > page_size || (width & (width - 1)))
+    return 0;
+  if (ico->layout != PVR_TWIDDLED && ico->layout != PVR_RECT_TWIDDLED && ico->layout != PVR_RECTANGLE)
+    return 0;
+  return in_size >= pvrt + 16 + (size_t)width * height * 2;
+}
+
+/* Filename without extension, upper case, same as datpack */
+static int make_id(const char *name, char *id) {
+  const char *dot = strrchr(name, '.');
+  if ((size_t)(dot - name) > 11) {
+    printf("Err: filename too long \"%s\", maxlength = 11!\n", name);
+    return -1;
+  }
+  memset(id, '\0', 12);
+  for (int i = 0; name + i < dot; i++)
+    id[i] = (char)toupper(name[i]);
+  return 0;
+}
+
+static int cmp_icon(const void *a, const void *b) {
+  const icon *ia = (const icon *)a;
+  const icon *ib = (const icon *)b;
+  if (ia->color != ib->color)
+    return ia->color - ib->color;
+  if (ia->size != ib->size)
+    return ib->size - ia->size;
+  return strcmp(ia->id, ib->id);
+}
+
+/* Writes icons [first, last) as one page */
+static int write_page(int page_num, int first, int last) {
+  const size_t data_size = (size_t)page_size * page_size * 2;
+  const size_t index_size = 4 + (size_t)(last - first) * ENTRY_SIZE;
+  const size_t file_size = 32 + data_size + 8 + index_size;
+  unsigned char *out = calloc(1, file_size);
+  if (!out)
+    return -1;
+
+  memcpy(out, "GBIX", 4);
+  put_u32(out + 4, 8);
+  memcpy(out + 16, "PVRT", 4);
+  put_u32(out + 20, (uint32_t)(8 + data_size));
+  out[24] = (unsigned char)icons[first].color;
+  out[25] = PVR_TWIDDLED;
+  put_u16(out + 28, (uint16_t)page_size);
+  put_u16(out + 30, (uint16_t)page_size);
+
+  unsigned char *page = out + 32;
+  unsigned char *index = page + data_size;
+  memcpy(index, "PVAT", 4);
+  put_u32(index + 4, (uint32_t)index_size);
+  put_u16(index + 8, (uint16_t)(last - first));
+
+  uint32_t offset = 0;
+  for (int i = first; i < last; i++) {
+    const icon *ico = &icons[i];
+    uint32_t x, y;
+    untwiddle(offset, &x, &y);
+    for (int ty = 0; ty < ico->size; ty++) {
+      for (int tx = 0; tx < ico->size; tx++) {
+        const size_t src = (ico->layout == PVR_RECTANGLE) ? (size_t)ty * ico->size + tx : twiddle(tx, ty);
+        const size_t dst = twiddle(x + tx, y + ty);
+        page[dst * 2] = ico->pixels[src * 2];
+        page[dst * 2 + 1] = ico->pixels[src * 2 + 1];
+      }
+    }
+
+    unsigned char *entry = index + 12 + (i - first) * ENTRY_SIZE;
+    memcpy(entry, ico->id, 12);
+    put_u16(entry + 12, (uint16_t)x);
+    put_u16(entry + 14, (uint16_t)y);
+    put_u16(entry + 16, (uint16_t)ico->size);
+    offset += (uint32_t)(ico->size * ico->size);
+  }
+
+  char path[FILENAME_MAX];
+  snprintf(path, sizeof(path), "%s%sICONATL%d.PVR", out_folder, PATH_SEP, page_num);
+  FILE *fd = fopen(path, "wb");
+  if (!fd) {
+    printf("ERR: cant write %s\n", path);
+    free(out);
+    return -1;
+  }
+  fwrite(out, file_size, 1, fd);
+  fclose(fd);
+  free(out);
+  printf("%s: %d icons, %u of %d texels\n", path, last - first, offset, page_size * page_size);
+  return 0;
+}
+
+static int has_pvr_ext(const char *name) {
+  const char *dot = strrchr(name, '.');
+  return dot && tolower(dot[1]) == 'p' && tolower(dot[2]) == 'v' && tolower(dot[3]) == 'r' && !dot[4];
+}
+
+int main(int argc, char **argv) {
+  if (argc < NUM_ARGS + 1 /*binary itself*/) {
+    printf("Incorrect usage!\n\t./atlaspack INPUT_FOLDER OUTPUT_FOLDER [512|1024]\n");
+    return 1;
+  }
+  in_folder = argv[1];
+  out_folder = argv[2];
+  if (argc > 3)
+    page_size = atoi(argv[3]);
+  if (page_size != 512 && page_size != 1024) {
+    printf("ERR: page size has to be 512 or 1024\n");
+    return 1;
+  }
+
+  DIR *dir = opendir(in_folder);
+  if (!dir) {
+    printf("ERR: cant open %s\n", in_folder);
+    return 1;
+  }
+  struct dirent *entry;
+  int skipped = 0;
+  while ((entry = readdir(dir)) && num_icons < MAX_FILES) {
+    if (!has_pvr_ext(entry->d_name))
+      continue;
+    icon *ico = &icons[num_icons];
+    size_t size;
+    if (make_id(entry->d_name, ico->id) || !(ico->file = read_file(entry->d_name, &size)))
+      continue;
+    if (!parse_icon(ico->file, size, ico)) {
+      printf("Skipping %s, not a square 16bit texture\n", entry->d_name);
+      free(ico->file);
+      skipped++;
+      continue;
+    }
+    num_icons++;
+  }
+  closedir(dir);
+
+  qsort(icons, num_icons, sizeof(icon), cmp_icon);
+
+  /* Sorted largest first each icon lands aligned, a page ends when the next won't fit */
+  int pages = 0, first = 0;
+  uint32_t used = 0;
+  for (int i = 0; i <= num_icons; i++) {
+    const int end_page = (i == num_icons) || (i > first && icons[i].color != icons[first].color)
+                         || used + (uint32_t)(icons[i].size * icons[i].size) > (uint32_t)(page_size * page_size);
+    if (end_page && i > first) {
+      if (write_page(pages, first, i))
+        return EXIT_FAILURE;
+      pages++;
+      first = i;
+      used = 0;
+    }
+    if (i < num_icons)
+      used += (uint32_t)(icons[i].size * icons[i].size);
+  }
+
+  for (int i = 0; i < num_icons; i++)
+    free(icons[i].file);
+
+  printf("%d icons on %d pages, %d skipped\n", num_icons, pages, skipped);
+  if (pages > MAX_PAGES)
+    printf("WARN: only the first %d pages are loaded\n", MAX_PAGES);
+  return EXIT_SUCCESS;
+}
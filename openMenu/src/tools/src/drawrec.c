@@ -0,0 +1,426 @@
+/*
+ * File: drawrec.c
+ * Project: tools
+ * File Created: Sunday, 18th October 2026 11:05:12 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <dc/pvr.h>
+
+#include <backend/db_list.h>
+#include <backend/gdemu_sdk.h>
+#include <backend/gd_list.h>
+#include <openmenu_savefile.h>
+#include <openmenu_settings.h>
+#include "ui/common.h"
+#include "ui/dc/input.h"
+#include "ui/dc/text_cache.h"
+#include "ui/draw_prototypes.h"
+#include "ui/theme_manager.h"
+#include "ui/ui_common.h"
+#include "ui/ui_stats_overlay.h"
+
+/* UI Collection */
+#include "ui/ui_grid.h"
+#undef UI_NAME
+#include "ui/ui_line_desc.h"
+#undef UI_NAME
+#include "ui/ui_scroll.h"
+#undef UI_NAME
+#include "ui/ui_folders.h"
+#undef UI_NAME
+
+#include "texture/simple_texture_allocator.h"
+#include "texture/txr_manager.h"
+#include "texture/txr_stream.h"
+#include "texture/vram_heap.h"
+
+#include "drawrec.h"
+
+/* Called:
+./drawrec [-u ui] [-n frames] [-i input] [-g games] [-o capture.drl] [-v] DATA_FOLDER
+./drawrec -r capture.drl [-v]
+
+runs the menu's UIs on the host, built as for the Dreamcast against stand-ins
+for KOS, and reports what every frame sends to the PVR: headers, vertices,
+texture binds and bytes per list. DATA_FOLDER is laid out like the disc
+(OPENMENU.INI, META.DAT, ICON.DAT, BOX.DAT, THEME, FONT), -g writes a list of
+fake games for folders without an OPENMENU.INI. -o keeps every frame's
+display lists, see drawrec.h for the layout, -r counts a capture again.
+
+input is one character per frame, repeated: udlr for the dpad, abxys for the
+buttons, LR for the triggers and . for nothing. -v prints every frame.
+*/
+
+#define DEFAULT_FRAMES (300)
+#define DEFAULT_INPUT                                                                                                  \
+  "..............................dddd....dddd....dddd....rrrr........rrrr........uuuu....uuuu....llll....LLLL....RRRR"
+#define FRAME_MS(frame) ((uint64_t)(frame) * 50 / 3)
+
+typedef struct ui_template {
+  const char *name;
+  void (*init)(void);
+  void (*setup)(void);
+  void (*drawOP)(void);
+  void (*drawTR)(void);
+  void (*handle_input)(unsigned int);
+} ui_template;
+
+#define UI_TEMPLATE(ui)                                                                                                \
+  (ui_template) {                                                                                                      \
+    .name = #ui, .init = FUNC_NAME(ui, init), .setup = FUNC_NAME(ui, setup), .drawOP = FUNC_NAME(ui, drawOP),          \
+    .drawTR = FUNC_NAME(ui, drawTR), .handle_input = FUNC_NAME(ui, handle_input),                                      \
+  }
+
+/* Same order as sf_ui and main.c */
+static ui_template ui_choices[] = {
+    UI_TEMPLATE(LIST_DESC),
+    UI_TEMPLATE(GRID_3),
+    UI_TEMPLATE(SCROLL),
+    UI_TEMPLATE(FOLDERS),
+};
+#define NUM_UI_CHOICES ((int)(sizeof(ui_choices) / sizeof(ui_choices[0])))
+
+typedef struct list_totals {
+  drawrec_list_stats sum, max;
+} list_totals;
+
+static int need_reload_ui = 0;
+static int verbose = 0;
+static unsigned int launches = 0;
+
+/* Whatever main.c and the loaders would do, a launch only gets counted */
+void reload_ui(void) { need_reload_ui = 1; }
+void exit_to_bios(void) { launches++; }
+void bloom_launch(const struct gd_item *disc) {
+  (void)disc;
+  launches++;
+}
+void bleem_launch(const struct gd_item *disc) {
+  (void)disc;
+  launches++;
+}
+void dreamcast_launch_disc(const struct gd_item *disc) {
+  (void)disc;
+  launches++;
+}
+void dreamcast_launch_cb(const struct gd_item *disc) {
+  (void)disc;
+  launches++;
+}
+
+/* No GDEMU to ask */
+int gdemu_get_version(void *buffer, uint32_t *size) {
+  (void)buffer;
+  (void)size;
+  return -1;
+}
+
+static int write_fake_list(const char *path, int games) {
+  static const char *regions[] = {"JUE", "U", "E", "J"};
+  FILE *ini = fopen(path, "w");
+  if (!ini) {
+    printf("ERR: cant write %s\n", path);
+    return 1;
+  }
+
+  fprintf(ini, "[OPENMENU]\nnum_items=%d\n\n[ITEMS]\n", games + 1);
+  fprintf(ini, "01.name=openMenu\n01.disc=1/1\n01.vga=1\n01.region=JUE\n01.version=V0.1.0\n01.date=20210608\n");
+  fprintf(ini, "01.product=NEODC_1\n\n");
+  for (int i = 2; i <= games + 1; i++) {
+    fprintf(ini, "%02d.name=Fake Game %03d\n%02d.disc=1/1\n%02d.vga=1\n", i, i - 1, i, i);
+    fprintf(ini, "%02d.region=%s\n%02d.version=V1.000\n%02d.date=1999%02d%02d\n", i, regions[i % 4], i, i,
+            1 + i % 12, 1 + i % 28);
+    fprintf(ini, "%02d.product=T%c%04dN\n\n", i, i & 1 ? '-' : '1', 1000 + i);
+  }
+  fclose(ini);
+  return 0;
+}
+
+static int menu_init(const char *list_path) {
+  int ret = 0;
+
+  savefile_init();
+
+  ret += txr_create_heap();
+  ret += txr_create_small_pool();
+  ret += txr_create_large_pool();
+  txr_load_DATs();
+  if (list_read(list_path)) {
+    printf("ERR: cant read %s\n", list_path);
+    return 1;
+  }
+  db_load_DAT();
+  ret += theme_manager_load();
+
+  list_folder_init();
+  list_set_sort_default();
+
+  draw_init();
+  return ret;
+}
+
+static void ui_set_choice(int choice) {
+  need_reload_ui = 0;
+
+  /* Same as main.c */
+  txr_empty_small_pool();
+  txr_empty_large_pool();
+  ui_choices[choice].init();
+  ui_choices[choice].setup();
+  texman_trim_cache();
+  txr_apply_working_set();
+}
+
+static unsigned int script_input(char c, inputs *in) {
+  memset(in, 0, sizeof(inputs));
+  in->axes_1 = 128;
+  in->axes_2 = 128;
+
+  switch (c) {
+    case 'u': in->dpad = DPAD_UP; return UP;
+    case 'd': in->dpad = DPAD_DOWN; return DOWN;
+    case 'l': in->dpad = DPAD_LEFT; return LEFT;
+    case 'r': in->dpad = DPAD_RIGHT; return RIGHT;
+    case 'a': in->btn_a = 1; return A;
+    case 'b': in->btn_b = 1; return B;
+    case 'x': in->btn_x = 1; return X;
+    case 'y': in->btn_y = 1; return Y;
+    case 's': in->btn_start = 1; return START;
+    case 'L': in->trg_left = 255; return TRIG_L;
+    case 'R': in->trg_right = 255; return TRIG_R;
+    default: return NONE;
+  }
+}
+
+/* main.c's draw() */
+static void draw_frame(int choice) {
+  pvr_wait_ready();
+  txr_stream_commit();
+
+  draw_begin_frame();
+  pvr_scene_begin();
+
+  draw_set_list(PVR_LIST_OP_POLY);
+  pvr_list_begin(PVR_LIST_OP_POLY);
+  ui_choices[choice].drawOP();
+  draw_flush();
+  pvr_list_finish();
+
+  draw_set_list(PVR_LIST_TR_POLY);
+  pvr_list_begin(PVR_LIST_TR_POLY);
+  ui_choices[choice].drawTR();
+  stats_overlay_draw_tr();
+  draw_flush();
+  pvr_list_finish();
+
+  pvr_scene_finish();
+}
+
+static void totals_add(list_totals *totals, const drawrec_list_stats *stats) {
+  totals->sum.headers += stats->headers;
+  totals->sum.vertices += stats->vertices;
+  totals->sum.binds += stats->binds;
+  totals->sum.bytes += stats->bytes;
+#define MAX_OF(field) totals->max.field = stats->field > totals->max.field ? stats->field : totals->max.field
+  MAX_OF(headers);
+  MAX_OF(vertices);
+  MAX_OF(binds);
+  MAX_OF(bytes);
+#undef MAX_OF
+}
+
+static void frame_print(unsigned int frame_num, const drawrec_frame_stats *frame) {
+  printf("frame %5u:", frame_num);
+  for (int i = 0; i < DRAWREC_LISTS; i++) {
+    const drawrec_list_stats *list = &frame->list[i];
+    if (list->bytes) {
+      printf(" %s hdr %u vtx %u bind %u %uB |", drawrec_list_name(i), list->headers, list->vertices, list->binds,
+             list->bytes);
+    }
+  }
+  printf(" upload %uB\n", frame->upload_bytes);
+}
+
+static void totals_print(const list_totals *totals, int frames) {
+  printf("  list   headers avg/max   vertices avg/max   binds avg/max   bytes avg/max\n");
+  for (int i = 0; i < DRAWREC_LISTS; i++) {
+    const list_totals *list = &totals[i];
+    if (!list->sum.bytes) {
+      continue;
+    }
+    printf("  %-6s %7.1f/%-7u %9.1f/%-7u %7.1f/%-5u %9.0f/%u\n", drawrec_list_name(i),
+           (double)list->sum.headers / frames, list->max.headers, (double)list->sum.vertices / frames,
+           list->max.vertices, (double)list->sum.binds / frames, list->max.binds, (double)list->sum.bytes / frames,
+           list->max.bytes);
+  }
+}
+
+static void run_ui(int choice, int frames, const char *script) {
+  list_totals totals[DRAWREC_LISTS];
+  unsigned int uploads = 0, quads = 0;
+  const size_t script_len = strlen(script);
+  text_cache_stats text_before, text;
+
+  memset(totals, 0, sizeof(totals));
+  sf_ui[0] = (uint8_t)choice;
+  ui_set_choice(choice);
+  text_cache_get_stats(&text_before);
+
+  for (int f = 0; f < frames; f++) {
+    inputs in;
+    drawrec_set_time(FRAME_MS(drawrec_frame_num()));
+
+    z_reset();
+    const unsigned int control = script_input(script_len ? script[f % script_len] : '.', &in);
+    INPT_ReceiveFromHost(in);
+    if (!stats_overlay_handle_input()) {
+      ui_choices[choice].handle_input(control);
+    }
+    if (need_reload_ui) {
+      ui_set_choice(choice);
+      continue;
+    }
+    draw_frame(choice);
+
+    const drawrec_frame_stats *frame = drawrec_last_frame();
+    draw_frame_stats draw_stats;
+    draw_get_frame_stats(&draw_stats);
+    quads += draw_stats.quads;
+    uploads += frame->upload_bytes;
+    for (int i = 0; i < DRAWREC_LISTS; i++) {
+      totals_add(&totals[i], &frame->list[i]);
+    }
+    if (verbose) {
+      frame_print(drawrec_frame_num() - 1, frame);
+    }
+  }
+
+  printf("%s: %d frames, %u quads recorded, %u KB uploaded\n", ui_choices[choice].name, frames, quads,
+         uploads / 1024);
+  text_cache_get_stats(&text);
+  printf("  text   %u runs %u KB, %u drawn from cache, %u laid out, %u evicted\n", text.runs, text.bytes / 1024,
+         text.hits - text_before.hits, text.layouts - text_before.layouts, text.evictions - text_before.evictions);
+  printf("  rows   %u measured from cache, %u broken\n", text.break_hits - text_before.break_hits,
+         text.breaks - text_before.breaks);
+  totals_print(totals, frames);
+}
+
+static int read_capture(const char *path) {
+  list_totals totals[DRAWREC_LISTS];
+  drawrec_frame_stats frame;
+  drawrec_file_hdr file;
+  unsigned int frame_num, uploads = 0;
+  int frames = 0, ret;
+
+  FILE *in = fopen(path, "rb");
+  if (!in) {
+    printf("ERR: cant read %s\n", path);
+    return 1;
+  }
+  if (fread(&file, sizeof(file), 1, in) != 1 || memcmp(file.magic, DRAWREC_MAGIC, sizeof(file.magic))
+      || file.version != DRAWREC_VERSION) {
+    printf("ERR: %s isn't a version %d capture\n", path, DRAWREC_VERSION);
+    fclose(in);
+    return 1;
+  }
+
+  memset(totals, 0, sizeof(totals));
+  while ((ret = drawrec_read_frame(in, &frame, &frame_num)) > 0) {
+    for (int i = 0; i < DRAWREC_LISTS; i++) {
+      totals_add(&totals[i], &frame.list[i]);
+    }
+    uploads += frame.upload_bytes;
+    frames++;
+    if (verbose) {
+      frame_print(frame_num, &frame);
+    }
+  }
+  fclose(in);
+  if (ret < 0) {
+    printf("ERR: %s broken after %d frames\n", path, frames);
+    return 1;
+  }
+
+  printf("%s: %d frames, %u KB uploaded\n", path, frames, uploads / 1024);
+  if (frames) {
+    totals_print(totals, frames);
+  }
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  int only_ui = -1, frames = DEFAULT_FRAMES, games = 0, opt;
+  const char *script = DEFAULT_INPUT;
+  const char *capture_path = NULL, *read_path = NULL;
+  char list_path[512] = "/cd/OPENMENU.INI";
+  FILE *capture = NULL;
+
+  while ((opt = getopt(argc, argv, "u:n:i:g:o:r:v")) != -1) {
+    switch (opt) {
+      case 'u': only_ui = atoi(optarg); break;
+      case 'n': frames = atoi(optarg); break;
+      case 'i': script = optarg; break;
+      case 'g': games = atoi(optarg); break;
+      case 'o': capture_path = optarg; break;
+      case 'r': read_path = optarg; break;
+      case 'v': verbose = 1; break;
+      default: optind = argc; break;
+    }
+  }
+  if (read_path) {
+    return read_capture(read_path);
+  }
+  if (optind != argc - 1 || only_ui >= NUM_UI_CHOICES || frames <= 0) {
+    printf("Usage: %s [-u ui] [-n frames] [-i input] [-g games] [-o capture.drl] [-v] DATA_FOLDER\n", argv[0]);
+    printf("       %s -r capture.drl [-v]\n", argv[0]);
+    return 1;
+  }
+  drawrec_set_root(argv[optind]);
+
+  if (games > 0) {
+    snprintf(list_path, sizeof(list_path), "%s/drawrec_%d.ini", P_tmpdir, (int)getpid());
+    if (write_fake_list(list_path, games)) {
+      return 1;
+    }
+  }
+  if (capture_path && !(capture = fopen(capture_path, "wb"))) {
+    printf("ERR: cant write %s\n", capture_path);
+    return 1;
+  }
+
+  const int failed = menu_init(list_path);
+  if (games > 0) {
+    remove(list_path);
+  }
+  if (failed) {
+    printf("ERR: menu init failed\n");
+    return 1;
+  }
+
+  drawrec_set_output(capture);
+  for (int i = 0; i < NUM_UI_CHOICES; i++) {
+    if (only_ui == -1 || only_ui == i) {
+      run_ui(i, frames, script);
+    }
+  }
+  drawrec_set_output(NULL);
+
+  if (launches) {
+    printf("%u launches skipped\n", launches);
+  }
+  if (capture) {
+    printf("%u frames written to %s (%ld KB)\n", drawrec_frame_num(), capture_path, ftell(capture) / 1024);
+    fclose(capture);
+  }
+  txr_stream_shutdown();
+  savefile_close();
+  return 0;
+}
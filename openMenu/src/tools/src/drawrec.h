@@ -0,0 +1,79 @@
+/*
+ * File: drawrec.h
+ * Project: tools
+ * File Created: Sunday, 18th October 2026 11:05:12 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* Recording pvr backend, see drawrec_pvr.c. Everything handed to pvr_prim
+ * between pvr_scene_begin and pvr_scene_finish is kept per list as the TA
+ * would see it, 32 byte parameters, and counted once the scene is done.
+
+   Capture file, little endian:
+     drawrec_file_hdr
+     per frame: drawrec_frame_hdr, then per list sent to: drawrec_list_hdr
+                and drawrec_runs up to its parameter count. A run keeps
+                parameters from the list's previous frame at the same
+                position, then the fresh ones follow it. Menus move little
+                from frame to frame so most of a list is kept. */
+
+#define DRAWREC_MAGIC "DRWR"
+#define DRAWREC_VERSION (1)
+#define DRAWREC_LISTS (5)
+#define DRAWREC_PARAM_SIZE (32)
+
+typedef struct drawrec_file_hdr {
+  char magic[4];
+  uint32_t version;
+} drawrec_file_hdr;
+
+typedef struct drawrec_frame_hdr {
+  uint32_t frame;
+  uint32_t lists;
+  uint32_t upload_bytes;
+} drawrec_frame_hdr;
+
+typedef struct drawrec_list_hdr {
+  uint32_t list;
+  uint32_t params;
+} drawrec_list_hdr;
+
+typedef struct drawrec_run {
+  uint32_t keep;
+  uint32_t fresh;
+} drawrec_run;
+
+typedef struct drawrec_list_stats {
+  unsigned int headers;
+  unsigned int vertices; /* vertex parameters, a sprite quad is one */
+  unsigned int binds;    /* headers pointing at another texture than the one before */
+  unsigned int bytes;
+} drawrec_list_stats;
+
+typedef struct drawrec_frame_stats {
+  drawrec_list_stats list[DRAWREC_LISTS];
+  unsigned int upload_bytes; /* pvr_txr_load since the previous scene */
+} drawrec_frame_stats;
+
+/* Frames are written to out from the next scene on, NULL stops */
+void drawrec_set_output(FILE *out);
+/* Reads the next frame of a capture and counts it like a recorded one.
+ * Returns 0 at the end, -1 if the capture is broken. */
+int drawrec_read_frame(FILE *in, drawrec_frame_stats *stats, unsigned int *frame);
+/* Of the last finished scene */
+const drawrec_frame_stats *drawrec_last_frame(void);
+unsigned int drawrec_frame_num(void);
+const char *drawrec_list_name(int list);
+
+/* Host stand-ins for fs and threads, see drawrec_kos.c. Paths under /cd/
+ * resolve inside root, matching names without case like the disc does. */
+void drawrec_set_root(const char *root);
+void drawrec_set_time(uint64_t ms);
@@ -0,0 +1,160 @@
+/*
+ * File: drawrec_kos.c
+ * Project: tools
+ * File Created: Sunday, 18th October 2026 11:05:12 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+#include <dirent.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include <arch/timer.h>
+#include <kos/fs.h>
+#include <kos/mutex.h>
+#include <kos/thread.h>
+
+#include "drawrec.h"
+
+#define MAX_FILES (16)
+#define CD_PREFIX "/cd/"
+
+struct kthread {
+  pthread_t thread;
+};
+
+static char data_root[512] = ".";
+static uint64_t now_ms = 0;
+
+/* The stream worker opens files too */
+static mutex_t files_lock = MUTEX_INITIALIZER;
+static FILE *files[MAX_FILES];
+
+void drawrec_set_root(const char *root) { snprintf(data_root, sizeof(data_root), "%s", root); }
+
+void drawrec_set_time(uint64_t ms) { now_ms = ms; }
+
+uint64_t timer_ms_gettime64(void) { return now_ms; }
+
+/* Walks path below data_root one name at a time, taking whatever matches
+ * without case. Names that match nothing are kept so opening them fails. */
+static void resolve(const char *path, char *out, size_t len) {
+  if (strncmp(path, CD_PREFIX, strlen(CD_PREFIX))) {
+    snprintf(out, len, "%s", path);
+    return;
+  }
+
+  snprintf(out, len, "%s", data_root);
+  path += strlen(CD_PREFIX);
+  while (*path) {
+    const size_t name_len = strcspn(path, "/");
+    const size_t used = strlen(out);
+    DIR *dir = opendir(out);
+    struct dirent *entry = NULL;
+
+    while (dir && (entry = readdir(dir))) {
+      if (strlen(entry->d_name) == name_len && !strncasecmp(entry->d_name, path, name_len)) {
+        break;
+      }
+    }
+    if (entry) {
+      snprintf(out + used, len - used, "/%s", entry->d_name);
+    } else {
+      snprintf(out + used, len - used, "/%.*s", (int)name_len, path);
+    }
+    if (dir) {
+      closedir(dir);
+    }
+
+    path += name_len;
+    path += *path == '/';
+  }
+}
+
+file_t fs_open(const char *path, int mode) {
+  char host_path[1024];
+  file_t fd = -1;
+  (void)mode;
+
+  resolve(path, host_path, sizeof(host_path));
+  FILE *file = fopen(host_path, "rb");
+  if (!file) {
+    return -1;
+  }
+
+  mutex_lock(&files_lock);
+  for (int i = 0; i < MAX_FILES; i++) {
+    if (!files[i]) {
+      files[i] = file;
+      fd = i;
+      break;
+    }
+  }
+  mutex_unlock(&files_lock);
+
+  if (fd == -1) {
+    printf("ERR: out of files for %s\n", path);
+    fclose(file);
+  }
+  return fd;
+}
+
+int fs_close(file_t fd) {
+  mutex_lock(&files_lock);
+  fclose(files[fd]);
+  files[fd] = NULL;
+  mutex_unlock(&files_lock);
+  return 0;
+}
+
+ssize_t fs_read(file_t fd, void *buf, size_t len) { return (ssize_t)fread(buf, 1, len, files[fd]); }
+
+off_t fs_seek(file_t fd, off_t pos, int whence) {
+  fseek(files[fd], pos, whence);
+  return ftell(files[fd]);
+}
+
+off_t fs_tell(file_t fd) { return ftell(files[fd]); }
+
+size_t fs_total(file_t fd) {
+  const long pos = ftell(files[fd]);
+  fseek(files[fd], 0, SEEK_END);
+  const long total = ftell(files[fd]);
+  fseek(files[fd], pos, SEEK_SET);
+  return (size_t)total;
+}
+
+int fs_stat(const char *path, struct stat *buf, int flag) {
+  char host_path[1024];
+  (void)flag;
+
+  resolve(path, host_path, sizeof(host_path));
+  return stat(host_path, buf);
+}
+
+kthread_t *thd_create(int detach, void *(*routine)(void *param), void *param) {
+  kthread_t *thd = malloc(sizeof(kthread_t));
+  if (!thd) {
+    printf("%s no free memory\n", __func__);
+    return NULL;
+  }
+  if (pthread_create(&thd->thread, NULL, routine, param)) {
+    free(thd);
+    return NULL;
+  }
+  if (detach) {
+    pthread_detach(thd->thread);
+  }
+  return thd;
+}
+
+int thd_join(kthread_t *thd, void **value_out) {
+  const int ret = pthread_join(thd->thread, value_out);
+  free(thd);
+  return ret;
+}
@@ -0,0 +1,380 @@
+/*
+ * File: drawrec_pvr.c
+ * Project: tools
+ * File Created: Sunday, 18th October 2026 11:05:12 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <dc/pvr.h>
+
+#include "drawrec.h"
+
+/* Stand-in vram, pvr_mem_malloc hands it out in order. Texture addresses in
+ * headers are offsets into it like on hardware. */
+#define VRAM_SIZE (8 * 1024 * 1024)
+
+#define PARAM_SIZE DRAWREC_PARAM_SIZE
+#define PARAM_TYPE(cmd) ((cmd) >> 29)
+#define PARAM_POLYHDR (4)
+#define PARAM_SPRITEHDR (5)
+#define PARAM_VERTEX (7)
+#define MODE3_ADDRESS(mode3) ((mode3) & 0x1FFFFF)
+
+static _Alignas(32) unsigned char vram[VRAM_SIZE];
+static size_t vram_top = 0;
+
+typedef struct recorded_list {
+  unsigned char *data;
+  size_t len, size;
+} recorded_list;
+
+static recorded_list lists[DRAWREC_LISTS];
+/* What the capture has last seen of each list, writing or reading */
+static recorded_list written[DRAWREC_LISTS];
+static recorded_list reading;
+static int current_list = -1;
+static int in_scene = 0;
+static unsigned int frame_num = 0;
+static unsigned int upload_bytes = 0;
+static drawrec_frame_stats last_frame;
+static FILE *capture = NULL;
+
+static const char *list_names[DRAWREC_LISTS] = {"OP", "OP_MOD", "TR", "TR_MOD", "PT"};
+
+static uint32_t txr_address(pvr_ptr_t base) {
+  const unsigned char *ptr = base;
+  if (ptr >= vram && ptr < vram + VRAM_SIZE) {
+    return MODE3_ADDRESS((uint32_t)((ptr - vram) >> 3));
+  }
+  return MODE3_ADDRESS((uint32_t)((uintptr_t)ptr >> 3));
+}
+
+static uint32_t txr_size_bits(int size) {
+  uint32_t bits = 0;
+  while ((8 << bits) < size && bits < 7) {
+    bits++;
+  }
+  return bits;
+}
+
+static void cxt_defaults(pvr_poly_cxt_t *cxt, pvr_list_t list) {
+  memset(cxt, 0, sizeof(pvr_poly_cxt_t));
+  cxt->list_type = (int)list;
+  cxt->gen.alpha = list != PVR_LIST_OP_POLY;
+  cxt->blend.src = list == PVR_LIST_OP_POLY ? 1 : 4;
+  cxt->blend.dst = list == PVR_LIST_OP_POLY ? 0 : 5;
+  cxt->depth.comparison = 6;
+  cxt->depth.write = 1;
+}
+
+void pvr_poly_cxt_txr(pvr_poly_cxt_t *cxt, pvr_list_t list, int textureformat, int tw, int th, pvr_ptr_t textureaddr,
+                      int filtering) {
+  cxt_defaults(cxt, list);
+  cxt->txr.enable = PVR_TEXTURE_ENABLE;
+  cxt->txr.filter = filtering;
+  cxt->txr.alpha = list != PVR_LIST_OP_POLY;
+  cxt->txr.width = tw;
+  cxt->txr.height = th;
+  cxt->txr.format = textureformat;
+  cxt->txr.base = textureaddr;
+}
+
+void pvr_poly_cxt_col(pvr_poly_cxt_t *cxt, pvr_list_t list) {
+  cxt_defaults(cxt, list);
+  cxt->txr.enable = PVR_TEXTURE_DISABLE;
+}
+
+void pvr_sprite_cxt_txr(pvr_sprite_cxt_t *cxt, pvr_list_t list, int textureformat, int tw, int th,
+                        pvr_ptr_t textureaddr, int filtering) {
+  pvr_poly_cxt_txr(cxt, list, textureformat, tw, th, textureaddr, filtering);
+}
+
+void pvr_sprite_cxt_col(pvr_sprite_cxt_t *cxt, pvr_list_t list) { pvr_poly_cxt_col(cxt, list); }
+
+/* Same words as KOS for list, texture enable and texture address, the rest
+ * only needs to change when the state does */
+static void compile_modes(uint32_t *mode, const pvr_poly_cxt_t *cxt) {
+  mode[0] = ((uint32_t)cxt->depth.comparison << 29) | ((uint32_t)cxt->gen.culling << 27)
+            | ((uint32_t)!cxt->depth.write << 26);
+  mode[1] = ((uint32_t)cxt->blend.src << 29) | ((uint32_t)cxt->blend.dst << 26) | ((uint32_t)cxt->gen.alpha << 20)
+            | ((uint32_t)!cxt->txr.alpha << 19) | ((uint32_t)cxt->txr.filter << 13);
+  mode[2] = 0;
+  if (cxt->txr.enable) {
+    mode[1] |= (txr_size_bits(cxt->txr.width) << 3) | txr_size_bits(cxt->txr.height);
+    mode[2] = (uint32_t)cxt->txr.format | txr_address(cxt->txr.base);
+  }
+}
+
+void pvr_poly_compile(pvr_poly_hdr_t *hdr, const pvr_poly_cxt_t *cxt) {
+  memset(hdr, 0, sizeof(pvr_poly_hdr_t));
+  hdr->cmd = PVR_CMD_POLYHDR | ((uint32_t)cxt->list_type << PVR_TA_CMD_TYPE_SHIFT)
+             | ((uint32_t)cxt->txr.enable << PVR_TA_CMD_TXRENABLE_SHIFT);
+  compile_modes(&hdr->mode1, cxt);
+}
+
+void pvr_sprite_compile(pvr_sprite_hdr_t *hdr, const pvr_sprite_cxt_t *cxt) {
+  memset(hdr, 0, sizeof(pvr_sprite_hdr_t));
+  hdr->cmd = PVR_CMD_SPRITE | ((uint32_t)cxt->list_type << PVR_TA_CMD_TYPE_SHIFT)
+             | ((uint32_t)cxt->txr.enable << PVR_TA_CMD_TXRENABLE_SHIFT);
+  compile_modes(&hdr->mode1, cxt);
+  hdr->argb = 0xFFFFFFFF;
+}
+
+int pvr_wait_ready(void) { return 0; }
+
+int pvr_scene_begin(void) {
+  if (in_scene) {
+    printf("WARN: frame %u scene begun twice\n", frame_num);
+  }
+  for (int i = 0; i < DRAWREC_LISTS; i++) {
+    lists[i].len = 0;
+  }
+  in_scene = 1;
+  return 0;
+}
+
+int pvr_list_begin(pvr_list_t list) {
+  if (!in_scene || list >= DRAWREC_LISTS) {
+    printf("WARN: frame %u list %u begun outside a scene\n", frame_num, (unsigned int)list);
+    return -1;
+  }
+  current_list = (int)list;
+  return 0;
+}
+
+int pvr_list_finish(void) {
+  current_list = -1;
+  return 0;
+}
+
+/* Room for size more bytes at rec->data + rec->len */
+static void list_reserve(recorded_list *rec, size_t size) {
+  if (rec->len + size > rec->size) {
+    size_t grow = rec->size ? rec->size * 2 : 64 * 1024;
+    while (grow < rec->len + size) {
+      grow *= 2;
+    }
+    unsigned char *data_new = realloc(rec->data, grow);
+    if (!data_new) {
+      printf("%s no free memory\n", __func__);
+      exit(1);
+    }
+    rec->data = data_new;
+    rec->size = grow;
+  }
+}
+
+static void list_append(recorded_list *rec, const void *data, size_t size) {
+  if (!size) {
+    return;
+  }
+  list_reserve(rec, size);
+  memcpy(rec->data + rec->len, data, size);
+  rec->len += size;
+}
+
+int pvr_prim(const void *data, size_t size) {
+  if (current_list < 0) {
+    printf("WARN: frame %u %u bytes sent outside a list\n", frame_num, (unsigned int)size);
+    return -1;
+  }
+  if (size % PARAM_SIZE) {
+    printf("WARN: frame %u %u bytes isn't whole parameters\n", frame_num, (unsigned int)size);
+  }
+
+  list_append(&lists[current_list], data, size);
+  return 0;
+}
+
+static void list_count(const recorded_list *rec, drawrec_list_stats *stats) {
+  uint32_t bound = 0;
+  int textured = 0, sprite = 0;
+  size_t pos = 0;
+
+  memset(stats, 0, sizeof(drawrec_list_stats));
+  while (pos + PARAM_SIZE <= rec->len) {
+    uint32_t words[4];
+    memcpy(words, rec->data + pos, sizeof(words));
+    pos += PARAM_SIZE;
+
+    switch (PARAM_TYPE(words[0])) {
+      case PARAM_POLYHDR:
+      case PARAM_SPRITEHDR:
+        stats->headers++;
+        sprite = PARAM_TYPE(words[0]) == PARAM_SPRITEHDR;
+        if (words[0] & (1 << PVR_TA_CMD_TXRENABLE_SHIFT)) {
+          if (!textured || MODE3_ADDRESS(words[3]) != bound) {
+            stats->binds++;
+          }
+          bound = MODE3_ADDRESS(words[3]);
+          textured = 1;
+        }
+        break;
+      case PARAM_VERTEX:
+        stats->vertices++;
+        /* Second half of a sprite quad */
+        pos += sprite ? PARAM_SIZE : 0;
+        break;
+      default:
+        break;
+    }
+  }
+  stats->bytes = (unsigned int)rec->len;
+}
+
+static int param_kept(const recorded_list *rec, const recorded_list *prev, uint32_t param) {
+  const size_t pos = (size_t)param * PARAM_SIZE;
+  return pos + PARAM_SIZE <= prev->len && !memcmp(rec->data + pos, prev->data + pos, PARAM_SIZE);
+}
+
+static void list_write(int list_num) {
+  const recorded_list *rec = &lists[list_num];
+  recorded_list *prev = &written[list_num];
+  const drawrec_list_hdr list = {.list = (uint32_t)list_num, .params = (uint32_t)(rec->len / PARAM_SIZE)};
+  uint32_t param = 0;
+
+  fwrite(&list, sizeof(list), 1, capture);
+  while (param < list.params) {
+    drawrec_run run = {0, 0};
+    while (param + run.keep < list.params && param_kept(rec, prev, param + run.keep)) {
+      run.keep++;
+    }
+    param += run.keep;
+    while (param + run.fresh < list.params && !param_kept(rec, prev, param + run.fresh)) {
+      run.fresh++;
+    }
+    fwrite(&run, sizeof(run), 1, capture);
+    fwrite(rec->data + (size_t)param * PARAM_SIZE, PARAM_SIZE, run.fresh, capture);
+    param += run.fresh;
+  }
+
+  prev->len = 0;
+  list_append(prev, rec->data, (size_t)list.params * PARAM_SIZE);
+}
+
+static void frame_write(void) {
+  drawrec_frame_hdr frame = {.frame = frame_num, .lists = 0, .upload_bytes = upload_bytes};
+
+  for (int i = 0; i < DRAWREC_LISTS; i++) {
+    frame.lists += lists[i].len ? 1 : 0;
+  }
+  fwrite(&frame, sizeof(frame), 1, capture);
+  for (int i = 0; i < DRAWREC_LISTS; i++) {
+    if (lists[i].len) {
+      list_write(i);
+    }
+  }
+}
+
+static int list_read(FILE *in, drawrec_list_stats *stats) {
+  drawrec_list_hdr list;
+  uint32_t param = 0;
+
+  if (fread(&list, sizeof(list), 1, in) != 1 || list.list >= DRAWREC_LISTS) {
+    return -1;
+  }
+  recorded_list *prev = &written[list.list];
+  reading.len = 0;
+  list_reserve(&reading, (size_t)list.params * PARAM_SIZE);
+  while (param < list.params) {
+    drawrec_run run;
+    if (fread(&run, sizeof(run), 1, in) != 1 || run.keep > list.params - param
+        || run.fresh > list.params - param - run.keep || (size_t)(param + run.keep) * PARAM_SIZE > prev->len) {
+      return -1;
+    }
+    list_append(&reading, prev->data + (size_t)param * PARAM_SIZE, (size_t)run.keep * PARAM_SIZE);
+    if (fread(reading.data + reading.len, PARAM_SIZE, run.fresh, in) != run.fresh) {
+      return -1;
+    }
+    reading.len += (size_t)run.fresh * PARAM_SIZE;
+    param += run.keep + run.fresh;
+  }
+
+  /* Becomes what the next frame keeps from */
+  const recorded_list swap = *prev;
+  *prev = reading;
+  reading = swap;
+  list_count(prev, &stats[list.list]);
+  return 0;
+}
+
+int drawrec_read_frame(FILE *in, drawrec_frame_stats *stats, unsigned int *frame) {
+  drawrec_frame_hdr frame_hdr;
+
+  if (fread(&frame_hdr, sizeof(frame_hdr), 1, in) != 1) {
+    return 0;
+  }
+  memset(stats, 0, sizeof(drawrec_frame_stats));
+  for (uint32_t i = 0; i < frame_hdr.lists; i++) {
+    if (list_read(in, stats->list)) {
+      return -1;
+    }
+  }
+  stats->upload_bytes = frame_hdr.upload_bytes;
+  *frame = frame_hdr.frame;
+  return 1;
+}
+
+int pvr_scene_finish(void) {
+  if (current_list >= 0) {
+    printf("WARN: frame %u list %s never finished\n", frame_num, list_names[current_list]);
+    current_list = -1;
+  }
+  for (int i = 0; i < DRAWREC_LISTS; i++) {
+    list_count(&lists[i], &last_frame.list[i]);
+  }
+  last_frame.upload_bytes = upload_bytes;
+  if (capture) {
+    frame_write();
+  }
+
+  upload_bytes = 0;
+  in_scene = 0;
+  frame_num++;
+  return 0;
+}
+
+void pvr_set_pal_format(int fmt) { (void)fmt; }
+
+void pvr_set_pal_entry(uint32_t idx, uint32_t value) {
+  (void)idx;
+  (void)value;
+}
+
+pvr_ptr_t pvr_mem_malloc(size_t size) {
+  void *ptr = vram + vram_top;
+  if (vram_top + size > VRAM_SIZE) {
+    printf("ERR: out of vram\n");
+    return NULL;
+  }
+  vram_top += (size + 31) & ~(size_t)31;
+  return ptr;
+}
+
+void pvr_mem_free(pvr_ptr_t ptr) { (void)ptr; }
+
+void pvr_txr_load(const void *src, pvr_ptr_t dst, uint32_t count) {
+  memcpy(dst, src, count);
+  upload_bytes += count;
+}
+
+void drawrec_set_output(FILE *out) {
+  capture = out;
+  if (capture) {
+    drawrec_file_hdr file = {.version = DRAWREC_VERSION};
+    memcpy(file.magic, DRAWREC_MAGIC, sizeof(file.magic));
+    fwrite(&file, sizeof(file), 1, capture);
+  }
+}
+
+const drawrec_frame_stats *drawrec_last_frame(void) { return &last_frame; }
+
+unsigned int drawrec_frame_num(void) { return frame_num; }
+
+const char *drawrec_list_name(int list) { return list >= 0 && list < DRAWREC_LISTS ? list_names[list] : "?"; }
@@ -0,0 +1,180 @@
+/*
+ * File: fontbench.c
+ * Project: tools
+ * File Created: Monday, 19th October 2026 12:41:08 am
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <dc/pvr.h>
+
+#include "ui/dc/text_cache.h"
+#include "ui/draw_prototypes.h"
+#include "ui/font_prototypes.h"
+
+#include "drawrec.h"
+
+/* Called:
+./fontbench [num_pages] DATA_FOLDER
+
+times laying out a page of synopsis text with the menu's BMF font, built as
+for the Dreamcast against the same stand-ins as drawrec
+*/
+
+#define DEFAULT_PAGES (20000)
+#define FONT_FNT "FONT/BASILEA.FNT"
+#define FONT_PVR "FONT/BASILEA_W.PVR"
+
+/* Where LIST_DESC puts the synopsis, at the size it uses */
+#define PAGE_X (316)
+#define PAGE_Y (108)
+#define PAGE_WIDTH (640 - 316 - 10)
+#define PAGE_HEIGHT (12.0f)
+
+/* As long as a description gets, with the pairs the font kerns */
+static const char *synopsis =
+    "Take to the skies in a fast paced aerial race across seven floating islands. Pilot your glider "
+    "through Avalon Valley, over the Yawning Wastes and into the Tower of Wyverns, racing rival teams "
+    "who will try anything to take the lead. Tune every craft in the Workshop, unlock new tracks by "
+    "winning the Vertex Cup and challenge a friend at Victory Way. Features 4 player split screen.";
+
+static const char *titles[] = {
+    "Avalon Voyage",      "Wave Racer AT",         "Tony's Yard Sale",       "Very Fast Wyverns",
+    "Vertex Cup Rally",   "Yawning Wastes 2",      "Tower of Wyverns",       "AWAY Team: Lost Valley",
+    "Victory Way",        "Typing of the Wyverns",
+};
+#define NUM_TITLES (sizeof(titles) / sizeof(titles[0]))
+
+/* What font_bmf needs from draw_kos.c and the texture manager */
+static float z_depth = 1.0f;
+float z_get(void) { return z_depth; }
+float z_inc(void) { return ++z_depth; }
+int draw_get_list(void) { return PVR_LIST_TR_POLY; }
+void draw_flush(void) {}
+texman_handle texman_load(const char *filename, image *img) {
+  (void)filename;
+  memset(img, 0, sizeof(*img));
+  img->width = img->height = 512;
+  img->format = PVR_TXRFMT_ARGB4444;
+  img->texture = pvr_mem_malloc(512 * 512 * 2);
+  return 1;
+}
+texman_handle texman_load_buffer(const char *key, const void *pvr, image *img) {
+  (void)pvr;
+  return texman_load(key, img);
+}
+texman_handle texman_load_resident(const char *key, image *img) {
+  (void)key;
+  (void)img;
+  return 0;
+}
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static void report(const char *name, uint64_t ns, int pages, int glyphs) {
+  printf("  %-34s %8.2f us/page %6.2f ns/glyph\n", name, ns / 1e3 / pages, (double)ns / pages / glyphs);
+}
+
+static int count_glyphs(const char *str) {
+  int glyphs = 0;
+  for (; *str; str++) {
+    glyphs += *str != ' ';
+  }
+  return glyphs;
+}
+
+static void page_begin(void) {
+  pvr_scene_begin();
+  pvr_list_begin(PVR_LIST_TR_POLY);
+  font_bmf_begin_draw();
+  z_depth = 1.0f;
+}
+
+static void page_end(void) {
+  pvr_list_finish();
+  pvr_scene_finish();
+}
+
+static void draw_synopsis(void) {
+  font_bmf_set_height(PAGE_HEIGHT);
+  font_bmf_draw_sub_wrap(PAGE_X, PAGE_Y, 0xFFFFFFFF, synopsis, PAGE_WIDTH);
+}
+
+static void draw_titles(void) {
+  for (unsigned int i = 0; i < NUM_TITLES; i++) {
+    font_bmf_draw_main(20, 40 + i * 24, 0xFFFFFFFF, titles[i]);
+  }
+}
+
+static void draw_centered(void) {
+  font_bmf_set_height(14.0f);
+  for (unsigned int i = 0; i < NUM_TITLES; i++) {
+    font_bmf_draw_centered(320, 40 + i * 24, 0xFFFFFFFF, titles[i]);
+  }
+}
+
+/* fresh clears the text cache first so every page is laid out again */
+static uint64_t time_pages(void (*draw)(void), int pages, int fresh) {
+  uint64_t total = 0;
+  for (int i = 0; i < pages; i++) {
+    if (fresh) {
+      text_cache_clear(TEXT_FONT_BMF);
+    }
+    page_begin();
+    const uint64_t start = now_ns();
+    draw();
+    total += now_ns() - start;
+    page_end();
+  }
+  return total;
+}
+
+int main(int argc, char **argv) {
+  int pages = DEFAULT_PAGES;
+
+  if (argc == 3) {
+    pages = atoi(argv[1]);
+  }
+  if ((argc != 2 && argc != 3) || pages <= 0) {
+    printf("Usage: %s [num_pages] DATA_FOLDER\n", argv[0]);
+    return 1;
+  }
+  drawrec_set_root(argv[argc - 1]);
+  if (font_bmf_init(FONT_FNT, FONT_PVR, 0)) {
+    printf("ERR: cant load %s\n", FONT_FNT);
+    return 1;
+  }
+
+  int title_glyphs = 0;
+  for (unsigned int i = 0; i < NUM_TITLES; i++) {
+    title_glyphs += count_glyphs(titles[i]);
+  }
+  const int synopsis_glyphs = count_glyphs(synopsis);
+
+  printf("fontbench: %d pages, synopsis %d glyphs, %d titles %d glyphs\n", pages, synopsis_glyphs,
+         (int)NUM_TITLES, title_glyphs);
+
+  printf("Laid out:\n");
+  report("synopsis, wrapped", time_pages(draw_synopsis, pages, 1), pages, synopsis_glyphs);
+  report("titles", time_pages(draw_titles, pages, 1), pages, title_glyphs);
+  report("titles, centered", time_pages(draw_centered, pages, 1), pages, title_glyphs);
+
+  printf("From the text cache:\n");
+  report("synopsis, wrapped", time_pages(draw_synopsis, pages, 0), pages, synopsis_glyphs);
+  report("titles", time_pages(draw_titles, pages, 0), pages, title_glyphs);
+  report("titles, centered", time_pages(draw_centered, pages, 0), pages, title_glyphs);
+
+  const drawrec_list_stats *tr = &drawrec_last_frame()->list[PVR_LIST_TR_POLY];
+  printf("last page: %u headers %u vertices\n", tr->headers, tr->vertices);
+  return 0;
+}
@@ -0,0 +1,331 @@
+/*
+ * File: fontpack.c
+ * Project: tools
+ * File Created: Monday, 19th October 2026 2:14:51 am
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <texture/font_pack.h>
+
+/* Called:
+./fontpack FONT.FNT TEXTURE.PVR OUTPUT.FPK
+
+compiles a binary BMFont and its page textures into one font pack, see
+font_pack.h. Page 0 is TEXTURE.PVR, further pages are named after it with
+their number ahead of the extension like the menu looks for them:
+BASILEA_W.PVR, BASILEA_W_1.PVR.. Name the output after the first texture,
+BASILEA_W.FPK, and put it next to it. Chars are kept the way font_bmf lays
+them out, kerning is compiled into its rows and wide pair list. Square 16bit textures stored as
+rectangles are twiddled, everything else goes in as it is.
+*/
+
+#define NUM_ARGS (3)
+#define BMF_CHAR_SIZE (20)
+#define BMF_PAIR_SIZE (10)
+
+/* PVRT layouts */
+#define PVR_TWIDDLED (0x01)
+#define PVR_RECTANGLE (0x09)
+
+enum { BLOCK_INFO = 1, BLOCK_COMMON, BLOCK_PAGES, BLOCK_CHARS, BLOCK_KERNING };
+
+static font_pack_header header;
+static font_pack_char chars[256];
+static font_pack_kern_row kern_rows[256];
+static font_pack_char *wide_chars;
+static font_pack_kern_pair *wide_pairs;
+static unsigned char *pages[FONT_PACK_MAX_PAGES];
+
+static uint16_t get_u16(const unsigned char *src) { return src[0] | src[1] << 8; }
+
+static uint32_t get_u32(const unsigned char *src) { return get_u16(src) | (uint32_t)get_u16(src + 2) << 16; }
+
+static void put_u32(unsigned char *dst, uint32_t v) {
+  dst[0] = v & 0xFF;
+  dst[1] = (v >> 8) & 0xFF;
+  dst[2] = (v >> 16) & 0xFF;
+  dst[3] = v >> 24;
+}
+
+static unsigned char *read_file(const char *path, size_t *size) {
+  FILE *fd = fopen(path, "rb");
+  if (!fd) {
+    printf("ERR: cant read %s\n", path);
+    return NULL;
+  }
+  fseek(fd, 0, SEEK_END);
+  *size = (size_t)ftell(fd);
+  fseek(fd, 0, SEEK_SET);
+  unsigned char *data = malloc(*size ? *size : 1);
+  if (!data || fread(data, *size, 1, fd) != 1) {
+    printf("ERR: cant read %s\n", path);
+    free(data);
+    data = NULL;
+  }
+  fclose(fd);
+  return data;
+}
+
+static uint32_t twiddle(uint32_t x, uint32_t y) {
+  uint32_t out = 0;
+  for (int bit = 0; bit < 16; bit++) {
+    out |= ((y >> bit) & 1) << (bit * 2);
+    out |= ((x >> bit) & 1) << (bit * 2 + 1);
+  }
+  return out;
+}
+
+static int cmp_char(const void *a, const void *b) {
+  const font_pack_char *ca = (const font_pack_char *)a;
+  const font_pack_char *cb = (const font_pack_char *)b;
+  return (ca->id > cb->id) - (ca->id < cb->id);
+}
+
+static int cmp_pair(const void *a, const void *b) {
+  const font_pack_kern_pair *pa = (const font_pack_kern_pair *)a;
+  const font_pack_kern_pair *pb = (const font_pack_kern_pair *)b;
+  if (pa->first != pb->first)
+    return (pa->first > pb->first) - (pa->first < pb->first);
+  return (pa->second > pb->second) - (pa->second < pb->second);
+}
+
+static void parse_chars(const unsigned char *block, uint32_t size) {
+  const uint32_t num = size / BMF_CHAR_SIZE;
+
+  header.num_chars = num;
+  wide_chars = calloc(num ? num : 1, sizeof(font_pack_char));
+  for (uint32_t i = 0; i < num; i++, block += BMF_CHAR_SIZE) {
+    font_pack_char chr = {
+        .id = get_u32(block),
+        .x = get_u16(block + 4),
+        .y = get_u16(block + 6),
+        .width = get_u16(block + 8),
+        .height = get_u16(block + 10),
+        .xoffset = (int16_t)get_u16(block + 12),
+        .yoffset = (int16_t)get_u16(block + 14),
+        .xadvance = (int16_t)get_u16(block + 16),
+        .page = block[18],
+        .chnl = block[19],
+    };
+    if (chr.page >= FONT_PACK_MAX_PAGES) {
+      printf("Skipping char %u on page %d\n", (unsigned int)chr.id, chr.page);
+    } else if (chr.id >= 256) {
+      wide_chars[header.num_wide_chars++] = chr;
+    } else {
+      chars[chr.id] = chr;
+    }
+  }
+  qsort(wide_chars, header.num_wide_chars, sizeof(font_pack_char), cmp_char);
+}
+
+/* Same rows font_bmf builds from the .FNT, numbered in the order pairs come.
+   Pairs with a char past 255 go on the wide list. */
+static void parse_kerning(const unsigned char *block, uint32_t size) {
+  const uint32_t num = size / BMF_PAIR_SIZE;
+
+  wide_pairs = calloc(num ? num : 1, sizeof(font_pack_kern_pair));
+  for (uint32_t i = 0; i < num; i++, block += BMF_PAIR_SIZE) {
+    const uint32_t first = get_u32(block);
+    const uint32_t second = get_u32(block + 4);
+    int amount = (int16_t)get_u16(block + 8);
+    if (first >= 256 || second >= 256) {
+      wide_pairs[header.num_wide_pairs++] = (font_pack_kern_pair){first, second, amount};
+      continue;
+    }
+    if (!chars[first].kern_row)
+      chars[first].kern_row = (uint16_t)++header.num_kern_rows;
+    amount = amount < INT8_MIN ? INT8_MIN : amount > INT8_MAX ? INT8_MAX : amount;
+    kern_rows[chars[first].kern_row - 1][second] = (int8_t)amount;
+  }
+  qsort(wide_pairs, header.num_wide_pairs, sizeof(font_pack_kern_pair), cmp_pair);
+}
+
+static int parse_fnt(const unsigned char *fnt, size_t size) {
+  if (size < 4 || memcmp(fnt, "BMF", 3) || fnt[3] != 3) {
+    printf("ERR: not a binary version 3 BMFont\n");
+    return 1;
+  }
+
+  size_t pos = 4;
+  while (pos + 5 <= size) {
+    const int type = fnt[pos];
+    const uint32_t len = get_u32(fnt + pos + 1);
+    const unsigned char *block = fnt + pos + 5;
+    pos += 5;
+    if (len > size - pos) {
+      printf("ERR: block %d runs past the end\n", type);
+      return 1;
+    }
+    pos += len;
+
+    switch (type) {
+      case BLOCK_INFO:
+        if (len >= 2)
+          header.fontSize = (uint32_t)(int16_t)-(int16_t)get_u16(block);
+        break;
+      case BLOCK_COMMON:
+        if (len >= 8) {
+          header.lineHeight = get_u16(block);
+          header.width = get_u16(block + 4);
+          header.height = get_u16(block + 6);
+        }
+        break;
+      case BLOCK_PAGES:
+        for (uint32_t i = 0; i < len; i++)
+          header.num_pages += block[i] == '\0';
+        break;
+      case BLOCK_CHARS:
+        parse_chars(block, len);
+        break;
+      case BLOCK_KERNING:
+        parse_kerning(block, len);
+        break;
+      default:
+        printf("Skipping unknown block type %d\n", type);
+    }
+  }
+
+  if (header.num_pages > FONT_PACK_MAX_PAGES) {
+    printf("ERR: %d pages, only %d supported\n", (int)header.num_pages, FONT_PACK_MAX_PAGES);
+    return 1;
+  }
+  if (!header.num_pages)
+    header.num_pages = 1;
+  return 0;
+}
+
+/* Square power of two 16bit rectangles are twiddled in place */
+static void twiddle_texture(unsigned char *pvrt, size_t size) {
+  const uint32_t width = get_u16(pvrt + 12);
+  const uint32_t height = get_u16(pvrt + 14);
+  const int color = pvrt[8];
+  const size_t bytes = (size_t)width * height * 2;
+
+  if (pvrt[9] != PVR_RECTANGLE || color > 0x04 || width != height || (width & (width - 1)) || size < 16 + bytes)
+    return;
+
+  uint16_t *texels = (uint16_t *)(pvrt + 16);
+  uint16_t *twiddled = malloc(bytes);
+  if (!twiddled)
+    return;
+  for (uint32_t y = 0; y < height; y++)
+    for (uint32_t x = 0; x < width; x++)
+      twiddled[twiddle(x, y)] = texels[y * width + x];
+  memcpy(texels, twiddled, bytes);
+  free(twiddled);
+  pvrt[9] = PVR_TWIDDLED;
+}
+
+/* Always with a 16 byte GBIX header ahead of PVRT, which the menu expects */
+static unsigned char *read_page(const char *path, uint32_t *out_size) {
+  size_t size;
+  unsigned char *file = read_file(path, &size);
+  if (!file)
+    return NULL;
+
+  size_t pvrt = 0;
+  if (size >= 8 && !memcmp(file, "GBIX", 4))
+    pvrt = 8 + get_u32(file + 4);
+  if (pvrt > size || size - pvrt < 16 || memcmp(file + pvrt, "PVRT", 4)) {
+    printf("ERR: %s isn't a PVR\n", path);
+    free(file);
+    return NULL;
+  }
+
+  unsigned char *page = calloc(1, 16 + size - pvrt);
+  if (!page) {
+    free(file);
+    return NULL;
+  }
+  memcpy(page, "GBIX", 4);
+  put_u32(page + 4, 8);
+  if (pvrt == 16)
+    memcpy(page + 8, file + 8, 8);
+  memcpy(page + 16, file + pvrt, size - pvrt);
+  free(file);
+
+  twiddle_texture(page + 16, size - pvrt);
+  *out_size = (uint32_t)(16 + size - pvrt);
+  return page;
+}
+
+/* BASILEA_W.PVR, BASILEA_W_1.PVR.. */
+static void page_path(char *out, size_t len, const char *texture, int page) {
+  const char *ext = strrchr(texture, '.');
+  const char *sep = strrchr(texture, '/');
+  if (ext && sep && ext < sep)
+    ext = NULL;
+  const int name_len = ext ? (int)(ext - texture) : (int)strlen(texture);
+  if (page)
+    snprintf(out, len, "%.*s_%d%s", name_len, texture, page, ext ? ext : "");
+  else
+    snprintf(out, len, "%s", texture);
+}
+
+static uint32_t align(uint32_t offset) { return (offset + FONT_PACK_ALIGN - 1) & ~(uint32_t)(FONT_PACK_ALIGN - 1); }
+
+int main(int argc, char **argv) {
+  if (argc < NUM_ARGS + 1 /*binary itself*/) {
+    printf("Incorrect usage!\n\t./fontpack FONT.FNT TEXTURE.PVR OUTPUT.FPK\n");
+    return 1;
+  }
+
+  size_t fnt_size;
+  unsigned char *fnt = read_file(argv[1], &fnt_size);
+  if (!fnt || parse_fnt(fnt, fnt_size))
+    return 1;
+  free(fnt);
+
+  memcpy(header.magic, FONT_PACK_MAGIC, sizeof(header.magic));
+  header.version = FONT_PACK_VERSION;
+
+  uint32_t offset = sizeof(font_pack_header) + sizeof(chars) + sizeof(font_pack_kern_row) * header.num_kern_rows +
+                    sizeof(font_pack_char) * header.num_wide_chars +
+                    sizeof(font_pack_kern_pair) * header.num_wide_pairs;
+  for (uint32_t i = 0; i < header.num_pages; i++) {
+    char path[FILENAME_MAX];
+    page_path(path, sizeof(path), argv[2], i);
+    if (!(pages[i] = read_page(path, &header.page_size[i])))
+      return 1;
+    offset = align(offset);
+    header.page_offset[i] = offset;
+    offset += header.page_size[i];
+  }
+
+  FILE *out = fopen(argv[3], "wb");
+  if (!out) {
+    printf("ERR: cant write %s\n", argv[3]);
+    return 1;
+  }
+  fwrite(&header, sizeof(header), 1, out);
+  fwrite(chars, sizeof(chars), 1, out);
+  fwrite(kern_rows, sizeof(font_pack_kern_row), header.num_kern_rows, out);
+  fwrite(wide_chars, sizeof(font_pack_char), header.num_wide_chars, out);
+  fwrite(wide_pairs, sizeof(font_pack_kern_pair), header.num_wide_pairs, out);
+  for (uint32_t i = 0; i < header.num_pages; i++) {
+    static const unsigned char zero[FONT_PACK_ALIGN];
+    fwrite(zero, 1, header.page_offset[i] - (uint32_t)ftell(out), out);
+    fwrite(pages[i], header.page_size[i], 1, out);
+    free(pages[i]);
+  }
+  const int failed = ferror(out);
+  fclose(out);
+  if (failed) {
+    printf("ERR: cant write %s\n", argv[3]);
+    return 1;
+  }
+
+  printf("%s: %d chars, %d past 255, %d kerning rows, %d wide pairs, %d pages, %u bytes\n", argv[3],
+         (int)header.num_chars, (int)header.num_wide_chars, (int)header.num_kern_rows, (int)header.num_wide_pairs,
+         (int)header.num_pages, offset);
+  free(wide_chars);
+  free(wide_pairs);
+  return 0;
+}
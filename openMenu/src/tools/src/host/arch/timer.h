@@ -0,0 +1,17 @@
+/*
+ * File: timer.h
+ * Project: tools
+ * File Created: Sunday, 18th October 2026 11:05:12 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+#pragma once
+
+/* Host stand-in for the KOS timer, drawrec runs it off the frame count so
+ * captures don't depend on how fast the host is */
+
+#include <stdint.h>
+
+uint64_t timer_ms_gettime64(void);
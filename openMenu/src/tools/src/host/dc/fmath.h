@@ -0,0 +1,14 @@
+/*
+ * File: fmath.h
+ * Project: tools
+ * File Created: Sunday, 18th October 2026 11:05:12 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+#pragma once
+
+/* Host stand-in for KOS fast math, the menu only needs it to exist */
+
+#include <math.h>
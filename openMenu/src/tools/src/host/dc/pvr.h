@@ -0,0 +1,149 @@
+/*
+ * File: pvr.h
+ * Project: tools
+ * File Created: Sunday, 18th October 2026 10:32:44 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+#pragma once
+
+/* Host stand-in for the parts of KOS pvr the menu uses. streamcheck implements
+ * the texture calls, drawrec all of it and records what would reach the TA */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef void *pvr_ptr_t;
+typedef uint32_t pvr_list_t;
+
+#define PVR_LIST_OP_POLY (0)
+#define PVR_LIST_OP_MOD (1)
+#define PVR_LIST_TR_POLY (2)
+#define PVR_LIST_TR_MOD (3)
+#define PVR_LIST_PT_POLY (4)
+
+#define PVR_BINSIZE_0 (0)
+#define PVR_BINSIZE_8 (8)
+#define PVR_BINSIZE_16 (16)
+#define PVR_BINSIZE_32 (32)
+
+/* Top three bits of the first word tell the TA what a parameter is */
+#define PVR_CMD_POLYHDR (0x80840000)
+#define PVR_CMD_SPRITE (0xA0000000)
+#define PVR_CMD_VERTEX (0xe0000000)
+#define PVR_CMD_VERTEX_EOL (0xf0000000)
+#define PVR_TA_CMD_TYPE_SHIFT (24)
+#define PVR_TA_CMD_TXRENABLE_SHIFT (3)
+
+#define PVR_TEXTURE_DISABLE (0)
+#define PVR_TEXTURE_ENABLE (1)
+#define PVR_FILTER_NONE (0)
+#define PVR_FILTER_NEAREST (0)
+#define PVR_FILTER_BILINEAR (2)
+
+#define PVR_TXRFMT_NONE (0)
+#define PVR_TXRFMT_VQ_DISABLE (0)
+#define PVR_TXRFMT_VQ_ENABLE (1 << 30)
+#define PVR_TXRFMT_ARGB1555 (0 << 27)
+#define PVR_TXRFMT_RGB565 (1 << 27)
+#define PVR_TXRFMT_ARGB4444 (2 << 27)
+#define PVR_TXRFMT_YUV422 (3 << 27)
+#define PVR_TXRFMT_BUMP (4 << 27)
+#define PVR_TXRFMT_PAL4BPP (5 << 27)
+#define PVR_TXRFMT_PAL8BPP (6 << 27)
+#define PVR_TXRFMT_TWIDDLED (0 << 26)
+#define PVR_TXRFMT_NONTWIDDLED (1 << 26)
+#define PVR_TXRFMT_STRIDE (1 << 25)
+#define PVR_TXRFMT_8BPP_PAL(x) ((x) << 25)
+#define PVR_TXRFMT_4BPP_PAL(x) ((x) << 21)
+
+#define PVR_PAL_ARGB1555 (0)
+#define PVR_PAL_RGB565 (1)
+#define PVR_PAL_ARGB4444 (2)
+#define PVR_PAL_ARGB8888 (3)
+
+static inline uint32_t pvr_pack_16bit_uv(float u, float v) {
+  uint32_t ui, vi;
+  memcpy(&ui, &u, sizeof(ui));
+  memcpy(&vi, &v, sizeof(vi));
+  return (ui & 0xFFFF0000) | (vi >> 16);
+}
+#define PVR_PACK_16BIT_UV(u, v) pvr_pack_16bit_uv((u), (v))
+
+typedef struct pvr_poly_cxt {
+  int list_type;
+  struct {
+    int alpha, shading, fog_type, culling, color_clamp, clip_mode, modifier_mode, specular;
+  } gen;
+  struct {
+    int src, dst, src_enable, dst_enable;
+  } blend;
+  struct {
+    int comparison, write;
+  } depth;
+  struct {
+    int enable, filter, mipmap, mipmap_bias, uv_flip, uv_clamp, alpha, env, width, height, format;
+    pvr_ptr_t base;
+  } txr;
+} pvr_poly_cxt_t;
+
+typedef pvr_poly_cxt_t pvr_sprite_cxt_t;
+
+typedef struct pvr_poly_hdr {
+  uint32_t cmd;
+  uint32_t mode1, mode2, mode3;
+  uint32_t d1, d2, d3, d4;
+} __attribute__((aligned(32))) pvr_poly_hdr_t;
+
+typedef struct pvr_sprite_hdr {
+  uint32_t cmd;
+  uint32_t mode1, mode2, mode3;
+  uint32_t argb, oargb;
+  uint32_t d1, d2;
+} __attribute__((aligned(32))) pvr_sprite_hdr_t;
+
+typedef struct pvr_vertex {
+  uint32_t flags;
+  float x, y, z;
+  float u, v;
+  uint32_t argb, oargb;
+} pvr_vertex_t;
+
+/* Sprites take two 32 byte parameters per quad */
+typedef struct pvr_sprite_txr {
+  uint32_t flags;
+  float ax, ay, az, bx, by, bz, cx, cy, cz, dx, dy;
+  uint32_t dummy, auv, buv, cuv;
+} pvr_sprite_txr_t;
+
+typedef struct pvr_sprite_col {
+  uint32_t flags;
+  float ax, ay, az, bx, by, bz, cx, cy, cz, dx, dy;
+  uint32_t d1, d2, d3, d4;
+} pvr_sprite_col_t;
+
+void pvr_poly_cxt_txr(pvr_poly_cxt_t *cxt, pvr_list_t list, int textureformat, int tw, int th, pvr_ptr_t textureaddr,
+                      int filtering);
+void pvr_poly_cxt_col(pvr_poly_cxt_t *cxt, pvr_list_t list);
+void pvr_poly_compile(pvr_poly_hdr_t *hdr, const pvr_poly_cxt_t *cxt);
+void pvr_sprite_cxt_txr(pvr_sprite_cxt_t *cxt, pvr_list_t list, int textureformat, int tw, int th,
+                        pvr_ptr_t textureaddr, int filtering);
+void pvr_sprite_cxt_col(pvr_sprite_cxt_t *cxt, pvr_list_t list);
+void pvr_sprite_compile(pvr_sprite_hdr_t *hdr, const pvr_sprite_cxt_t *cxt);
+
+int pvr_wait_ready(void);
+int pvr_scene_begin(void);
+int pvr_scene_finish(void);
+int pvr_list_begin(pvr_list_t list);
+int pvr_list_finish(void);
+int pvr_prim(const void *data, size_t size);
+
+void pvr_set_pal_format(int fmt);
+void pvr_set_pal_entry(uint32_t idx, uint32_t value);
+
+pvr_ptr_t pvr_mem_malloc(size_t size);
+void pvr_mem_free(pvr_ptr_t ptr);
+void pvr_txr_load(const void *src, pvr_ptr_t dst, uint32_t count);
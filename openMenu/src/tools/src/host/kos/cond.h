@@ -0,0 +1,24 @@
+/*
+ * File: cond.h
+ * Project: tools
+ * File Created: Sunday, 18th October 2026 11:05:12 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+#pragma once
+
+/* Host stand-in for KOS condition variables, straight onto pthreads */
+
+#include <pthread.h>
+
+#include <kos/mutex.h>
+
+typedef pthread_cond_t condvar_t;
+
+#define COND_INITIALIZER PTHREAD_COND_INITIALIZER
+
+static inline int cond_wait(condvar_t *cv, mutex_t *m) { return pthread_cond_wait(cv, m); }
+static inline int cond_signal(condvar_t *cv) { return pthread_cond_signal(cv); }
+static inline int cond_broadcast(condvar_t *cv) { return pthread_cond_broadcast(cv); }
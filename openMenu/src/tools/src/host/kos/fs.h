@@ -0,0 +1,32 @@
+/*
+ * File: fs.h
+ * Project: tools
+ * File Created: Sunday, 18th October 2026 10:32:44 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+#pragma once
+
+/* Host stand-in for the parts of KOS fs the menu uses, streamcheck implements
+ * the reads, drawrec all of it with /cd/ mapped to a data folder */
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+typedef int file_t;
+
+#define FILEHND_INVALID ((file_t)-1)
+#define STAT_TYPE_NONE (0)
+
+file_t fs_open(const char *path, int mode);
+int fs_close(file_t fd);
+ssize_t fs_read(file_t fd, void *buf, size_t len);
+off_t fs_seek(file_t fd, off_t pos, int whence);
+off_t fs_tell(file_t fd);
+size_t fs_total(file_t fd);
+int fs_stat(const char *path, struct stat *buf, int flag);
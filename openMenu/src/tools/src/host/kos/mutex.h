@@ -0,0 +1,21 @@
+/*
+ * File: mutex.h
+ * Project: tools
+ * File Created: Sunday, 18th October 2026 11:05:12 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+#pragma once
+
+/* Host stand-in for KOS mutexes, straight onto pthreads */
+
+#include <pthread.h>
+
+typedef pthread_mutex_t mutex_t;
+
+#define MUTEX_INITIALIZER PTHREAD_MUTEX_INITIALIZER
+
+static inline int mutex_lock(mutex_t *m) { return pthread_mutex_lock(m); }
+static inline int mutex_unlock(mutex_t *m) { return pthread_mutex_unlock(m); }
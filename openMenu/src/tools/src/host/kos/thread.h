@@ -0,0 +1,17 @@
+/*
+ * File: thread.h
+ * Project: tools
+ * File Created: Sunday, 18th October 2026 11:05:12 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+#pragma once
+
+/* Host stand-in for the KOS thread calls the menu uses, drawrec implements them */
+
+typedef struct kthread kthread_t;
+
+kthread_t *thd_create(int detach, void *(*routine)(void *param), void *param);
+int thd_join(kthread_t *thd, void **value_out);
@@ -0,0 +1,245 @@
+/*
+ * File: keybench.c
+ * Project: tools
+ * File Created: Sunday, 18th October 2026 2:05:33 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <backend/product_key.h>
+
+/* Tables in this file use product_key, string versions live in keybench_str.c */
+#define HASH_FUNCTION PRODUCT_KEY_HASH_FUNCTION
+#define HASH_KEYCMP PRODUCT_KEY_KEYCMP
+#include <uthash.h>
+
+#include <backend/dat_format.h>
+
+#include <texture/lru.h>
+
+#include "keybench.h"
+
+/* Called:
+./keybench [num_ids] [num_lookups]
+
+times product ID lookups keyed as C strings (old) against product_key (new)
+*/
+
+#define DEFAULT_IDS (1500)
+#define DEFAULT_LOOKUPS (2000000)
+#define LRU_SIZE (16)
+#define CHUNK_SIZE (64)
+#define BENCH_DAT "keybench.dat"
+
+typedef struct key_entry {
+  product_key key;
+  int value;
+  UT_hash_handle hh;
+} key_entry;
+
+static key_entry *lru_hash = NULL;
+
+/* New lru.c pattern: key embedded in the entry, no strdup */
+static int key_lru_touch(const product_key *key, unsigned int max_size) {
+  key_entry *entry, *tmp_entry;
+  HASH_FIND(hh, lru_hash, key, sizeof(product_key), entry);
+  if (entry) {
+    HASH_DELETE(hh, lru_hash, entry);
+    HASH_ADD(hh, lru_hash, key, sizeof(product_key), entry);
+    return 1;
+  }
+
+  entry = calloc(1, sizeof(key_entry));
+  entry->key = *key;
+  HASH_ADD(hh, lru_hash, key, sizeof(product_key), entry);
+  if (HASH_COUNT(lru_hash) > max_size) {
+    HASH_ITER(hh, lru_hash, entry, tmp_entry) {
+      HASH_DELETE(hh, lru_hash, entry);
+      free(entry);
+      break;
+    }
+  }
+  return 0;
+}
+
+static void key_lru_destroy(void) {
+  key_entry *entry, *tmp_entry;
+  HASH_ITER(hh, lru_hash, entry, tmp_entry) {
+    HASH_DELETE(hh, lru_hash, entry);
+    free(entry);
+  }
+}
+
+/* lru.c, fixed node array with an intrusive recency list */
+static int cache_lru_touch(cache_instance *cache, const product_key *key) {
+  if (find_in_cache(cache, key) != -1) {
+    return 1;
+  }
+  add_to_cache(cache, key, 0);
+  return 0;
+}
+
+static double seconds(clock_t start) {
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static void report(const char *name, double secs, int ops, uint32_t check) {
+  printf("  %-34s %8.2f ns/op  (check %u)\n", name, secs * 1e9 / ops, check);
+}
+
+/* Same shapes as real serials: T12345N, MK5100050, HDR0054, T36815D05 */
+static void make_id(char *out, int i) {
+  switch (i % 4) {
+    case 0: sprintf(out, "T%05dN", i); break;
+    case 1: sprintf(out, "MK51%03d50", i % 1000); break;
+    case 2: sprintf(out, "HDR%04d", i); break;
+    default: sprintf(out, "T%05dD05", i); break;
+  }
+}
+
+static int write_dat(const char *path, const char (*ids)[12], int num_ids) {
+  FILE *fd = fopen(path, "wb");
+  if (!fd) {
+    printf("Error: Couldn't write %s!\n", path);
+    return 1;
+  }
+
+  bin_header header = {.magic.rich = {{'D', 'A', 'T'}, 1}, .chunk_size = CHUNK_SIZE, .num_chunks = num_ids};
+  fwrite(&header, sizeof(header), 1, fd);
+  for (int i = 0; i < num_ids; i++) {
+    uint32_t offset = i + 1 + (sizeof(header) + num_ids * 16) / CHUNK_SIZE;
+    fwrite(ids[i], 12, 1, fd);
+    fwrite(&offset, sizeof(offset), 1, fd);
+  }
+  fclose(fd);
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  int num_ids = (argc > 1) ? atoi(argv[1]) : DEFAULT_IDS;
+  int num_lookups = (argc > 2) ? atoi(argv[2]) : DEFAULT_LOOKUPS;
+  if (num_ids <= 0 || num_lookups <= 0) {
+    printf("%s [num_ids] [num_lookups]\n", argv[0]);
+    return 1;
+  }
+
+  char(*ids)[12] = calloc(num_ids, 12);
+  char(*queries)[12] = calloc(num_lookups, 12);
+  product_key *query_keys = calloc(num_lookups, sizeof(product_key));
+  if (!ids || !queries || !query_keys) {
+    printf("%s no free memory\n", __func__);
+    return 1;
+  }
+
+  for (int i = 0; i < num_ids; i++) {
+    make_id(ids[i], i);
+  }
+  /* ~80% hits, rest misses that share the same prefixes */
+  srand(1234);
+  for (int i = 0; i < num_lookups; i++) {
+    if (rand() % 5) {
+      strcpy(queries[i], ids[rand() % num_ids]);
+    } else {
+      sprintf(queries[i], "T%05dM", rand() % 100000);
+    }
+    product_key_make(&query_keys[i], queries[i]);
+  }
+
+  printf("keybench: %d ids, %d lookups\n", num_ids, num_lookups);
+
+  /* DAT lookups */
+  if (write_dat(BENCH_DAT, (const char(*)[12])ids, num_ids)) {
+    return 1;
+  }
+  dat_file dat;
+  DAT_init(&dat);
+  if (DAT_load_parse(&dat, BENCH_DAT)) {
+    return 1;
+  }
+  str_table_build((const char(*)[12])ids, num_ids);
+
+  printf("DAT lookup:\n");
+  uint32_t check = 0;
+  clock_t start = clock();
+  for (int i = 0; i < num_lookups; i++) {
+    check += (str_table_find(queries[i]) != 0);
+  }
+  report("string key (HASH_FIND_STR)", seconds(start), num_lookups, check);
+
+  check = 0;
+  start = clock();
+  for (int i = 0; i < num_lookups; i++) {
+    check += (DAT_get_index_by_ID(&dat, queries[i]) != 0xFFFFFFFF);
+  }
+  report("DAT_get_index_by_ID (pack + find)", seconds(start), num_lookups, check);
+
+  check = 0;
+  start = clock();
+  for (int i = 0; i < num_lookups; i++) {
+    check += (DAT_get_index_by_key(&dat, &query_keys[i]) != 0xFFFFFFFF);
+  }
+  report("DAT_get_index_by_key", seconds(start), num_lookups, check);
+
+  /* Texture cache churn, small working set like the icon pool */
+  printf("LRU touch (%d entries):\n", LRU_SIZE);
+  int lru_ops = num_lookups / 4;
+  check = 0;
+  start = clock();
+  for (int i = 0; i < lru_ops; i++) {
+    check += str_lru_touch(ids[(i * 7 + (i >> 5)) % (LRU_SIZE * 2)], LRU_SIZE);
+  }
+  report("strdup'd string key", seconds(start), lru_ops, check);
+
+  check = 0;
+  start = clock();
+  for (int i = 0; i < lru_ops; i++) {
+    product_key key;
+    product_key_make(&key, ids[(i * 7 + (i >> 5)) % (LRU_SIZE * 2)]);
+    check += key_lru_touch(&key, LRU_SIZE);
+  }
+  report("embedded product_key", seconds(start), lru_ops, check);
+
+  cache_instance cache = {0};
+  cache_set_size(&cache, LRU_SIZE);
+  check = 0;
+  start = clock();
+  for (int i = 0; i < lru_ops; i++) {
+    product_key key;
+    product_key_make(&key, ids[(i * 7 + (i >> 5)) % (LRU_SIZE * 2)]);
+    check += cache_lru_touch(&cache, &key);
+  }
+  report("intrusive lru.c", seconds(start), lru_ops, check);
+  cache_destroy(&cache);
+
+  /* Raw key equality */
+  printf("Key compare:\n");
+  check = 0;
+  start = clock();
+  for (int i = 1; i < num_lookups; i++) {
+    check += !strcmp(queries[i], queries[i - 1]);
+  }
+  report("strcmp", seconds(start), num_lookups, check);
+
+  check = 0;
+  start = clock();
+  for (int i = 1; i < num_lookups; i++) {
+    check += product_key_equal(&query_keys[i], &query_keys[i - 1]);
+  }
+  report("product_key_equal", seconds(start), num_lookups, check);
+
+  str_lru_destroy();
+  key_lru_destroy();
+  str_table_destroy();
+  fclose(dat.handle);
+  remove(BENCH_DAT);
+  free(ids);
+  free(queries);
+  free(query_keys);
+  return 0;
+}
@@ -0,0 +1,21 @@
+/*
+ * File: keybench.h
+ * Project: tools
+ * File Created: Sunday, 18th October 2026 2:05:33 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/* String keyed reference implementations, see keybench_str.c */
+void str_table_build(const char (*ids)[12], int num_ids);
+uint32_t str_table_find(const char* id);
+void str_table_destroy(void);
+
+int str_lru_touch(const char* id, unsigned int max_size);
+void str_lru_destroy(void);
@@ -0,0 +1,87 @@
+/*
+ * File: keybench_str.c
+ * Project: tools
+ * File Created: Sunday, 18th October 2026 2:05:33 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Default uthash string hashing, how the tables were keyed before product_key */
+#include <uthash.h>
+
+#include "keybench.h"
+
+typedef struct str_item {
+  char ID[12];
+  uint32_t offset;
+  UT_hash_handle hh;
+} str_item;
+
+typedef struct str_entry {
+  char *key;
+  int value;
+  UT_hash_handle hh;
+} str_entry;
+
+static str_item *items = NULL;
+static str_item *items_hash = NULL;
+static str_entry *lru_hash = NULL;
+
+void str_table_build(const char (*ids)[12], int num_ids) {
+  items = calloc(num_ids, sizeof(str_item));
+  for (int i = 0; i < num_ids; i++) {
+    strcpy(items[i].ID, ids[i]);
+    items[i].offset = i + 1;
+    HASH_ADD_STR(items_hash, ID, &items[i]);
+  }
+}
+
+uint32_t str_table_find(const char *id) {
+  const str_item *item;
+  HASH_FIND_STR(items_hash, id, item);
+  return item ? item->offset : 0;
+}
+
+void str_table_destroy(void) {
+  HASH_CLEAR(hh, items_hash);
+  free(items);
+  items = NULL;
+}
+
+/* Old lru.c pattern: strdup on insert, delete + add to bump, free on evict */
+int str_lru_touch(const char *id, unsigned int max_size) {
+  str_entry *entry, *tmp_entry;
+  HASH_FIND_STR(lru_hash, id, entry);
+  if (entry) {
+    HASH_DELETE(hh, lru_hash, entry);
+    HASH_ADD_STR(lru_hash, key, entry);
+    return 1;
+  }
+
+  entry = calloc(1, sizeof(str_entry));
+  entry->key = strdup(id);
+  HASH_ADD_STR(lru_hash, key, entry);
+  if (HASH_COUNT(lru_hash) > max_size) {
+    HASH_ITER(hh, lru_hash, entry, tmp_entry) {
+      HASH_DELETE(hh, lru_hash, entry);
+      free(entry->key);
+      free(entry);
+      break;
+    }
+  }
+  return 0;
+}
+
+void str_lru_destroy(void) {
+  str_entry *entry, *tmp_entry;
+  HASH_ITER(hh, lru_hash, entry, tmp_entry) {
+    HASH_DELETE(hh, lru_hash, entry);
+    free(entry->key);
+    free(entry);
+  }
+}
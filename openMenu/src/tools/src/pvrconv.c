@@ -0,0 +1,647 @@
+/*
+ * File: pvrconv.c
+ * Project: tools
+ * File Created: Sunday, 18th October 2026 11:05:12 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+#include <ctype.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <jpeglib.h>
+#include <png.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(_WIN32) || defined(WIN32)
+#define PATH_SEP "\\"
+#else
+#define PATH_SEP "/"
+#endif
+
+#include "dat_packer_interface.h"
+
+/* Called:
+./pvrconv [-s size] [-f auto|565|1555|4444] [-d] [-j threads] INPUT_FOLDER OUTPUT
+./pvrconv -b [-s size] [-f ...] [-d] [-j threads] INPUT_FOLDER
+
+converts every .png/.jpg in the folder to a size x size (128 default) square
+twiddled PVR, one image per thread at a time. OUTPUT is a folder for .pvr
+files named like the input, or a file ending in .dat to write the chunks
+straight into a DAT the same as datpack would. auto picks RGB565 for opaque
+images, ARGB1555 when alpha is only on or off and ARGB4444 otherwise. -d adds
+ordered dithering before the colors are cut down. -b converts without
+writing anything and reports images per second for 1 thread up to -j.
+*/
+
+#define NUM_ARGS (2)
+#define MAX_FILES (16384)
+#define HDR_SIZE (0x20)
+#define WEIGHT_BITS (14)
+
+/* PVRT color formats */
+#define PVR_ARGB1555 (0x00)
+#define PVR_RGB565 (0x01)
+#define PVR_ARGB4444 (0x02)
+#define PVR_AUTO (-1)
+
+/* PVRT layouts */
+#define PVR_TWIDDLED (0x01)
+
+typedef struct rgba_image {
+  int width, height;
+  unsigned char *pixels; /* RGBA, rows packed */
+} rgba_image;
+
+static char files[MAX_FILES][FILENAME_MAX];
+static int num_files = 0;
+static const char *in_folder;
+static const char *out_path;
+static int out_size = 128;
+static int out_color = PVR_AUTO;
+static int dither = 0;
+static int benchmark = 0;
+
+/* DAT output, every image gets chunk i + 1 */
+static bin_header file_header;
+static bin_item_raw *bin_items;
+static unsigned char *data_buf;
+
+/* Twiddled offset split by axis, x in the odd bits and y in the even ones */
+static uint32_t *twiddle_x, *twiddle_y;
+
+static pthread_mutex_t work_lock = PTHREAD_MUTEX_INITIALIZER;
+static int next_file = 0;
+static int converted = 0, failed = 0;
+
+/* 4x4 Bayer matrix, 0..15 */
+static const unsigned char bayer[4][4] = {{0, 8, 2, 10}, {12, 4, 14, 6}, {3, 11, 1, 9}, {15, 7, 13, 5}};
+
+static uint32_t spread_bits(uint32_t v) {
+  uint32_t out = 0;
+  for (int bit = 0; bit < 16; bit++)
+    out |= ((v >> bit) & 1) << (bit * 2);
+  return out;
+}
+
+static void init_twiddle(int size) {
+  twiddle_x = malloc(sizeof(uint32_t) * size);
+  twiddle_y = malloc(sizeof(uint32_t) * size);
+  for (int i = 0; i < size; i++) {
+    twiddle_x[i] = spread_bits(i) << 1;
+    twiddle_y[i] = spread_bits(i);
+  }
+}
+
+static int has_ext(const char *name, const char *ext) {
+  const char *dot = strrchr(name, '.');
+  if (!dot)
+    return 0;
+  for (dot++; *dot && *ext; dot++, ext++) {
+    if (tolower(*dot) != *ext)
+      return 0;
+  }
+  return !*dot && !*ext;
+}
+
+static int is_jpeg(const char *name) { return has_ext(name, "jpg") || has_ext(name, "jpeg"); }
+
+static int decode_png(const char *path, rgba_image *img) {
+  png_image png;
+  memset(&png, 0, sizeof(png));
+  png.version = PNG_IMAGE_VERSION;
+  if (!png_image_begin_read_from_file(&png, path))
+    return -1;
+  png.format = PNG_FORMAT_RGBA;
+  img->width = (int)png.width;
+  img->height = (int)png.height;
+  img->pixels = malloc(PNG_IMAGE_SIZE(png));
+  if (!img->pixels || !png_image_finish_read(&png, NULL, img->pixels, 0, NULL)) {
+    png_image_free(&png);
+    free(img->pixels);
+    return -1;
+  }
+  return 0;
+}
+
+typedef struct jpeg_error {
+  struct jpeg_error_mgr mgr;
+  jmp_buf jump;
+} jpeg_error;
+
+static void jpeg_error_exit(j_common_ptr cinfo) { longjmp(((jpeg_error *)cinfo->err)->jump, 1); }
+
+static int decode_jpeg(const char *path, rgba_image *img) {
+  struct jpeg_decompress_struct cinfo;
+  jpeg_error err;
+  unsigned char *row = NULL;
+  FILE *fd = fopen(path, "rb");
+  if (!fd)
+    return -1;
+
+  img->pixels = NULL;
+  cinfo.err = jpeg_std_error(&err.mgr);
+  err.mgr.error_exit = jpeg_error_exit;
+  if (setjmp(err.jump)) {
+    jpeg_destroy_decompress(&cinfo);
+    fclose(fd);
+    free(row);
+    free(img->pixels);
+    return -1;
+  }
+  jpeg_create_decompress(&cinfo);
+  jpeg_stdio_src(&cinfo, fd);
+  jpeg_read_header(&cinfo, TRUE);
+  cinfo.out_color_space = JCS_RGB;
+  jpeg_start_decompress(&cinfo);
+
+  img->width = (int)cinfo.output_width;
+  img->height = (int)cinfo.output_height;
+  img->pixels = malloc((size_t)img->width * img->height * 4);
+  row = malloc((size_t)img->width * 3);
+  while (cinfo.output_scanline < cinfo.output_height) {
+    unsigned char *dst = img->pixels + (size_t)cinfo.output_scanline * img->width * 4;
+    jpeg_read_scanlines(&cinfo, &row, 1);
+    for (int x = 0; x < img->width; x++) {
+      dst[x * 4 + 0] = row[x * 3 + 0];
+      dst[x * 4 + 1] = row[x * 3 + 1];
+      dst[x * 4 + 2] = row[x * 3 + 2];
+      dst[x * 4 + 3] = 0xFF;
+    }
+  }
+  jpeg_finish_decompress(&cinfo);
+  jpeg_destroy_decompress(&cinfo);
+  fclose(fd);
+  free(row);
+  return 0;
+}
+
+/* Triangle filter widened to the source step when shrinking, weights sum to 1 << WEIGHT_BITS */
+typedef struct resample {
+  int *first, *count;
+  int32_t *weights;
+  int taps;
+} resample;
+
+static void build_resample(resample *rs, int src, int dst) {
+  const double scale = (double)src / dst;
+  const double support = scale > 1.0 ? scale : 1.0;
+  rs->taps = (int)(support * 2) + 2;
+  rs->first = malloc(sizeof(int) * dst);
+  rs->count = malloc(sizeof(int) * dst);
+  rs->weights = calloc((size_t)dst * rs->taps, sizeof(int32_t));
+
+  for (int i = 0; i < dst; i++) {
+    const double center = (i + 0.5) * scale;
+    int lo = (int)(center - support);
+    int hi = (int)(center + support) + 1;
+    if (lo < 0)
+      lo = 0;
+    if (hi > src)
+      hi = src;
+    if (hi - lo > rs->taps)
+      hi = lo + rs->taps;
+
+    double total = 0;
+    for (int s = lo; s < hi; s++) {
+      const double dist = (s + 0.5) - center;
+      const double w = 1.0 - (dist < 0 ? -dist : dist) / support;
+      total += w > 0 ? w : 0;
+    }
+    int32_t sum = 0;
+    for (int s = lo; s < hi; s++) {
+      const double dist = (s + 0.5) - center;
+      const double w = 1.0 - (dist < 0 ? -dist : dist) / support;
+      rs->weights[i * rs->taps + s - lo] = (int32_t)((w > 0 ? w : 0) / total * (1 << WEIGHT_BITS) + 0.5);
+      sum += rs->weights[i * rs->taps + s - lo];
+    }
+    /* Rounding leftovers go to the middle tap so flat areas stay flat */
+    rs->weights[i * rs->taps + (hi - lo) / 2] += (1 << WEIGHT_BITS) - sum;
+    rs->first[i] = lo;
+    rs->count[i] = hi - lo;
+  }
+}
+
+static void free_resample(resample *rs) {
+  free(rs->first);
+  free(rs->count);
+  free(rs->weights);
+}
+
+static unsigned char clamp_u8(int32_t v) {
+  v = (v + (1 << (WEIGHT_BITS - 1))) >> WEIGHT_BITS;
+  return (unsigned char)(v < 0 ? 0 : v > 255 ? 255 : v);
+}
+
+/* Separable resize to size x size, horizontal first */
+static unsigned char *resize(const rgba_image *img, int size) {
+  resample rx, ry;
+  build_resample(&rx, img->width, size);
+  build_resample(&ry, img->height, size);
+
+  unsigned char *tmp = malloc((size_t)size * img->height * 4);
+  unsigned char *out = malloc((size_t)size * size * 4);
+  for (int y = 0; y < img->height; y++) {
+    const unsigned char *src = img->pixels + (size_t)y * img->width * 4;
+    unsigned char *dst = tmp + (size_t)y * size * 4;
+    for (int x = 0; x < size; x++) {
+      int32_t acc[4] = {0, 0, 0, 0};
+      const int32_t *w = rx.weights + x * rx.taps;
+      const unsigned char *s = src + rx.first[x] * 4;
+      for (int t = 0; t < rx.count[x]; t++, s += 4) {
+        acc[0] += s[0] * w[t];
+        acc[1] += s[1] * w[t];
+        acc[2] += s[2] * w[t];
+        acc[3] += s[3] * w[t];
+      }
+      for (int c = 0; c < 4; c++)
+        dst[x * 4 + c] = clamp_u8(acc[c]);
+    }
+  }
+  for (int y = 0; y < size; y++) {
+    const int32_t *w = ry.weights + y * ry.taps;
+    unsigned char *dst = out + (size_t)y * size * 4;
+    for (int x = 0; x < size * 4; x++) {
+      int32_t acc = 0;
+      const unsigned char *s = tmp + (size_t)ry.first[y] * size * 4 + x;
+      for (int t = 0; t < ry.count[y]; t++, s += (size_t)size * 4)
+        acc += *s * w[t];
+      dst[x] = clamp_u8(acc);
+    }
+  }
+  free(tmp);
+  free_resample(&rx);
+  free_resample(&ry);
+  return out;
+}
+
+static int pick_color(const unsigned char *rgba, int texels) {
+  int partial = 0, clear = 0;
+  for (int i = 0; i < texels; i++) {
+    const unsigned char a = rgba[i * 4 + 3];
+    partial |= (a != 0 && a != 0xFF);
+    clear |= (a != 0xFF);
+  }
+  return partial ? PVR_ARGB4444 : clear ? PVR_ARGB1555 : PVR_RGB565;
+}
+
+/* Per channel dither for one row, repeats every 4 texels. Offsets stay under
+ * one step of the channel's precision so they only move values that get cut. */
+static void dither_row(int color, int y, unsigned char *offsets) {
+  static const int drop[3][4] = {{3, 3, 3, 0}, {3, 2, 3, 0}, {4, 4, 4, 4}};
+  for (int x = 0; x < 4; x++) {
+    for (int c = 0; c < 4; c++) {
+      const int bits = dither ? drop[color][c] : 0;
+      offsets[x * 4 + c] = (unsigned char)((bayer[y & 3][x] << bits) >> 4);
+    }
+  }
+}
+
+static uint16_t pack_scalar(int color, uint32_t p) {
+  const uint32_t r = p & 0xFF, g = (p >> 8) & 0xFF, b = (p >> 16) & 0xFF, a = p >> 24;
+  switch (color) {
+    case PVR_ARGB1555:
+      return (uint16_t)((a >> 7) << 15 | (r >> 3) << 10 | (g >> 3) << 5 | (b >> 3));
+    case PVR_ARGB4444:
+      return (uint16_t)((a >> 4) << 12 | (r >> 4) << 8 | (g >> 4) << 4 | (b >> 4));
+    default:
+      return (uint16_t)((r >> 3) << 11 | (g >> 2) << 5 | (b >> 3));
+  }
+}
+
+/* One row of RGBA to 16bit texels, offsets from dither_row added saturating first */
+static void pack_row(int color, const unsigned char *rgba, const unsigned char *offsets, uint16_t *out, int width) {
+  int x = 0;
+#if defined(__SSE2__)
+  const __m128i dith = _mm_loadu_si128((const __m128i *)offsets);
+  const __m128i m5 = _mm_set1_epi32(0x1F), m6 = _mm_set1_epi32(0x3F), m4 = _mm_set1_epi32(0x0F);
+  const __m128i bias = _mm_set1_epi32(0x8000);
+  for (; x + 8 <= width; x += 8) {
+    __m128i p[2];
+    for (int half = 0; half < 2; half++) {
+      const __m128i v = _mm_adds_epu8(_mm_loadu_si128((const __m128i *)(rgba + (x + half * 4) * 4)), dith);
+      __m128i t;
+      switch (color) {
+        case PVR_ARGB1555:
+          t = _mm_or_si128(_mm_slli_epi32(_mm_srli_epi32(v, 31), 15),
+                           _mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(v, 3), m5), 10),
+                                        _mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(v, 11), m5), 5),
+                                                     _mm_and_si128(_mm_srli_epi32(v, 19), m5))));
+          break;
+        case PVR_ARGB4444:
+          t = _mm_or_si128(_mm_slli_epi32(_mm_srli_epi32(v, 28), 12),
+                           _mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(v, 4), m4), 8),
+                                        _mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(v, 12), m4), 4),
+                                                     _mm_and_si128(_mm_srli_epi32(v, 20), m4))));
+          break;
+        default:
+          t = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(v, 3), m5), 11),
+                           _mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(v, 10), m6), 5),
+                                        _mm_and_si128(_mm_srli_epi32(v, 19), m5)));
+          break;
+      }
+      /* packs is signed, move into its range and back */
+      p[half] = _mm_sub_epi32(t, bias);
+    }
+    _mm_storeu_si128((__m128i *)(out + x), _mm_xor_si128(_mm_packs_epi32(p[0], p[1]), _mm_set1_epi16((short)0x8000)));
+  }
+#endif
+  for (; x < width; x++) {
+    uint32_t p = 0;
+    for (int c = 0; c < 4; c++) {
+      const int v = rgba[x * 4 + c] + offsets[(x & 3) * 4 + c];
+      p |= (uint32_t)(v > 255 ? 255 : v) << (c * 8);
+    }
+    out[x] = pack_scalar(color, p);
+  }
+}
+
+/* Two rows into the twiddled texture. y and y + 1 at the same x are
+ * neighbours and so are x and x + 1, every 2x2 block is 4 texels in a row. */
+static void twiddle_rows(const uint16_t *row0, const uint16_t *row1, int y, int width, uint16_t *out) {
+  int x = 0;
+#if defined(__SSE2__)
+  for (; x + 8 <= width; x += 8) {
+    const __m128i a = _mm_loadu_si128((const __m128i *)(row0 + x));
+    const __m128i b = _mm_loadu_si128((const __m128i *)(row1 + x));
+    const __m128i lo = _mm_unpacklo_epi16(a, b);
+    const __m128i hi = _mm_unpackhi_epi16(a, b);
+    _mm_storel_epi64((__m128i *)(out + (twiddle_x[x] | twiddle_y[y])), lo);
+    _mm_storel_epi64((__m128i *)(out + (twiddle_x[x + 2] | twiddle_y[y])), _mm_srli_si128(lo, 8));
+    _mm_storel_epi64((__m128i *)(out + (twiddle_x[x + 4] | twiddle_y[y])), hi);
+    _mm_storel_epi64((__m128i *)(out + (twiddle_x[x + 6] | twiddle_y[y])), _mm_srli_si128(hi, 8));
+  }
+#endif
+  for (; x < width; x += 2) {
+    uint16_t *dst = out + (twiddle_x[x] | twiddle_y[y]);
+    dst[0] = row0[x];
+    dst[1] = row1[x];
+    dst[2] = row0[x + 1];
+    dst[3] = row1[x + 1];
+  }
+}
+
+static void put_u16(unsigned char *dst, uint16_t v) {
+  dst[0] = v & 0xFF;
+  dst[1] = v >> 8;
+}
+
+static void put_u32(unsigned char *dst, uint32_t v) {
+  put_u16(dst, v & 0xFFFF);
+  put_u16(dst + 2, v >> 16);
+}
+
+static size_t pvr_file_size(void) { return HDR_SIZE + (size_t)out_size * out_size * 2; }
+
+/* Whole PVR file into out, pvr_file_size() bytes */
+static void encode(const unsigned char *rgba, unsigned char *out) {
+  const int size = out_size;
+  const int color = (out_color == PVR_AUTO) ? pick_color(rgba, size * size) : out_color;
+  uint16_t *rows = malloc(sizeof(uint16_t) * size * 2);
+  uint16_t *texels = malloc(sizeof(uint16_t) * size * size);
+  unsigned char offsets[2][16];
+
+  for (int y = 0; y < size; y += 2) {
+    dither_row(color, y, offsets[0]);
+    dither_row(color, y + 1, offsets[1]);
+    pack_row(color, rgba + (size_t)y * size * 4, offsets[0], rows, size);
+    pack_row(color, rgba + (size_t)(y + 1) * size * 4, offsets[1], rows + size, size);
+    twiddle_rows(rows, rows + size, y, size, texels);
+  }
+
+  memset(out, '\0', HDR_SIZE);
+  memcpy(out, "GBIX", 4);
+  put_u32(out + 4, 8);
+  memcpy(out + 16, "PVRT", 4);
+  put_u32(out + 20, (uint32_t)(8 + size * size * 2));
+  out[24] = (unsigned char)color;
+  out[25] = PVR_TWIDDLED;
+  put_u16(out + 28, (uint16_t)size);
+  put_u16(out + 30, (uint16_t)size);
+  for (int i = 0; i < size * size; i++)
+    put_u16(out + HDR_SIZE + i * 2, texels[i]);
+
+  free(rows);
+  free(texels);
+}
+
+static int write_pvr(const char *name, const unsigned char *data, size_t size) {
+  char path[FILENAME_MAX];
+  char base[FILENAME_MAX];
+  strncpy(base, name, sizeof(base) - 1);
+  base[sizeof(base) - 1] = '\0';
+  char *dot = strrchr(base, '.');
+  if (dot)
+    *dot = '\0';
+  snprintf(path, sizeof(path), "%s%s%s.pvr", out_path, PATH_SEP, base);
+  FILE *fd = fopen(path, "wb");
+  if (!fd) {
+    printf("ERR: cant write %s\n", path);
+    return -1;
+  }
+  fwrite(data, size, 1, fd);
+  fclose(fd);
+  return 0;
+}
+
+/* Filename without extension, upper case, same as datpack */
+static int make_id(const char *name, char *id) {
+  const char *dot = strrchr(name, '.');
+  if ((size_t)(dot - name) > 11) {
+    printf("Err: filename too long \"%s\", maxlength = 11!\n", name);
+    return -1;
+  }
+  memset(id, '\0', 12);
+  for (int i = 0; name + i < dot; i++)
+    id[i] = (char)toupper(name[i]);
+  return 0;
+}
+
+/* Decodes, resizes and encodes file_num, into its DAT chunk or a file */
+static int convert(int file_num, unsigned char *out) {
+  char path[FILENAME_MAX];
+  rgba_image img;
+  snprintf(path, sizeof(path), "%s%s%s", in_folder, PATH_SEP, files[file_num]);
+
+  if ((is_jpeg(path) ? decode_jpeg(path, &img) : decode_png(path, &img))) {
+    printf("ERR: cant decode %s\n", path);
+    return -1;
+  }
+  unsigned char *rgba = resize(&img, out_size);
+  free(img.pixels);
+  encode(rgba, out);
+  free(rgba);
+  return 0;
+}
+
+static void *worker(void *user) {
+  unsigned char *scratch = malloc(pvr_file_size());
+  (void)user;
+  for (;;) {
+    pthread_mutex_lock(&work_lock);
+    const int file = next_file < num_files ? next_file++ : -1;
+    pthread_mutex_unlock(&work_lock);
+    if (file == -1)
+      break;
+
+    unsigned char *out = data_buf ? data_buf + (size_t)file * file_header.chunk_size : scratch;
+    int ok = !convert(file, out);
+    if (ok && !data_buf && !benchmark)
+      ok = !write_pvr(files[file], out, pvr_file_size());
+
+    pthread_mutex_lock(&work_lock);
+    if (ok)
+      converted++;
+    else
+      failed++;
+    pthread_mutex_unlock(&work_lock);
+  }
+  free(scratch);
+  return NULL;
+}
+
+static double run(int num_threads) {
+  struct timespec start, end;
+  pthread_t *threads = malloc(sizeof(pthread_t) * num_threads);
+  next_file = converted = failed = 0;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < num_threads; i++)
+    pthread_create(&threads[i], NULL, worker, NULL);
+  for (int i = 0; i < num_threads; i++)
+    pthread_join(threads[i], NULL);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  free(threads);
+  return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+static int cmp_name(const void *a, const void *b) { return strcmp((const char *)a, (const char *)b); }
+
+static int write_dat(void) {
+  for (int i = 0; i < num_files; i++) {
+    if (make_id(files[i], bin_items[i].ID))
+      return -1;
+    bin_items[i].offset = (uint32_t)i + 1;
+  }
+  open_output(out_path);
+  write_bin_file(&file_header, bin_items, data_buf);
+  return 0;
+}
+
+static int parse_color(const char *arg) {
+  if (!strcmp(arg, "auto"))
+    out_color = PVR_AUTO;
+  else if (!strcmp(arg, "565"))
+    out_color = PVR_RGB565;
+  else if (!strcmp(arg, "1555"))
+    out_color = PVR_ARGB1555;
+  else if (!strcmp(arg, "4444"))
+    out_color = PVR_ARGB4444;
+  else
+    return -1;
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  int num_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  int opt, bad = 0;
+  while ((opt = getopt(argc, argv, "s:f:dj:b")) != -1) {
+    switch (opt) {
+      case 's':
+        out_size = atoi(optarg);
+        break;
+      case 'f':
+        bad |= parse_color(optarg);
+        break;
+      case 'd':
+        dither = 1;
+        break;
+      case 'j':
+        num_threads = atoi(optarg);
+        break;
+      case 'b':
+        benchmark = 1;
+        break;
+      default:
+        bad = 1;
+        break;
+    }
+  }
+  if (out_size < 8 || out_size > 1024 || (out_size & (out_size - 1)))
+    bad = 1;
+  if (bad || argc - optind < NUM_ARGS - benchmark) {
+    printf("Incorrect usage!\n\t./pvrconv [-s size] [-f auto|565|1555|4444] [-d] [-j threads] INPUT_FOLDER "
+           "OUTPUT_FOLDER|output.dat\n\t./pvrconv -b [-s size] [-f ...] [-d] [-j threads] INPUT_FOLDER\n");
+    return 1;
+  }
+  if (num_threads < 1)
+    num_threads = 1;
+  in_folder = argv[optind];
+  out_path = benchmark ? NULL : argv[optind + 1];
+
+  DIR *dir = opendir(in_folder);
+  if (!dir) {
+    printf("ERR: cant open %s\n", in_folder);
+    return 1;
+  }
+  struct dirent *entry;
+  while ((entry = readdir(dir)) && num_files < MAX_FILES) {
+    if (has_ext(entry->d_name, "png") || is_jpeg(entry->d_name)) {
+      strncpy(files[num_files], entry->d_name, FILENAME_MAX - 1);
+      num_files++;
+    }
+  }
+  closedir(dir);
+  qsort(files, num_files, FILENAME_MAX, cmp_name);
+  init_twiddle(out_size);
+
+  if (benchmark) {
+    for (int threads = 1;; threads *= 2) {
+      if (threads > num_threads)
+        threads = num_threads;
+      const double secs = run(threads);
+      printf("%2d threads: %d images in %.3fs, %.1f images/s\n", threads, converted, secs,
+             secs > 0 ? converted / secs : 0.0);
+      if (threads == num_threads)
+        break;
+    }
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+  }
+
+  if (out_path && has_ext(out_path, "dat")) {
+    memcpy(&file_header.magic.rich.alpha, "DAT", 3);
+    file_header.magic.rich.version = 1;
+    file_header.chunk_size = (uint32_t)pvr_file_size();
+    file_header.num_chunks = (uint32_t)num_files;
+    file_header.padding0 = 0;
+    if (sizeof(bin_header) + sizeof(bin_item_raw) * num_files > file_header.chunk_size) {
+      printf("ERR: %d images don't fit the DAT header at this size, write a folder for datpack instead\n",
+             num_files);
+      return 1;
+    }
+    data_buf = calloc(num_files, file_header.chunk_size);
+    bin_items = calloc(num_files, sizeof(bin_item_raw));
+    if (!data_buf || !bin_items)
+      return 1;
+  }
+
+  const double secs = run(num_threads);
+  if (data_buf && !failed && write_dat())
+    failed++;
+  printf("%d converted, %d failed with %d threads in %.3fs, %.1f images/s\n", converted, failed, num_threads, secs,
+         secs > 0 ? converted / secs : 0.0);
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,587 @@
+/*
+ * File: pvrenc.c
+ * Project: tools
+ * File Created: Sunday, 18th October 2026 9:12:40 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+#include <ctype.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(_WIN32) || defined(WIN32)
+#define PATH_SEP "\\"
+#else
+#define PATH_SEP "/"
+#endif
+
+/* Called:
+./pvrenc MODE INPUT_FOLDER OUTPUT_FOLDER [threads]
+
+re encodes every 16bit square .pvr in the folder, one file per thread:
+  vq           VQ, 2KB codebook and a byte per 2x2 block
+  pal8, pal4   8bpp/4bpp with a palette per texture
+  pal8s, pal4s 8bpp/4bpp all sharing one palette built from every texture
+
+Output keeps the name so the folder can go straight to datpack. Anything that
+can't be encoded is copied unchanged. Palette RAM only holds 4 8bpp palettes,
+so pal8 is only useful shared, pal4 gives every texture its own.
+*/
+
+#define NUM_ARGS (3)
+#define MAX_FILES (8192)
+#define KMEANS_PASSES (8)
+#define SHARED_SAMPLES (256 * 1024)
+
+/* 2x2 block of RGBA, stored in twiddled order like the codebook entries. Palette
+ * modes only use the first texel. */
+#define VEC_LEN (16)
+
+/* PVRT color formats */
+#define PVR_ARGB1555 (0x00)
+#define PVR_RGB565 (0x01)
+#define PVR_ARGB4444 (0x02)
+#define PVR_PAL4 (0x05)
+#define PVR_PAL8 (0x06)
+
+/* PVRT layouts */
+#define PVR_TWIDDLED (0x01)
+#define PVR_VQ (0x03)
+#define PVR_RECTANGLE (0x09)
+#define PVR_RECT_TWIDDLED (0x0D)
+#define PVR_SMALL_VQ (0x10)
+
+enum MODE { MODE_VQ, MODE_PAL8, MODE_PAL4 };
+
+typedef struct vec {
+  unsigned char c[VEC_LEN];
+} vec;
+
+typedef struct src_image {
+  int color, layout;
+  int width, height;
+  const unsigned char *gbix; /* 8 bytes or NULL */
+  const unsigned char *pixels;
+} src_image;
+
+typedef struct weighted {
+  int weight;
+  int idx;
+} weighted;
+
+static char files[MAX_FILES][FILENAME_MAX];
+static int num_files = 0;
+static const char *in_folder;
+static const char *out_folder;
+static int mode = MODE_VQ;
+static int shared = 0;
+static vec shared_palette[256];
+
+static pthread_mutex_t work_lock = PTHREAD_MUTEX_INITIALIZER;
+static int next_file = 0;
+static unsigned long long bytes_in = 0, bytes_out = 0;
+static int encoded = 0, copied = 0, failed = 0;
+
+static uint32_t twiddle(uint32_t x, uint32_t y) {
+  uint32_t out = 0;
+  for (int bit = 0; bit < 16; bit++) {
+    out |= ((y >> bit) & 1) << (bit * 2);
+    out |= ((x >> bit) & 1) << (bit * 2 + 1);
+  }
+  return out;
+}
+
+/* Must match the loader, small VQ only stores this many entries */
+static int codebook_entries(int width) {
+  if (width <= 16)
+    return 16;
+  if (width == 32)
+    return 32;
+  if (width == 64)
+    return 128;
+  return 256;
+}
+
+static void unpack_texel(int color, uint16_t px, unsigned char *rgba) {
+  switch (color) {
+  case PVR_ARGB1555:
+    rgba[0] = ((px >> 10) & 0x1F) * 255 / 31;
+    rgba[1] = ((px >> 5) & 0x1F) * 255 / 31;
+    rgba[2] = (px & 0x1F) * 255 / 31;
+    rgba[3] = (px & 0x8000) ? 255 : 0;
+    break;
+  case PVR_ARGB4444:
+    rgba[0] = ((px >> 8) & 0xF) * 17;
+    rgba[1] = ((px >> 4) & 0xF) * 17;
+    rgba[2] = (px & 0xF) * 17;
+    rgba[3] = ((px >> 12) & 0xF) * 17;
+    break;
+  default:
+    rgba[0] = ((px >> 11) & 0x1F) * 255 / 31;
+    rgba[1] = ((px >> 5) & 0x3F) * 255 / 63;
+    rgba[2] = (px & 0x1F) * 255 / 31;
+    rgba[3] = 255;
+    break;
+  }
+}
+
+static uint16_t pack_texel(int color, const unsigned char *rgba) {
+  switch (color) {
+  case PVR_ARGB1555:
+    return (uint16_t)(((rgba[3] >= 128) << 15) | (((rgba[0] * 31 + 127) / 255) << 10) |
+                      (((rgba[1] * 31 + 127) / 255) << 5) | ((rgba[2] * 31 + 127) / 255));
+  case PVR_ARGB4444:
+    return (uint16_t)((((rgba[3] + 8) / 17) << 12) | (((rgba[0] + 8) / 17) << 8) | (((rgba[1] + 8) / 17) << 4) |
+                      ((rgba[2] + 8) / 17));
+  default:
+    return (uint16_t)((((rgba[0] * 31 + 127) / 255) << 11) | (((rgba[1] * 63 + 127) / 255) << 5) |
+                      ((rgba[2] * 31 + 127) / 255));
+  }
+}
+
+/* Stops adding once it can't beat best, most candidates go after a few values */
+static int vec_dist(const vec *a, const vec *b, int dims, int best) {
+  int dist = 0;
+  for (int i = 0; i < dims; i++) {
+    const int d = (int)a->c[i] - (int)b->c[i];
+    dist += d * d;
+    if (dist >= best)
+      break;
+  }
+  return dist;
+}
+
+static int vec_nearest(const vec *v, const vec *codebook, int entries, int dims, int *out_dist) {
+  int best = 0x7FFFFFFF, best_idx = 0;
+  for (int k = 0; k < entries; k++) {
+    const int dist = vec_dist(v, &codebook[k], dims, best);
+    if (dist < best) {
+      best = dist;
+      best_idx = k;
+      if (!dist)
+        break;
+    }
+  }
+  if (out_dist)
+    *out_dist = best;
+  return best_idx;
+}
+
+static int cmp_weight(const void *a, const void *b) {
+  return ((const weighted *)a)->weight - ((const weighted *)b)->weight;
+}
+
+/* Plain k-means, seeded evenly across the vectors sorted by brightness. Empty
+ * entries are reseeded with whichever vector is currently worst off. */
+static int build_codebook(const vec *vecs, int num_vecs, int dims, vec *codebook, int entries,
+                          unsigned char *index) {
+  weighted *order = malloc(sizeof(weighted) * num_vecs);
+  long long *sums = malloc(sizeof(long long) * entries * VEC_LEN);
+  int *counts = malloc(sizeof(int) * entries);
+  if (!order || !sums || !counts) {
+    free(order);
+    free(sums);
+    free(counts);
+    return -1;
+  }
+
+  for (int i = 0; i < num_vecs; i++) {
+    order[i].idx = i;
+    order[i].weight = 0;
+    for (int c = 0; c < dims; c++)
+      order[i].weight += vecs[i].c[c];
+  }
+  qsort(order, num_vecs, sizeof(weighted), cmp_weight);
+  for (int k = 0; k < entries; k++)
+    codebook[k] = vecs[order[(int)(((long long)k * 2 + 1) * num_vecs / (entries * 2))].idx];
+
+  for (int pass = 0; pass < KMEANS_PASSES; pass++) {
+    int worst = 0, worst_dist = -1, changed = 0;
+    memset(sums, 0, sizeof(long long) * entries * VEC_LEN);
+    memset(counts, 0, sizeof(int) * entries);
+
+    for (int i = 0; i < num_vecs; i++) {
+      int dist;
+      const int k = vec_nearest(&vecs[i], codebook, entries, dims, &dist);
+      if (pass == 0 || index[i] != k)
+        changed++;
+      index[i] = (unsigned char)k;
+      counts[k]++;
+      for (int c = 0; c < dims; c++)
+        sums[k * VEC_LEN + c] += vecs[i].c[c];
+      if (dist > worst_dist) {
+        worst_dist = dist;
+        worst = i;
+      }
+    }
+    if (!changed)
+      break;
+
+    for (int k = 0; k < entries; k++) {
+      if (!counts[k]) {
+        codebook[k] = vecs[worst];
+        continue;
+      }
+      for (int c = 0; c < dims; c++)
+        codebook[k].c[c] = (unsigned char)((sums[k * VEC_LEN + c] + counts[k] / 2) / counts[k]);
+    }
+  }
+
+  /* Final assignment against the last codebook */
+  for (int i = 0; i < num_vecs; i++)
+    index[i] = (unsigned char)vec_nearest(&vecs[i], codebook, entries, dims, NULL);
+
+  free(order);
+  free(sums);
+  free(counts);
+  return 0;
+}
+
+static int write_file(const char *name, const unsigned char *data, size_t size) {
+  char path[FILENAME_MAX];
+  snprintf(path, sizeof(path), "%s%s%s", out_folder, PATH_SEP, name);
+  FILE *fd = fopen(path, "wb");
+  if (!fd) {
+    printf("ERR: cant write %s\n", path);
+    return -1;
+  }
+  fwrite(data, size, 1, fd);
+  fclose(fd);
+  return 0;
+}
+
+static unsigned char *read_file(const char *name, size_t *size) {
+  char path[FILENAME_MAX];
+  snprintf(path, sizeof(path), "%s%s%s", in_folder, PATH_SEP, name);
+  FILE *fd = fopen(path, "rb");
+  if (!fd) {
+    printf("ERR: cant read %s\n", path);
+    return NULL;
+  }
+  fseek(fd, 0, SEEK_END);
+  *size = (size_t)ftell(fd);
+  fseek(fd, 0, SEEK_SET);
+  unsigned char *data = malloc(*size);
+  if (!data || fread(data, *size, 1, fd) != 1) {
+    printf("ERR: cant read %s\n", path);
+    free(data);
+    data = NULL;
+  }
+  fclose(fd);
+  return data;
+}
+
+static void put_u16(unsigned char *dst, uint16_t v) {
+  dst[0] = v & 0xFF;
+  dst[1] = v >> 8;
+}
+
+static void put_u32(unsigned char *dst, uint32_t v) {
+  put_u16(dst, v & 0xFFFF);
+  put_u16(dst + 2, v >> 16);
+}
+
+/* Only square power of two 16bit textures, 0 if it can't be encoded */
+static int parse_image(const unsigned char *in, size_t in_size, src_image *img) {
+  size_t pvrt = 0;
+  img->gbix = NULL;
+  if (in_size >= 16 && !memcmp(in, "GBIX", 4)) {
+    pvrt = 8 + (in[4] | in[5] << 8 | in[6] << 16 | (uint32_t)in[7] << 24);
+    img->gbix = (pvrt == 16) ? in + 8 : NULL;
+  }
+  if (in_size < pvrt + 16 || memcmp(in + pvrt, "PVRT", 4))
+    return 0;
+
+  img->color = in[pvrt + 8];
+  img->layout = in[pvrt + 9];
+  img->width = in[pvrt + 12] | in[pvrt + 13] << 8;
+  img->height = in[pvrt + 14] | in[pvrt + 15] << 8;
+  img->pixels = in + pvrt + 16;
+
+  if (img->color > PVR_ARGB4444 || img->width != img->height || img->width < 8 || (img->width & (img->width - 1)))
+    return 0;
+  if (img->layout != PVR_TWIDDLED && img->layout != PVR_RECT_TWIDDLED && img->layout != PVR_RECTANGLE)
+    return 0;
+  return in_size >= pvrt + 16 + (size_t)img->width * img->height * 2;
+}
+
+static void read_texel(const src_image *img, int x, int y, unsigned char *rgba) {
+  const size_t at = (img->layout == PVR_RECTANGLE) ? (size_t)y * img->width + x : twiddle(x, y);
+  unpack_texel(img->color, img->pixels[at * 2] | img->pixels[at * 2 + 1] << 8, rgba);
+}
+
+/* GBIX and PVRT headers for data_size bytes of texture data */
+static void write_header(unsigned char *dst, const src_image *img, int color, int layout, size_t data_size) {
+  memcpy(dst, "GBIX", 4);
+  put_u32(dst + 4, 8);
+  if (img->gbix)
+    memcpy(dst + 8, img->gbix, 8);
+  memcpy(dst + 16, "PVRT", 4);
+  put_u32(dst + 20, (uint32_t)(8 + data_size));
+  dst[24] = (unsigned char)color;
+  dst[25] = (unsigned char)layout;
+  put_u16(dst + 28, (uint16_t)img->width);
+  put_u16(dst + 30, (uint16_t)img->height);
+}
+
+/* Returns the size of the VQ file in out, 0 on failure */
+static size_t encode_vq(const src_image *img, unsigned char **out) {
+  const int blocks = img->width / 2;
+  const int num_vecs = blocks * blocks;
+  const int entries = codebook_entries(img->width);
+  vec *vecs = malloc(sizeof(vec) * num_vecs);
+  vec *codebook = malloc(sizeof(vec) * entries);
+  unsigned char *index = malloc(num_vecs);
+  size_t out_size = 0;
+
+  if (vecs && codebook && index) {
+    for (int by = 0; by < blocks; by++)
+      for (int bx = 0; bx < blocks; bx++)
+        for (int t = 0; t < 4; t++) /* twiddled order within the block: y is the low bit */
+          read_texel(img, bx * 2 + (t >> 1), by * 2 + (t & 1), &vecs[by * blocks + bx].c[t * 4]);
+  }
+
+  if (vecs && codebook && index && !build_codebook(vecs, num_vecs, VEC_LEN, codebook, entries, index)) {
+    const size_t data_size = (size_t)entries * 8 + num_vecs;
+    *out = calloc(1, 32 + data_size);
+    if (*out) {
+      out_size = 32 + data_size;
+      write_header(*out, img, img->color, (entries == 256) ? PVR_VQ : PVR_SMALL_VQ, data_size);
+
+      unsigned char *cb = *out + 32;
+      for (int k = 0; k < entries; k++)
+        for (int t = 0; t < 4; t++)
+          put_u16(cb + (k * 4 + t) * 2, pack_texel(img->color, &codebook[k].c[t * 4]));
+
+      unsigned char *idx = cb + entries * 8;
+      for (int by = 0; by < blocks; by++)
+        for (int bx = 0; bx < blocks; bx++)
+          idx[twiddle(bx, by)] = index[by * blocks + bx];
+    }
+  }
+
+  free(vecs);
+  free(codebook);
+  free(index);
+  return out_size;
+}
+
+/* Twiddled 8bpp or 4bpp (low nibble first) indices, then "PVPL", u32 size,
+ * u16 format (0 is ARGB1555), u16 count and the ARGB1555 entries */
+static size_t encode_pal(const src_image *img, unsigned char **out) {
+  const int bits = (mode == MODE_PAL8) ? 8 : 4;
+  const int entries = 1 << bits;
+  const int num_vecs = img->width * img->height;
+  vec *vecs = malloc(sizeof(vec) * num_vecs);
+  vec palette[256];
+  unsigned char *index = malloc(num_vecs);
+  size_t out_size = 0;
+  int ok = 0;
+
+  if (vecs && index) {
+    for (int y = 0; y < img->height; y++)
+      for (int x = 0; x < img->width; x++)
+        read_texel(img, x, y, vecs[y * img->width + x].c);
+
+    if (shared) {
+      memcpy(palette, shared_palette, sizeof(palette));
+      for (int i = 0; i < num_vecs; i++)
+        index[i] = (unsigned char)vec_nearest(&vecs[i], palette, entries, 4, NULL);
+      ok = 1;
+    } else {
+      ok = !build_codebook(vecs, num_vecs, 4, palette, entries, index);
+    }
+  }
+
+  if (ok) {
+    const size_t data_size = (size_t)num_vecs * bits / 8;
+    const size_t pal_size = 12 + (size_t)entries * 2;
+    *out = calloc(1, 32 + data_size + pal_size);
+    if (*out) {
+      out_size = 32 + data_size + pal_size;
+      write_header(*out, img, (bits == 8) ? PVR_PAL8 : PVR_PAL4, PVR_TWIDDLED, data_size);
+
+      unsigned char *dst = *out + 32;
+      for (int y = 0; y < img->height; y++) {
+        for (int x = 0; x < img->width; x++) {
+          const uint32_t at = twiddle(x, y);
+          const unsigned char value = index[y * img->width + x];
+          if (bits == 8)
+            dst[at] = value;
+          else
+            dst[at / 2] |= (at & 1) ? value << 4 : value;
+        }
+      }
+
+      unsigned char *pal = dst + data_size;
+      memcpy(pal, "PVPL", 4);
+      put_u32(pal + 4, (uint32_t)(pal_size - 8));
+      put_u16(pal + 8, 0);
+      put_u16(pal + 10, (uint16_t)entries);
+      for (int k = 0; k < entries; k++)
+        put_u16(pal + 12 + k * 2, pack_texel(PVR_ARGB1555, palette[k].c));
+    }
+  }
+
+  free(vecs);
+  free(index);
+  return out_size;
+}
+
+/* One palette for everything, from texels sampled evenly over every input */
+static int build_shared_palette(void) {
+  vec *samples = malloc(sizeof(vec) * SHARED_SAMPLES);
+  unsigned char *index = malloc(SHARED_SAMPLES);
+  int num_samples = 0;
+  const int per_file = num_files ? SHARED_SAMPLES / num_files : 0;
+
+  if (!samples || !index || !per_file) {
+    free(samples);
+    free(index);
+    return -1;
+  }
+  for (int f = 0; f < num_files; f++) {
+    size_t size;
+    src_image img;
+    unsigned char *in = read_file(files[f], &size);
+    if (in && parse_image(in, size, &img)) {
+      const int texels = img.width * img.height;
+      const int step = (texels > per_file) ? texels / per_file : 1;
+      for (int t = 0; t < texels && num_samples < SHARED_SAMPLES; t += step)
+        read_texel(&img, t % img.width, t / img.width, samples[num_samples++].c);
+    }
+    free(in);
+  }
+
+  const int ret = num_samples ? build_codebook(samples, num_samples, 4, shared_palette,
+                                               (mode == MODE_PAL8) ? 256 : 16, index)
+                              : -1;
+  printf("Shared palette from %d texels\n", num_samples);
+  free(samples);
+  free(index);
+  return ret;
+}
+
+static void process_file(const char *name) {
+  size_t in_size = 0;
+  unsigned char *in = read_file(name, &in_size);
+  if (!in) {
+    pthread_mutex_lock(&work_lock);
+    failed++;
+    pthread_mutex_unlock(&work_lock);
+    return;
+  }
+
+  unsigned char *out = NULL;
+  size_t out_size = 0;
+  src_image img;
+  if (parse_image(in, in_size, &img))
+    out_size = (mode == MODE_VQ) ? encode_vq(&img, &out) : encode_pal(&img, &out);
+
+  int ok;
+  if (out_size) {
+    ok = !write_file(name, out, out_size);
+  } else {
+    printf("Skipped %s, not a square 16bit texture\n", name);
+    out_size = in_size;
+    ok = !write_file(name, in, in_size);
+  }
+
+  pthread_mutex_lock(&work_lock);
+  if (!ok) {
+    failed++;
+  } else if (out) {
+    encoded++;
+    printf("Encoded %s %zu -> %zu bytes\n", name, in_size, out_size);
+  } else {
+    copied++;
+  }
+  bytes_in += in_size;
+  bytes_out += out_size;
+  pthread_mutex_unlock(&work_lock);
+
+  free(in);
+  free(out);
+}
+
+static void *worker(void *user) {
+  (void)user;
+  for (;;) {
+    pthread_mutex_lock(&work_lock);
+    const int file = next_file < num_files ? next_file++ : -1;
+    pthread_mutex_unlock(&work_lock);
+    if (file == -1)
+      return NULL;
+    process_file(files[file]);
+  }
+}
+
+static int has_pvr_ext(const char *name) {
+  const char *dot = strrchr(name, '.');
+  return dot && tolower(dot[1]) == 'p' && tolower(dot[2]) == 'v' && tolower(dot[3]) == 'r' && !dot[4];
+}
+
+static int parse_mode(const char *arg) {
+  if (!strcmp(arg, "vq"))
+    mode = MODE_VQ;
+  else if (!strncmp(arg, "pal8", 4))
+    mode = MODE_PAL8;
+  else if (!strncmp(arg, "pal4", 4))
+    mode = MODE_PAL4;
+  else
+    return -1;
+  shared = (mode != MODE_VQ && arg[4] == 's');
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  if (argc < NUM_ARGS + 1 /*binary itself*/ || parse_mode(argv[1])) {
+    printf("Incorrect usage!\n\t./pvrenc vq|pal8|pal4|pal8s|pal4s INPUT_FOLDER OUTPUT_FOLDER [threads]\n");
+    return 1;
+  }
+  in_folder = argv[2];
+  out_folder = argv[3];
+
+  int num_threads = (argc > 4) ? atoi(argv[4]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+  if (num_threads < 1)
+    num_threads = 1;
+
+  DIR *dir = opendir(in_folder);
+  if (!dir) {
+    printf("ERR: cant open %s\n", in_folder);
+    return 1;
+  }
+  struct dirent *entry;
+  while ((entry = readdir(dir)) && num_files < MAX_FILES) {
+    if (has_pvr_ext(entry->d_name)) {
+      strncpy(files[num_files], entry->d_name, FILENAME_MAX - 1);
+      num_files++;
+    }
+  }
+  closedir(dir);
+
+  if (shared && build_shared_palette()) {
+    printf("ERR: no usable textures for a shared palette\n");
+    return 1;
+  }
+
+  pthread_t *threads = malloc(sizeof(pthread_t) * num_threads);
+  if (!threads)
+    return 1;
+  for (int i = 0; i < num_threads; i++)
+    pthread_create(&threads[i], NULL, worker, NULL);
+  for (int i = 0; i < num_threads; i++)
+    pthread_join(threads[i], NULL);
+  free(threads);
+
+  printf("%d encoded, %d copied, %d failed with %d threads, %llu -> %llu bytes\n", encoded, copied, failed,
+         num_threads, bytes_in, bytes_out);
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,313 @@
+/*
+ * File: remapgen.c
+ * Project: tools
+ * File Created: Sunday, 18th October 2026 10:31:05 am
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <texture/serial_remap.h>
+
+/* Called:
+./remapgen serial_remap.tsv serial_remap_table.h
+
+reads ip_serial<TAB>ART|META|BOTH<TAB>target[<TAB>comment] lines and writes a
+collision free (hash and displace) table for serial_sanitize.c
+*/
+
+#define NUM_ARGS (2)
+#define MAX_LINE (512)
+#define MAX_ENTRIES (2048)
+#define MAX_DISP (0xFFFF)
+
+typedef struct remap_entry {
+  char ip_serial[12];
+  char target[12];
+  char comment[128];
+  int type;
+  uint32_t h1, h2;
+} remap_entry;
+
+static remap_entry entries[MAX_ENTRIES];
+static int num_entries = 0;
+
+static uint32_t next_pow2(uint32_t v) {
+  uint32_t p = 1;
+  while (p < v)
+    p <<= 1;
+  return p;
+}
+
+static void strip_eol(char *str) {
+  size_t len = strlen(str);
+  while (len && (str[len - 1] == '\n' || str[len - 1] == '\r')) {
+    str[--len] = '\0';
+  }
+}
+
+/* Splits off the next tab separated field, NULL once the line is used up */
+static char *next_field(char **cursor) {
+  char *field = *cursor;
+  if (!field)
+    return NULL;
+  char *tab = strchr(field, '\t');
+  if (tab) {
+    *tab = '\0';
+    *cursor = tab + 1;
+  } else {
+    *cursor = NULL;
+  }
+  return field;
+}
+
+static int parse_type(const char *type) {
+  if (!strcmp(type, "ART"))
+    return REMAP_ART;
+  if (!strcmp(type, "META"))
+    return REMAP_META;
+  if (!strcmp(type, "BOTH"))
+    return REMAP_ART | REMAP_META;
+  return REMAP_NONE;
+}
+
+static int read_tsv(const char *filename) {
+  FILE *fd = fopen(filename, "r");
+  if (!fd) {
+    printf("Error: Couldn't open %s!\n", filename);
+    return 1;
+  }
+
+  char line[MAX_LINE];
+  int line_num = 0;
+  while (fgets(line, sizeof(line), fd)) {
+    line_num++;
+    strip_eol(line);
+    if (line[0] == '\0' || line[0] == '#')
+      continue;
+
+    char *cursor = line;
+    const char *ip = next_field(&cursor);
+    const char *type = next_field(&cursor);
+    const char *target = next_field(&cursor);
+    const char *comment = cursor;
+
+    if (!ip || !type || !target) {
+      printf("%s:%d: expected 3 columns\n", filename, line_num);
+      fclose(fd);
+      return 1;
+    }
+    if (strlen(ip) > 11 || strlen(target) > 11) {
+      printf("%s:%d: serial longer than 11 characters\n", filename, line_num);
+      fclose(fd);
+      return 1;
+    }
+    if (parse_type(type) == REMAP_NONE) {
+      printf("%s:%d: unknown remap type '%s'\n", filename, line_num, type);
+      fclose(fd);
+      return 1;
+    }
+    for (int i = 0; i < num_entries; i++) {
+      if (!strcmp(entries[i].ip_serial, ip)) {
+        printf("%s:%d: duplicate serial %s\n", filename, line_num, ip);
+        fclose(fd);
+        return 1;
+      }
+    }
+    if (num_entries == MAX_ENTRIES) {
+      printf("%s:%d: too many entries\n", filename, line_num);
+      fclose(fd);
+      return 1;
+    }
+
+    remap_entry *entry = &entries[num_entries++];
+    strcpy(entry->ip_serial, ip);
+    strcpy(entry->target, target);
+    snprintf(entry->comment, sizeof(entry->comment), "%s", comment ? comment : "");
+    entry->type = parse_type(type);
+    product_key key;
+    product_key_make(&key, entry->ip_serial);
+    serial_remap_hash(&key, &entry->h1, &entry->h2);
+  }
+
+  fclose(fd);
+  return 0;
+}
+
+/* Biggest buckets first, each gets the first displacement that lands all of its
+ * keys in free slots */
+static int *bucket_order_size;
+static int cmp_bucket(const void *a, const void *b) {
+  return bucket_order_size[*(const int *)b] - bucket_order_size[*(const int *)a];
+}
+
+static int build_table(uint32_t num_buckets, uint32_t num_slots, uint16_t *disp, int *slot_entry) {
+  int *bucket_size = calloc(num_buckets, sizeof(int));
+  int *order = malloc(num_buckets * sizeof(int));
+  uint32_t *tried = malloc(num_slots * sizeof(uint32_t));
+  if (!bucket_size || !order || !tried) {
+    printf("%s no free memory\n", __func__);
+    return 1;
+  }
+
+  for (int i = 0; i < num_entries; i++) {
+    bucket_size[serial_remap_bucket(entries[i].h2, num_buckets)]++;
+  }
+  for (uint32_t b = 0; b < num_buckets; b++) {
+    order[b] = b;
+    disp[b] = 0;
+  }
+  bucket_order_size = bucket_size;
+  qsort(order, num_buckets, sizeof(int), cmp_bucket);
+
+  for (uint32_t s = 0; s < num_slots; s++) {
+    slot_entry[s] = -1;
+  }
+
+  int ret = 0;
+  for (uint32_t o = 0; o < num_buckets && bucket_size[order[o]]; o++) {
+    uint32_t b = order[o];
+    uint32_t d;
+    for (d = 0; d <= MAX_DISP; d++) {
+      int ok = 1;
+      memset(tried, 0, num_slots * sizeof(uint32_t));
+      for (int i = 0; i < num_entries && ok; i++) {
+        if (serial_remap_bucket(entries[i].h2, num_buckets) != b)
+          continue;
+        uint32_t s = serial_remap_slot(entries[i].h1, entries[i].h2, d, num_slots);
+        if (slot_entry[s] != -1 || tried[s])
+          ok = 0;
+        tried[s] = 1;
+      }
+      if (ok)
+        break;
+    }
+    if (d > MAX_DISP) {
+      ret = 1;
+      break;
+    }
+
+    disp[b] = (uint16_t)d;
+    for (int i = 0; i < num_entries; i++) {
+      if (serial_remap_bucket(entries[i].h2, num_buckets) == b) {
+        slot_entry[serial_remap_slot(entries[i].h1, entries[i].h2, d, num_slots)] = i;
+      }
+    }
+  }
+
+  free(bucket_size);
+  free(order);
+  free(tried);
+  return ret;
+}
+
+static void write_serial(FILE *fd, const char *serial) {
+  if (serial)
+    fprintf(fd, "{.str = \"%s\"}", serial);
+  else
+    fprintf(fd, "{{0}}");
+}
+
+static int write_header(const char *filename, const char *source, uint32_t num_buckets, uint32_t num_slots, const uint16_t *disp, const int *slot_entry) {
+  FILE *fd = fopen(filename, "w");
+  if (!fd) {
+    printf("Error: Couldn't write %s!\n", filename);
+    return 1;
+  }
+
+  const char *source_name = strrchr(source, '/');
+  source_name = source_name ? source_name + 1 : source;
+
+  fprintf(fd, "/* Generated by remapgen from %s, do not edit by hand */\n\n", source_name);
+  fprintf(fd, "#pragma once\n\n");
+  fprintf(fd, "#include <stdint.h>\n\n");
+  fprintf(fd, "#include \"texture/serial_remap.h\"\n\n");
+  fprintf(fd, "#define SERIAL_REMAP_COUNT (%d)\n", num_entries);
+  fprintf(fd, "#define SERIAL_REMAP_BUCKETS (%u)\n", num_buckets);
+  fprintf(fd, "#define SERIAL_REMAP_SLOTS (%u)\n\n", num_slots);
+
+  fprintf(fd, "static const uint16_t serial_remap_disp[SERIAL_REMAP_BUCKETS] = {");
+  for (uint32_t b = 0; b < num_buckets; b++) {
+    fprintf(fd, "%s%u,", (b % 16) ? " " : "\n    ", disp[b]);
+  }
+  fprintf(fd, "\n};\n\n");
+
+  fprintf(fd, "static const serial_remap serial_remap_table[SERIAL_REMAP_SLOTS] = {\n");
+  for (uint32_t s = 0; s < num_slots; s++) {
+    if (slot_entry[s] == -1)
+      continue;
+    const remap_entry *entry = &entries[slot_entry[s]];
+    fprintf(fd, "    [%u] = {", s);
+    write_serial(fd, entry->ip_serial);
+    fprintf(fd, ", ");
+    write_serial(fd, (entry->type & REMAP_ART) ? entry->target : NULL);
+    fprintf(fd, ", ");
+    write_serial(fd, (entry->type & REMAP_META) ? entry->target : NULL);
+    switch (entry->type) {
+      case REMAP_ART:
+        fprintf(fd, ", REMAP_ART},");
+        break;
+      case REMAP_META:
+        fprintf(fd, ", REMAP_META},");
+        break;
+      default:
+        fprintf(fd, ", REMAP_ART | REMAP_META},");
+        break;
+    }
+    if (entry->comment[0])
+      fprintf(fd, " /* %s */", entry->comment);
+    fprintf(fd, "\n");
+  }
+  fprintf(fd, "};\n");
+
+  fclose(fd);
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  if (argc < NUM_ARGS + 1) {
+    printf("%s serial_remap.tsv serial_remap_table.h\n", argv[0]);
+    return 1;
+  }
+
+  if (read_tsv(argv[1])) {
+    return 1;
+  }
+  if (!num_entries) {
+    printf("Error: no remaps in %s\n", argv[1]);
+    return 1;
+  }
+
+  /* ~4 keys per bucket, load factor at or below 0.8 */
+  uint32_t num_buckets = next_pow2((num_entries + 3) / 4);
+  uint32_t num_slots = next_pow2(num_entries + num_entries / 4);
+  uint16_t *disp = malloc(num_buckets * sizeof(uint16_t));
+  int *slot_entry = malloc(num_slots * sizeof(int));
+  if (!disp || !slot_entry) {
+    printf("%s no free memory\n", __func__);
+    return 1;
+  }
+
+  /* Grow the table until every bucket finds a displacement */
+  while (build_table(num_buckets, num_slots, disp, slot_entry)) {
+    num_slots <<= 1;
+    slot_entry = realloc(slot_entry, num_slots * sizeof(int));
+    if (!slot_entry) {
+      printf("%s no free memory\n", __func__);
+      return 1;
+    }
+  }
+
+  int ret = write_header(argv[2], argv[1], num_buckets, num_slots, disp, slot_entry);
+  if (!ret) {
+    printf("Wrote %d remaps to %s (%u buckets, %u slots)\n", num_entries, argv[2], num_buckets, num_slots);
+  }
+
+  free(disp);
+  free(slot_entry);
+  return ret;
+}
@@ -0,0 +1,354 @@
+/*
+ * File: streamcheck.c
+ * Project: tools
+ * File Created: Sunday, 18th October 2026 10:32:44 pm
+ * Author: Hayden Kowalchuk
+ * -----
+ * Copyright (c) 2021 Hayden Kowalchuk, Hayden Kowalchuk
+ * License: BSD 3-clause "New" or "Revised" License, http://www.opensource.org/licenses/BSD-3-Clause
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <dc/pvr.h>
+#include <kos/fs.h>
+
+#include "pvr_texture.h"
+
+/* Called:
+./streamcheck
+
+packs a set of PVRs into a DAT laid out like datpack does, then streams each
+one through pvr_stream with stand-ins for fs_* and pvr_txr_load. Checks the
+bytes that land in "vram" match a whole file load, and that reads are block
+sized, block aligned and uploads suit the store queues.
+*/
+
+#define CHECK_DAT "streamcheck.dat"
+#define HDR_SIZE (0x20)
+#define FULL_CODEBOOK (2048)
+#define VRAM_SIZE (4 * 1024 * 1024)
+#define MAX_READS (1024)
+#define PAGE_SIZE (512)
+
+typedef struct test_case {
+  const char *name;
+  int color, layout;
+  int width, height;
+  int palette; /* entries, 0 if none */
+  int gbix;
+} test_case;
+
+static const test_case cases[] = {
+    {"1555 twiddled 128", 0x00, 0x01, 128, 128, 0, 1},
+    {"565 rect 64x32", 0x01, 0x09, 64, 32, 0, 1},
+    {"4444 twiddled 512x256", 0x02, 0x0D, 512, 256, 0, 1},
+    {"VQ 256", 0x01, 0x03, 256, 256, 0, 1},
+    {"small VQ 32", 0x01, 0x10, 32, 32, 0, 1},
+    {"pal4 64", 0x05, 0x01, 64, 64, 16, 1},
+    {"pal8 128", 0x06, 0x01, 128, 128, 256, 1},
+    {"565 no GBIX 128", 0x01, 0x01, 128, 128, 0, 0},
+    {"1555 twiddled 64", 0x00, 0x01, 64, 64, 0, 1},
+    {"565 rect 64", 0x01, 0x09, 64, 64, 0, 1},
+};
+#define NUM_CASES ((int)(sizeof(cases) / sizeof(cases[0])))
+#define PAGE_TWIDDLED (8)
+#define PAGE_RECT (9)
+
+/* Stand-in vram, pvr_mem_malloc hands it out in order */
+static _Alignas(32) unsigned char vram[VRAM_SIZE];
+static size_t vram_top = 0;
+static int bad_uploads = 0;
+
+/* Stand-in files, every read is logged */
+static FILE *files[4];
+static struct {
+  long pos;
+  size_t len;
+} reads[MAX_READS];
+static int num_reads = 0;
+
+pvr_ptr_t pvr_mem_malloc(size_t size) {
+  void *ptr = vram + vram_top;
+  vram_top += (size + 31) & ~(size_t)31;
+  if (vram_top > VRAM_SIZE) {
+    printf("ERR: out of vram\n");
+    exit(1);
+  }
+  return ptr;
+}
+
+void pvr_mem_free(pvr_ptr_t ptr) { (void)ptr; }
+
+void pvr_txr_load(const void *src, pvr_ptr_t dst, uint32_t count) {
+  /* Store queues write 32 bytes at a time */
+  if (((unsigned char *)dst - vram) & 31 || (uintptr_t)src & 3 || count & 31) {
+    bad_uploads++;
+  }
+  memcpy(dst, src, count);
+}
+
+file_t fs_open(const char *path, int mode) {
+  (void)mode;
+  for (int i = 0; i < 4; i++) {
+    if (!files[i]) {
+      files[i] = fopen(path, "rb");
+      return files[i] ? i : -1;
+    }
+  }
+  return -1;
+}
+
+int fs_close(file_t fd) {
+  fclose(files[fd]);
+  files[fd] = NULL;
+  return 0;
+}
+
+ssize_t fs_read(file_t fd, void *buf, size_t len) {
+  if (num_reads < MAX_READS) {
+    reads[num_reads].pos = ftell(files[fd]);
+    reads[num_reads].len = len;
+    num_reads++;
+  }
+  return (ssize_t)fread(buf, 1, len, files[fd]);
+}
+
+off_t fs_seek(file_t fd, off_t pos, int whence) {
+  fseek(files[fd], pos, whence);
+  return ftell(files[fd]);
+}
+
+off_t fs_tell(file_t fd) { return ftell(files[fd]); }
+
+size_t fs_total(file_t fd) {
+  const long pos = ftell(files[fd]);
+  fseek(files[fd], 0, SEEK_END);
+  const long total = ftell(files[fd]);
+  fseek(files[fd], pos, SEEK_SET);
+  return (size_t)total;
+}
+
+static uint32_t twiddle(uint32_t x, uint32_t y) {
+  uint32_t out = 0;
+  for (int bit = 0; bit < 16; bit++) {
+    out |= ((y >> bit) & 1) << (bit * 2);
+    out |= ((x >> bit) & 1) << (bit * 2 + 1);
+  }
+  return out;
+}
+
+static void put_u16(unsigned char *dst, uint16_t v) {
+  dst[0] = v & 0xFF;
+  dst[1] = v >> 8;
+}
+
+static void put_u32(unsigned char *dst, uint32_t v) {
+  put_u16(dst, v & 0xFFFF);
+  put_u16(dst + 2, v >> 16);
+}
+
+/* Texture bytes stored in the file */
+static uint32_t data_size(const test_case *tc) {
+  const uint32_t texels = (uint32_t)(tc->width * tc->height);
+  if (tc->layout == 0x03) {
+    return FULL_CODEBOOK + texels / 4;
+  }
+  if (tc->layout == 0x10) {
+    const uint32_t codebook = tc->width <= 16 ? 128 : tc->width == 32 ? 256 : tc->width == 64 ? 1024 : FULL_CODEBOOK;
+    return codebook + texels / 4;
+  }
+  return texels * (tc->color == 0x05 ? 4 : tc->color == 0x06 ? 8 : 16) / 8;
+}
+
+/* Whole file for the case, size set to its length */
+static unsigned char *make_pvr(const test_case *tc, int seed, uint32_t *size) {
+  const uint32_t data = data_size(tc);
+  const uint32_t trailer = tc->palette ? 12 + tc->palette * 2 : 0;
+  const uint32_t hdr = tc->gbix ? HDR_SIZE : HDR_SIZE / 2;
+  unsigned char *out = calloc(1, hdr + data + trailer);
+  unsigned char *pvrt = out + hdr - HDR_SIZE / 2;
+
+  if (tc->gbix) {
+    memcpy(out, "GBIX", 4);
+    put_u32(out + 4, 8);
+  }
+  memcpy(pvrt, "PVRT", 4);
+  put_u32(pvrt + 4, 8 + data);
+  pvrt[8] = (unsigned char)tc->color;
+  pvrt[9] = (unsigned char)tc->layout;
+  put_u16(pvrt + 12, (uint16_t)tc->width);
+  put_u16(pvrt + 14, (uint16_t)tc->height);
+
+  srand((unsigned int)seed);
+  for (uint32_t i = 0; i < data + trailer; i++) {
+    out[hdr + i] = (unsigned char)rand();
+  }
+  if (tc->palette) {
+    unsigned char *pal = out + hdr + data;
+    memcpy(pal, "PVPL", 4);
+    put_u32(pal + 4, 4 + tc->palette * 2);
+    put_u16(pal + 8, 0);
+    put_u16(pal + 10, (uint16_t)tc->palette);
+  }
+  *size = hdr + data + trailer;
+  return out;
+}
+
+/* Same layout as datpack, chunk 0 holds the header and every file gets one chunk */
+static uint32_t write_dat(unsigned char **pvrs, uint32_t *sizes) {
+  uint32_t chunk_size = 0;
+  for (int i = 0; i < NUM_CASES; i++) {
+    if (sizes[i] > chunk_size) {
+      chunk_size = sizes[i];
+    }
+  }
+  chunk_size = (chunk_size + 2047) & ~2047u;
+
+  FILE *fd = fopen(CHECK_DAT, "wb");
+  unsigned char *chunk = calloc(1, chunk_size);
+  memcpy(chunk, "DAT1", 4);
+  fwrite(chunk, chunk_size, 1, fd);
+  for (int i = 0; i < NUM_CASES; i++) {
+    memset(chunk, '\0', chunk_size);
+    memcpy(chunk, pvrs[i], sizes[i]);
+    fwrite(chunk, chunk_size, 1, fd);
+  }
+  fclose(fd);
+  free(chunk);
+  return chunk_size;
+}
+
+/* Data reads after the first have to start on a block boundary of the chunk */
+static int check_reads(int first, uint32_t start, int gbix) {
+  for (int i = first; i < num_reads; i++) {
+    if (reads[i].len > PVR_STREAM_BLOCK_SIZE) {
+      printf("  read of %zu bytes is over a block\n", reads[i].len);
+      return 1;
+    }
+  }
+  for (int i = first + 1; gbix && i < num_reads; i++) {
+    if ((reads[i].pos - (long)start) % PVR_STREAM_BLOCK_SIZE) {
+      printf("  read at %ld is off a block boundary\n", reads[i].pos - (long)start);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static int check_buffer(const test_case *tc, const unsigned char *pvr, file_t fd, uint32_t start, uint32_t chunk_size) {
+  unsigned char whole[HDR_SIZE + 512 * 256 * 2 + 1024];
+  uint32_t w, h, format;
+  pvr_stream stream;
+  pvr_stream_dest dest;
+
+  /* Reference is the old path, the whole file in RAM with a full size header */
+  memset(whole, '\0', sizeof(whole));
+  memcpy(whole + (tc->gbix ? 0 : HDR_SIZE / 2), pvr, (tc->gbix ? HDR_SIZE : HDR_SIZE / 2) + data_size(tc));
+  const uint32_t size = pvr_get_texture_size(whole, &w, &h, &format);
+  unsigned char *expect = pvr_mem_malloc(size);
+  unsigned char *got = pvr_mem_malloc(size);
+  load_pvr_from_buffer_to_buffer(whole, &w, &h, &format, expect);
+
+  if (!pvr_stream_open(&stream, fd, start, chunk_size)) {
+    printf("  didn't open\n");
+    return 1;
+  }
+  if (stream.width != w || stream.height != h || stream.format != format || stream.size != size) {
+    printf("  header differs\n");
+    return 1;
+  }
+  if (stream.palette_count != tc->palette
+      || memcmp(stream.palette, pvr + HDR_SIZE + data_size(tc) + 12, tc->palette * 2)) {
+    printf("  palette differs\n");
+    return 1;
+  }
+
+  const int first = num_reads;
+  void *block = aligned_alloc(32, PVR_STREAM_BLOCK_SIZE);
+  pvr_stream_dest_buffer(&stream, got, &dest);
+  const int complete = pvr_stream_load(&stream, &dest, block);
+  free(block);
+  if (!complete || memcmp(expect, got, size)) {
+    printf("  vram differs\n");
+    return 1;
+  }
+  return check_reads(first, start, tc->gbix);
+}
+
+static int check_page(const test_case *tc, file_t fd, uint32_t start, uint32_t chunk_size, const unsigned char *pvr) {
+  const uint32_t x = 64, y = 128;
+  const unsigned char *texels = pvr + HDR_SIZE;
+  unsigned char *page = pvr_mem_malloc(PAGE_SIZE * PAGE_SIZE * 2);
+  pvr_stream stream;
+  pvr_stream_dest dest;
+
+  memset(page, '\0', PAGE_SIZE * PAGE_SIZE * 2);
+  if (!pvr_stream_open(&stream, fd, start, chunk_size) || !pvr_stream_dest_page(&stream, page, PAGE_SIZE, x, y, &dest)) {
+    printf("  no page destination\n");
+    return 1;
+  }
+  const int first = num_reads;
+  void *block = aligned_alloc(32, PVR_STREAM_BLOCK_SIZE);
+  const int complete = pvr_stream_load(&stream, &dest, block);
+  free(block);
+  if (!complete) {
+    printf("  didn't complete\n");
+    return 1;
+  }
+
+  const int twiddled = tc->layout != 0x09;
+  for (int ty = 0; ty < tc->height; ty++) {
+    for (int tx = 0; tx < tc->width; tx++) {
+      const uint32_t src = twiddled ? twiddle(tx, ty) : (uint32_t)(ty * tc->width + tx);
+      const uint32_t dst = twiddled ? twiddle(x + tx, y + ty) : (y + ty) * PAGE_SIZE + x + tx;
+      if (memcmp(page + dst * 2, texels + src * 2, 2)) {
+        printf("  texel %d,%d differs\n", tx, ty);
+        return 1;
+      }
+    }
+  }
+  return check_reads(first, start, tc->gbix);
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  unsigned char *pvrs[NUM_CASES];
+  uint32_t sizes[NUM_CASES];
+  int failed = 0;
+
+  for (int i = 0; i < NUM_CASES; i++) {
+    pvrs[i] = make_pvr(&cases[i], i + 1, &sizes[i]);
+  }
+  const uint32_t chunk_size = write_dat(pvrs, sizes);
+
+  const file_t fd = fs_open(CHECK_DAT, O_RDONLY);
+  if (fd == -1) {
+    printf("ERR: cant read %s\n", CHECK_DAT);
+    return 1;
+  }
+  for (int i = 0; i < NUM_CASES; i++) {
+    const uint32_t start = (uint32_t)(i + 1) * chunk_size;
+    int bad = check_buffer(&cases[i], pvrs[i], fd, start, chunk_size);
+    if (!bad && (i == PAGE_TWIDDLED || i == PAGE_RECT)) {
+      bad = check_page(&cases[i], fd, start, chunk_size, pvrs[i]);
+    }
+    printf("%-24s %s\n", cases[i].name, bad ? "FAIL" : "ok");
+    failed += bad;
+  }
+  fs_close(fd);
+  remove(CHECK_DAT);
+
+  if (bad_uploads) {
+    printf("%d uploads not suited to the store queues\n", bad_uploads);
+    failed++;
+  }
+  for (int i = 0; i < NUM_CASES; i++) {
+    free(pvrs[i]);
+  }
+  printf("%d of %d failed, block size %d\n", failed, NUM_CASES, PVR_STREAM_BLOCK_SIZE);
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}